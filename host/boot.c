@@ -0,0 +1,29 @@
+#include <rp6502.h>
+#include "boot.h"
+#include "constants.h"
+#include "effects.h"
+#include "instruments.h"
+#include "opl.h"
+#include "player.h"
+
+unsigned text_message_addr; // Normally owned by main.c
+
+void boot_tracker(void) {
+    ria_mock_reset();
+    text_message_addr = TEXT_CONFIG + sizeof(vga_mode1_config_t);
+
+    OPL_Config(1, OPL_ADDR);
+    OPL_Init();
+
+    for (int i = 0; i < 9; i++) {
+        last_effect[i] = 0xFFFF;
+        ch_arp[i].active = false;
+        ch_porta[i].active = false;
+    }
+    update_lfo_scaler();
+
+    player_init();
+    for (uint8_t i = 0; i < 9; i++) {
+        OPL_SetPatch(i, gm_patch(0));
+    }
+}
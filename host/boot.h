@@ -0,0 +1,10 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+// Shared by the host tools and tests
+
+// Same power-on sequence as main(), minus the parts that only touch video.
+// Every call starts again from a cleared mock RIA.
+extern void boot_tracker(void);
+
+#endif // BOOT_H
@@ -0,0 +1,68 @@
+// device_export - Ctrl+E export from a tracker source tree, for golden files
+//
+// Built against the src/ of a chosen revision (see make_golden.sh) with the
+// same mock RIA as rptc. It boots the way that revision's main() does, loads
+// the song and presses Ctrl+E through the keyboard XRAM, so the BIN comes
+// from the on-device export path rather than from rptc's export_song().
+//
+// Usage: device_export <song_dir> <out_dir> <song.rpt>
+
+#include <rp6502.h>
+#include <stdio.h>
+#include <string.h>
+#include "constants.h"
+#include "effects.h"
+#include "input.h"
+#include "instruments.h"
+#include "opl.h"
+#include "player.h"
+#include "song.h"
+#include "usb_hid_keys.h"
+
+unsigned text_message_addr; // Normally owned by main.c
+
+static void set_key(uint8_t code, bool down) {
+    uint16_t addr = KEYBOARD_INPUT + (code >> 3);
+    uint8_t bit = (uint8_t)(1 << (code & 7));
+    ria_mock_xram[addr] = down ? (ria_mock_xram[addr] | bit) : (ria_mock_xram[addr] & ~bit);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        fprintf(stderr, "usage: device_export <song_dir> <out_dir> <song.rpt>\n");
+        return 2;
+    }
+    ria_mock_reset();
+    ria_mock_set_dirs(argv[1], argv[2]);
+    text_message_addr = TEXT_CONFIG + sizeof(vga_mode1_config_t);
+
+    // main(), minus video
+    OPL_Config(1, OPL_ADDR);
+    OPL_Init();
+    for (int i = 0; i < 9; i++) {
+        last_effect[i] = 0xFFFF;
+        ch_arp[i].active = false;
+        ch_porta[i].active = false;
+    }
+    update_lfo_scaler();
+    init_input_system();
+    player_init();
+    for (uint8_t i = 0; i < 9; i++) {
+        OPL_SetPatch(i, &gm_bank[0]);
+    }
+    load_song(argv[3]);
+    if (strcmp(active_filename, argv[3]) != 0) {
+        fprintf(stderr, "device_export: %s: load failed\n", argv[3]);
+        return 1;
+    }
+
+    // One frame with Ctrl held, then one with Ctrl+E: the export runs to
+    // the end inside player_tick()
+    set_key(KEY_LEFTCTRL, true);
+    handle_input();
+    player_tick();
+    set_key(KEY_E, true);
+    handle_input();
+    player_tick();
+    return 0;
+}
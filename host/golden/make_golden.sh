@@ -0,0 +1,31 @@
+#!/bin/sh
+# Regenerates the golden .BIN files in this directory from the Ctrl+E export
+# of a given revision (default: the tree's first commit, before rptc existed).
+# CI compiles music/ with rptc and compares against these byte for byte.
+#
+#   host/golden/make_golden.sh [revision]
+set -e
+
+repo=$(git rev-parse --show-toplevel)
+rev=${1:-$(git -C "$repo" rev-list --max-parents=0 HEAD)}
+golden="$repo/host/golden"
+work=$(mktemp -d)
+trap 'git -C "$repo" worktree remove --force "$work/src-tree" >/dev/null 2>&1; rm -rf "$work"' EXIT
+
+git -C "$repo" worktree add --detach "$work/src-tree" "$rev" >/dev/null
+src="$work/src-tree/src"
+
+# Every tracker source except main.c, which the harness replaces
+set --
+for f in "$src"/*.c; do
+    [ "$(basename "$f")" = main.c ] || set -- "$@" "$f"
+done
+cc -std=gnu99 -D_DEFAULT_SOURCE -DUSE_NATIVE_OPL2 -w \
+    -I"$repo/host/include" -I"$src" -o "$work/device_export" \
+    "$golden/device_export.c" "$repo/host/ria_mock.c" "$@"
+
+for song in "$repo"/music/*.RPT; do
+    name=$(basename "$song")
+    "$work/device_export" "$repo/music" "$golden" "$name" >/dev/null
+    echo "$name -> host/golden/${name%.RPT}.BIN"
+done
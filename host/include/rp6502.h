@@ -0,0 +1,94 @@
+#ifndef RP6502_MOCK_H
+#define RP6502_MOCK_H
+
+// ============================================================================
+// HOST MOCK OF THE RP6502 SDK HEADER
+// ============================================================================
+// Lets the tracker sources build natively on Linux. The RIA registers are
+// backed by a 64 KB XRAM array: every access to RIA.rw0 / RIA.rw1 reads or
+// writes XRAM at addr0 / addr1 and then advances that pointer by step0 /
+// step1, exactly like the hardware auto-increment ports.
+//
+// Only the subset of the SDK used by src/ is provided.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+struct __RP6502 {
+    uint8_t  vsync;
+    int8_t   step0;
+    uint16_t addr0;
+    int8_t   step1;
+    uint16_t addr1;
+    uint8_t *xram;
+};
+
+extern struct __RP6502 ria_mock;
+extern uint8_t ria_mock_xram[0x10000];
+
+// Returns the current port address, then advances it by the port step
+extern uint16_t ria_mock_next0(void);
+extern uint16_t ria_mock_next1(void);
+
+#define RIA ria_mock
+#define rw0 xram[ria_mock_next0()]
+#define rw1 xram[ria_mock_next1()]
+
+// VGA text mode config (same layout as the SDK)
+typedef struct {
+    bool x_wrap;
+    bool y_wrap;
+    int16_t x_pos_px;
+    int16_t y_pos_px;
+    int16_t width_chars;
+    int16_t height_chars;
+    uint16_t xram_data_ptr;
+    uint16_t xram_palette_ptr;
+    uint16_t xram_font_ptr;
+} vga_mode1_config_t;
+
+#define xram0_struct_set(addr, type, member, val)                      \
+    ria_mock_struct_set((uint16_t)((addr) + offsetof(type, member)),   \
+                        sizeof(((type *)0)->member), (uint32_t)(val))
+
+extern void ria_mock_struct_set(uint16_t addr, unsigned size, uint32_t val);
+
+extern int xregn(char device, char channel, unsigned char address, unsigned count, ...);
+extern int xreg(char device, char channel, unsigned char address, ...);
+extern int phi2(void);
+
+extern int read_xstack(void *buf, unsigned count, int fildes);
+extern int write_xstack(const void *buf, unsigned count, int fildes);
+extern int read_xram(unsigned buf, unsigned count, int fildes);
+extern int write_xram(unsigned buf, unsigned count, int fildes);
+
+// Directory listing (same layout as the SDK)
+typedef struct {
+    unsigned long fsize;
+    unsigned fdate;
+    unsigned ftime;
+    unsigned crdate;
+    unsigned crtime;
+    unsigned char fattrib;
+    char altname[12 + 1];
+    char fname[255 + 1];
+} f_stat_t;
+
+extern int f_opendir(const char *name);
+extern int f_readdir(f_stat_t *dirent, int dirdes);
+extern int f_closedir(int dirdes);
+
+// File access: relative reads resolve against the input directory, relative
+// writes against the output directory (see ria_mock_set_dirs()).
+extern int ria_mock_open(const char *path, int flags, ...);
+extern void ria_mock_set_dirs(const char *in_dir, const char *out_dir);
+extern void ria_mock_reset(void);
+
+#ifndef RIA_MOCK_IMPL
+#define open(...) ria_mock_open(__VA_ARGS__)
+#endif
+
+#endif // RP6502_MOCK_H
@@ -0,0 +1,90 @@
+// midi_test - checks the tracker's live MIDI note handling on Linux
+//
+// Plays notes straight into player.c's MIDI callbacks against the mock RIA
+// and checks where poly-mode chord recording leaves the cursor, and that
+// every note-off keys its channel off. Run by ctest.
+
+#include <rp6502.h>
+#include <stdio.h>
+#include "boot.h"
+#include "midi.h"
+#include "opl.h"
+#include "player.h"
+#include "screen.h"
+
+static int failures = 0;
+
+static void chord_on(const uint8_t *notes, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) midi_process_note_on(0, notes[i], 100);
+}
+
+static void chord_off(const uint8_t *notes, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) midi_process_note_off(0, notes[i]);
+}
+
+static bool keyed(uint8_t ch) {
+    return (opl_hardware_shadow[0xB0 + ch] & 0x20) != 0;
+}
+
+static void expect_row(const char *what, uint8_t row) {
+    if (cur_row != row) {
+        fprintf(stderr, "FAIL: %s: cursor on row %u, expected %u\n", what, cur_row, row);
+        failures++;
+    }
+}
+
+int main(void) {
+    static const uint8_t c_major[] = { 60, 64, 67 };
+    static const uint8_t f_major[] = { 65, 69, 72 };
+
+    // Console output is the tracker's own status messages
+    if (!freopen("/dev/null", "w", stdout)) return 1;
+
+    boot_tracker();
+    midi_polyphonic = true;
+    edit_mode = true;
+    cur_row = 0;
+
+    // A chord moves the cursor on once every key is up
+    chord_on(c_major, 3);
+    expect_row("chord held", 0);
+    chord_off(c_major, 3);
+    expect_row("chord released", 1);
+
+    // Panic with the chord still held, then let the keys go
+    chord_on(c_major, 3);
+    OPL_Panic();
+    chord_off(c_major, 3);
+    expect_row("released after panic", 1);
+
+    // The next chord must still advance the cursor
+    chord_on(f_major, 3);
+    chord_off(f_major, 3);
+    expect_row("chord after panic", 2);
+
+    // Same again when the panic comes between the key releases
+    chord_on(c_major, 3);
+    midi_process_note_off(0, c_major[0]);
+    OPL_Panic();
+    midi_process_note_off(0, c_major[1]);
+    midi_process_note_off(0, c_major[2]);
+    chord_on(f_major, 3);
+    chord_off(f_major, 3);
+    expect_row("chord after partial release and panic", 3);
+
+    // Channel-mapped mode: the same note held on two MIDI channels, each
+    // playing its own OPL channel. Both note-offs must land.
+    midi_polyphonic = false;
+    edit_mode = false;
+    midi_process_note_on(0, 60, 100);
+    midi_process_note_on(1, 60, 100);
+    midi_process_note_off(0, 60);
+    midi_process_note_off(1, 60);
+    if (keyed(0) || keyed(1)) {
+        fprintf(stderr, "FAIL: mapped mode: channel %u still keyed\n", keyed(0) ? 0 : 1);
+        failures++;
+    }
+
+    if (failures == 0) fprintf(stderr, "midi_test: ok\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,173 @@
+// midiout_test - checks the bytes the tracker sends to MIDI out
+//
+// A temp file stands in for MIDI0:. A few frames are driven through the
+// midiout calls by hand and compared byte for byte; then the sequencer plays
+// a pattern with pitch and volume effects, and every frame it sends is
+// checked for running status and for one bend and one expression per
+// channel at most. Run by ctest.
+
+#include <rp6502.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "boot.h"
+#include "midi.h"
+#include "midiout.h"
+#include "patterns.h"
+#include "player.h"
+#include "screen.h"
+
+static int failures = 0;
+static char tmp_dir[32];
+static FILE *sent;          // The MIDI0: file, read back as it grows
+
+static void fail(const char *what) {
+    fprintf(stderr, "FAIL: %s\n", what);
+    failures++;
+}
+
+// Everything written since the last call
+static size_t read_sent(uint8_t *buf, size_t size) {
+    size_t n = fread(buf, 1, size, sent);
+    clearerr(sent);
+    return n;
+}
+
+static void expect_bytes(const char *what, const uint8_t *want, size_t len) {
+    uint8_t got[256];
+    size_t n = read_sent(got, sizeof(got));
+    if (n != len || memcmp(got, want, len) != 0) {
+        fprintf(stderr, "FAIL: %s: got", what);
+        for (size_t i = 0; i < n; i++) fprintf(stderr, " %02X", got[i]);
+        fprintf(stderr, "\n");
+        failures++;
+    }
+}
+
+// One frame's write: no status byte repeated where running status applies,
+// and no channel with two bends or two expression changes between its note
+// events (a note closes the merge so bends stay in order around it)
+static void check_frame(const uint8_t *buf, size_t len) {
+    uint8_t running = 0, status = 0;
+    uint8_t bends[16] = {0}, exprs[16] = {0};
+    size_t i = 0;
+
+    while (i < len) {
+        uint8_t b = buf[i++];
+        if (b >= 0xF8) continue;                    // Real-time
+        if (b >= 0x80) {
+            if (b == running) fail("status byte sent again under running status");
+            status = b;
+            running = (b < 0xF0) ? b : 0;
+        } else if (!running) {
+            fail("data byte without a status");
+            return;
+        } else {
+            i--;                                    // Running status
+        }
+        uint8_t data = ((status & 0xE0) == 0xC0) ? 1 : 2;
+        if (status == 0xF0) {
+            while (i < len && buf[i] != 0xF7) i++;
+            i++;
+            continue;
+        }
+        if ((status & 0xE0) == 0x80) bends[status & 0x0F] = exprs[status & 0x0F] = 0;
+        if ((status & 0xF0) == 0xE0 && ++bends[status & 0x0F] > 1) fail("two bends in one frame");
+        if ((status & 0xF0) == 0xB0 && i < len && buf[i] == 11 &&
+            ++exprs[status & 0x0F] > 1) fail("two expression changes in one frame");
+        i += data;
+    }
+}
+
+int main(void) {
+    char path[64];
+
+    if (!freopen("/dev/null", "w", stdout)) return 1;
+
+    snprintf(tmp_dir, sizeof(tmp_dir), "/tmp/midiout_test-%d", (int)getpid());
+    if (mkdir(tmp_dir, 0755) != 0) return 1;
+    snprintf(path, sizeof(path), "%s/%s", tmp_dir, MIDI_DEVICE);
+    FILE *f = fopen(path, "wb");
+    if (!f) return 1;
+    fclose(f);
+    sent = fopen(path, "rb");
+    ria_mock_set_dirs(tmp_dir, tmp_dir);
+    snprintf(pattern_swap_filename, sizeof(pattern_swap_filename), "%s/swap.tmp", tmp_dir);
+    boot_tracker();
+
+    // Ctrl+M: bend range (RPN 0) on every channel, status once per channel
+    midi_out_toggle();
+    {
+        uint8_t want[9 * 9];
+        for (uint8_t ch = 0; ch < 9; ch++) {
+            const uint8_t rpn[9] = { 0xB0 | ch, 101, 0, 100, 0, 6, MIDI_OUT_BEND_RANGE, 38, 0 };
+            memcpy(want + ch * 9, rpn, sizeof(rpn));
+        }
+        expect_bytes("bend range", want, sizeof(want));
+    }
+
+    // Pitch moves after a note-on merge into one bend. Frames flushed while
+    // stopped release every note, so these run as if playing.
+    midi_out_step = true;
+    seq.is_playing = true;
+    midi_out_note_on(0, 60, 0);
+    midi_out_pitch(0, 60, 8);
+    midi_out_pitch(0, 60, 16);
+    midi_out_flush();
+    {
+        const uint8_t want[] = { 0xE0, 0x00, 0x40, 0xB0, 11, 127, 0x90, 60, 127, 0xE0, 0x55, 0x42 };
+        expect_bytes("note and merged bend", want, sizeof(want));
+    }
+
+    // Running status survives a clock, and song position ends it
+    midi_out_volume(0, 64);
+    midi_out_realtime(0xF8);
+    midi_out_program(0, 1, 5);
+    midi_out_song_position(0x100);
+    midi_out_program(0, 1, 6);
+    midi_out_flush();
+    {
+        const uint8_t want[] = { 0xB0, 11, 64, 0xF8, 0, 1, 0xC0, 5, 0xF2, 0x00, 0x02, 0xC0, 6 };
+        expect_bytes("running status", want, sizeof(want));
+    }
+    midi_out_step = false;
+    seq.is_playing = false;
+    midi_out_flush();
+    {
+        const uint8_t want[] = { 0x80, 60, 0 };
+        expect_bytes("released on stop", want, sizeof(want));
+    }
+
+    // The sequencer: vibrato on one channel, a volume slide on another
+    PatternCell c = { .note = 60, .inst = 0, .vol = 40, .effect = 0x4880 };
+    write_cell(0, 0, 0, &c);
+    c = (PatternCell){ .note = 64, .inst = 0, .vol = 63, .effect = 0x3130 };
+    write_cell(0, 0, 1, &c);
+    c = (PatternCell){ .note = 67, .inst = 0, .vol = 50, .effect = 0x2105 };
+    write_cell(0, 4, 2, &c);
+    transport_play();
+
+    uint8_t buf[MIDI_OUT_QUEUE * 3];
+    size_t total = 0;
+    for (int frame = 0; frame < 120; frame++) {
+        sequencer_step();
+        midi_out_flush();
+        size_t n = read_sent(buf, sizeof(buf));
+        check_frame(buf, n);
+        total += n;
+    }
+    if (total == 0) fail("sequencer sent nothing");
+
+    transport_stop();
+    midi_out_toggle();
+    fclose(sent);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/swap.tmp", tmp_dir);
+    unlink(path);
+    rmdir(tmp_dir);
+
+    if (failures == 0) fprintf(stderr, "midiout_test: ok\n");
+    return failures ? 1 : 0;
+}
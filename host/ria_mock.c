@@ -0,0 +1,157 @@
+#define RIA_MOCK_IMPL
+#include <rp6502.h>
+#include <dirent.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+uint8_t ria_mock_xram[0x10000];
+struct __RP6502 ria_mock = {0, 1, 0, 1, 0, ria_mock_xram};
+
+static char mock_in_dir[512] = ".";
+static char mock_out_dir[512] = ".";
+
+// Where "ROM:" assets are found; the host build generates them here
+#ifndef RIA_MOCK_ROM_DIR
+#define RIA_MOCK_ROM_DIR "rom"
+#endif
+
+uint16_t ria_mock_next0(void) {
+    uint16_t a = ria_mock.addr0;
+    ria_mock.addr0 = (uint16_t)(a + ria_mock.step0);
+    return a;
+}
+
+uint16_t ria_mock_next1(void) {
+    uint16_t a = ria_mock.addr1;
+    ria_mock.addr1 = (uint16_t)(a + ria_mock.step1);
+    return a;
+}
+
+void ria_mock_struct_set(uint16_t addr, unsigned size, uint32_t val) {
+    for (unsigned i = 0; i < size; i++) {
+        ria_mock_xram[(uint16_t)(addr + i)] = (uint8_t)(val >> (i * 8));
+    }
+}
+
+void ria_mock_reset(void) {
+    memset(ria_mock_xram, 0, sizeof(ria_mock_xram));
+    ria_mock.vsync = 0;
+    ria_mock.addr0 = 0;
+    ria_mock.step0 = 1;
+    ria_mock.addr1 = 0;
+    ria_mock.step1 = 1;
+}
+
+int xregn(char device, char channel, unsigned char address, unsigned count, ...) {
+    (void)device; (void)channel; (void)address; (void)count;
+    return 0;
+}
+
+int xreg(char device, char channel, unsigned char address, ...) {
+    (void)device; (void)channel; (void)address;
+    return 0;
+}
+
+int phi2(void) {
+    return 8000;
+}
+
+int read_xstack(void *buf, unsigned count, int fildes) {
+    return (int)read(fildes, buf, count);
+}
+
+int write_xstack(const void *buf, unsigned count, int fildes) {
+    return (int)write(fildes, buf, count);
+}
+
+// XRAM transfers never wrap past $FFFF, same as the RIA
+int read_xram(unsigned buf, unsigned count, int fildes) {
+    if (buf > 0xFFFF) return -1;
+    if (count > 0x10000 - buf) count = 0x10000 - buf;
+    return (int)read(fildes, &ria_mock_xram[buf], count);
+}
+
+int write_xram(unsigned buf, unsigned count, int fildes) {
+    if (buf > 0xFFFF) return -1;
+    if (count > 0x10000 - buf) count = 0x10000 - buf;
+    return (int)write(fildes, &ria_mock_xram[buf], count);
+}
+
+void ria_mock_set_dirs(const char *in_dir, const char *out_dir) {
+    snprintf(mock_in_dir, sizeof(mock_in_dir), "%s", in_dir);
+    snprintf(mock_out_dir, sizeof(mock_out_dir), "%s", out_dir);
+}
+
+int ria_mock_open(const char *path, int flags, ...) {
+    char full[1024];
+
+    // Drive prefix "0:" is the USB stick on the device
+    if (strncmp(path, "0:", 2) == 0) path += 2;
+
+    if (strncmp(path, "ROM:", 4) == 0) {
+        snprintf(full, sizeof(full), "%s/%s", RIA_MOCK_ROM_DIR, path + 4);
+    } else if (path[0] == '/') {
+        snprintf(full, sizeof(full), "%s", path);
+    } else {
+        const char *dir = (flags & (O_WRONLY | O_RDWR)) ? mock_out_dir : mock_in_dir;
+        snprintf(full, sizeof(full), "%s/%s", dir, path);
+    }
+    return open(full, flags, 0644);
+}
+
+// Directories are listed from the input directory, like relative reads
+#define MOCK_MAX_DIRS 4
+
+static DIR *mock_dirs[MOCK_MAX_DIRS];
+static char mock_dir_paths[MOCK_MAX_DIRS][1024];
+
+int f_opendir(const char *name) {
+    if (strncmp(name, "0:", 2) == 0) name += 2;
+
+    for (int d = 0; d < MOCK_MAX_DIRS; d++) {
+        if (mock_dirs[d]) continue;
+        if (name[0] == '/') {
+            snprintf(mock_dir_paths[d], sizeof(mock_dir_paths[d]), "%s", name);
+        } else {
+            snprintf(mock_dir_paths[d], sizeof(mock_dir_paths[d]), "%s/%s", mock_in_dir, name);
+        }
+        mock_dirs[d] = opendir(mock_dir_paths[d]);
+        return mock_dirs[d] ? d : -1;
+    }
+    return -1;
+}
+
+// An empty fname marks the end of the directory, as with FatFs
+int f_readdir(f_stat_t *dirent, int dirdes) {
+    memset(dirent, 0, sizeof(*dirent));
+    if (dirdes < 0 || dirdes >= MOCK_MAX_DIRS || !mock_dirs[dirdes]) return -1;
+
+    struct dirent *e;
+    while ((e = readdir(mock_dirs[dirdes])) != NULL) {
+        if (e->d_name[0] != '.') break;
+    }
+    if (!e) return 0;
+
+    char full[1300];
+    struct stat st;
+    snprintf(full, sizeof(full), "%s/%s", mock_dir_paths[dirdes], e->d_name);
+    if (stat(full, &st) == 0) {
+        struct tm *t = localtime(&st.st_mtime);
+        dirent->fsize = (unsigned long)st.st_size;
+        dirent->fdate = (unsigned)(((t->tm_year - 80) << 9) | ((t->tm_mon + 1) << 5) | t->tm_mday);
+        dirent->ftime = (unsigned)((t->tm_hour << 11) | (t->tm_min << 5) | (t->tm_sec / 2));
+        if (S_ISDIR(st.st_mode)) dirent->fattrib = 0x10;
+    }
+    snprintf(dirent->fname, sizeof(dirent->fname), "%s", e->d_name);
+    return 0;
+}
+
+int f_closedir(int dirdes) {
+    if (dirdes < 0 || dirdes >= MOCK_MAX_DIRS || !mock_dirs[dirdes]) return -1;
+    closedir(mock_dirs[dirdes]);
+    mock_dirs[dirdes] = NULL;
+    return 0;
+}
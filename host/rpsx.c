@@ -0,0 +1,141 @@
+// rpsx - RPTracker SysEx loopback for Linux
+//
+// Plays a stream of MIDI bytes (normally SysEx from tools/sysex.py) into the
+// tracker's own MIDI input code, and saves everything the tracker sends back.
+// midi.c, sysex.c and midiout.c are linked unmodified against the mock RIA,
+// with MIDI0: mapped to the two files, so a PC editor's dumps, requests and
+// the replies to them can be checked without the device.
+//
+// Usage: rpsx [-v] <in.syx> <out.syx> [song.rpt]
+
+#include <rp6502.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "boot.h"
+#include "constants.h"
+#include "effects.h"
+#include "instruments.h"
+#include "midi.h"
+#include "midiout.h"
+#include "opl.h"
+#include "patterns.h"
+#include "player.h"
+#include "screen.h"
+#include "song.h"
+
+// Sized so every path built from tmp_dir fits, swap file name included
+static char tmp_dir[32];
+static char in_dir[sizeof(tmp_dir) + 8];
+static char out_dir[sizeof(tmp_dir) + 8];
+
+// Links dir/name to target, which must already exist
+static int link_as(const char *dir, const char *name, const char *target) {
+    char from[PATH_MAX], to[PATH_MAX + 128];
+    if (!realpath(target, from)) {
+        fprintf(stderr, "rpsx: %s: %s\n", target, strerror(errno));
+        return -1;
+    }
+    snprintf(to, sizeof(to), "%s/%s", dir, name);
+    if (symlink(from, to) != 0) {
+        fprintf(stderr, "rpsx: %s: %s\n", to, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static void cleanup(void) {
+    char path[PATH_MAX];
+    const char *names[] = { "in/MIDI0:", "in/SONG.RPT", "out/MIDI0:", "in", "out", "swap.tmp", "" };
+    for (int i = 0; names[i][0]; i++) {
+        snprintf(path, sizeof(path), "%s/%s", tmp_dir, names[i]);
+        if (unlink(path) != 0) rmdir(path);
+    }
+    rmdir(tmp_dir);
+}
+
+static void usage(void) {
+    fprintf(stderr,
+        "usage: rpsx [-v] <in.syx> <out.syx> [song.rpt]\n"
+        "  in.syx    MIDI bytes for the tracker to receive\n"
+        "  out.syx   what the tracker sends back (replaced)\n"
+        "  song.rpt  song loaded first, so requests can read it back\n"
+        "  -v        show the tracker's console output\n");
+}
+
+int main(int argc, char *argv[]) {
+    bool verbose = false;
+    int i = 1;
+    struct stat st;
+
+    if (i < argc && strcmp(argv[i], "-v") == 0) {
+        verbose = true;
+        i++;
+    }
+    if (argc - i < 2 || argc - i > 3) {
+        usage();
+        return 2;
+    }
+    const char *in_file = argv[i];
+    const char *out_file = argv[i + 1];
+    const char *song_file = (argc - i == 3) ? argv[i + 2] : NULL;
+
+    if (stat(in_file, &st) != 0) {
+        fprintf(stderr, "rpsx: %s: %s\n", in_file, strerror(errno));
+        return 1;
+    }
+    FILE *f = fopen(out_file, "wb");
+    if (!f) {
+        fprintf(stderr, "rpsx: %s: %s\n", out_file, strerror(errno));
+        return 1;
+    }
+    fclose(f);
+
+    // MIDI0: is opened read-only from the input dir and write-only from the
+    // output dir, so each side gets its own link
+    snprintf(tmp_dir, sizeof(tmp_dir), "/tmp/rpsx-%d", (int)getpid());
+    snprintf(in_dir, sizeof(in_dir), "%s/in", tmp_dir);
+    snprintf(out_dir, sizeof(out_dir), "%s/out", tmp_dir);
+    if (mkdir(tmp_dir, 0755) != 0 || mkdir(in_dir, 0755) != 0 || mkdir(out_dir, 0755) != 0) {
+        fprintf(stderr, "rpsx: %s: %s\n", tmp_dir, strerror(errno));
+        return 1;
+    }
+    atexit(cleanup);
+    if (link_as(in_dir, MIDI_DEVICE, in_file) != 0 ||
+        link_as(out_dir, MIDI_DEVICE, out_file) != 0 ||
+        (song_file && link_as(in_dir, "SONG.RPT", song_file) != 0)) {
+        return 1;
+    }
+
+    if (!verbose) {
+        if (!freopen("/dev/null", "w", stdout)) return 1;
+    }
+    ria_mock_set_dirs(in_dir, out_dir);
+    snprintf(pattern_swap_filename, sizeof(pattern_swap_filename), "%s/swap.tmp", tmp_dir);
+
+    boot_tracker();
+    if (song_file) {
+        load_song("SONG.RPT");
+        if (strcmp(active_filename, "SONG.RPT") != 0) {
+            fprintf(stderr, "rpsx: %s: load failed\n", song_file);
+            return 1;
+        }
+    }
+
+    // Held open throughout: every reopen of a plain file would start writing
+    // at its beginning again
+    if (!midi_out_open(MIDI_DEVICE)) return 1;
+
+    // One call per frame, as the main loop makes. Every frame reads at least
+    // once, so this many frames always reach the end of the file.
+    long frames = st.st_size / 32 + 2;
+    for (long n = 0; n < frames; n++) midi_task();
+    midi_out_close();
+
+    fflush(stdout);
+    return 0;
+}
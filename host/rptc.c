@@ -0,0 +1,202 @@
+// rptc - RPTracker song compiler for Linux
+//
+// Converts .RPT songs to the .BIN OPL register streams produced by Ctrl+E on
+// the device. The tracker's own sequencer, effects and OPL capture code are
+// linked unmodified against a mock RIA/XRAM layer (include/rp6502.h), so the
+// output matches an on-device export byte for byte.
+//
+// Each song is compiled in a freshly forked process, which gives it the same
+// clean power-on state the device has, and lets songs run in parallel.
+//
+// Usage: rptc [-j jobs] [-o outdir] [-s] [-v] <song.rpt | directory>...
+
+#include <rp6502.h>
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "boot.h"
+#include "constants.h"
+#include "effects.h"
+#include "instruments.h"
+#include "opl.h"
+#include "patterns.h"
+#include "player.h"
+#include "screen.h"
+#include "song.h"
+
+#define MAX_SONGS 1024
+
+typedef struct {
+    char dir[512];
+    char name[16];  // 8.3 name, as the device would see it
+} SongJob;
+
+static SongJob jobs[MAX_SONGS];
+static int job_count = 0;
+static const char *out_dir = NULL;
+static bool verbose = false;
+static bool stems = false;
+
+static bool has_rpt_extension(const char *name) {
+    size_t len = strlen(name);
+    return len > 4 && strcasecmp(name + len - 4, ".RPT") == 0;
+}
+
+static void add_job(const char *dir, const char *name) {
+    if (job_count >= MAX_SONGS) {
+        fprintf(stderr, "rptc: too many songs, skipping %s/%s\n", dir, name);
+        return;
+    }
+    // The firmware derives the .BIN name in a 16-byte buffer
+    if (strlen(name) > 12 || strchr(name, '.') != strrchr(name, '.')) {
+        fprintf(stderr, "rptc: %s/%s is not an 8.3 filename, skipped\n", dir, name);
+        return;
+    }
+    snprintf(jobs[job_count].dir, sizeof(jobs[job_count].dir), "%s", dir);
+    snprintf(jobs[job_count].name, sizeof(jobs[job_count].name), "%s", name);
+    job_count++;
+}
+
+static void add_path(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "rptc: %s: %s\n", path, strerror(errno));
+        return;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *d = opendir(path);
+        if (!d) {
+            fprintf(stderr, "rptc: %s: %s\n", path, strerror(errno));
+            return;
+        }
+        struct dirent *e;
+        while ((e = readdir(d)) != NULL) {
+            if (has_rpt_extension(e->d_name)) add_job(path, e->d_name);
+        }
+        closedir(d);
+        return;
+    }
+
+    // Split "dir/NAME.RPT"
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", path);
+    char *slash = strrchr(dir, '/');
+    if (slash) {
+        *slash = '\0';
+        add_job(dir[0] ? dir : "/", slash + 1);
+    } else {
+        add_job(".", path);
+    }
+}
+
+static int compile_song(const SongJob *job) {
+    ria_mock_set_dirs(job->dir, out_dir ? out_dir : job->dir);
+
+    if (!verbose) {
+        if (!freopen("/dev/null", "w", stdout)) return 1;
+    }
+
+    // Every child needs its own pattern swap file
+    snprintf(pattern_swap_filename, sizeof(pattern_swap_filename),
+             "/tmp/rptc-%d.swp", (int)getpid());
+
+    boot_tracker();
+    load_song(job->name);
+    int rc = 0;
+    if (strcmp(active_filename, job->name) != 0) {
+        rc = 1; // Load failed
+    } else {
+        export_song(stems);
+    }
+    fflush(stdout);
+    unlink(pattern_swap_filename);
+    return rc;
+}
+
+static int cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+}
+
+static void usage(void) {
+    fprintf(stderr,
+        "usage: rptc [-j jobs] [-o outdir] [-s] [-v] <song.rpt | directory>...\n"
+        "  -j jobs    songs compiled in parallel (default: all cores)\n"
+        "  -o outdir  write .BIN files here (default: next to each song)\n"
+        "  -s         per-channel stems: NAME_0.BIN .. NAME_8.BIN\n"
+        "  -v         show the tracker's console output\n");
+}
+
+int main(int argc, char *argv[]) {
+    int max_jobs = cpu_count();
+    int i = 1;
+
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strncmp(argv[i], "-j", 2) == 0 && (argv[i][2] || i + 1 < argc)) {
+            max_jobs = atoi(argv[i][2] ? argv[i] + 2 : argv[++i]);
+            if (max_jobs < 1) max_jobs = 1;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_dir = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0) {
+            stems = true;
+        } else if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (i >= argc) {
+        usage();
+        return 2;
+    }
+    for (; i < argc; i++) add_path(argv[i]);
+
+    if (out_dir && mkdir(out_dir, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "rptc: %s: %s\n", out_dir, strerror(errno));
+        return 1;
+    }
+
+    // Fork one child per song, keeping at most max_jobs running
+    pid_t pids[MAX_SONGS];
+    int running = 0, failed = 0, next = 0;
+
+    while (next < job_count || running > 0) {
+        if (next < job_count && running < max_jobs) {
+            fflush(stdout);
+            pid_t pid = fork();
+            if (pid < 0) {
+                perror("rptc: fork");
+                return 1;
+            }
+            if (pid == 0) _exit(compile_song(&jobs[next]));
+            pids[next++] = pid;
+            running++;
+            continue;
+        }
+
+        int status;
+        pid_t done = wait(&status);
+        if (done < 0) break;
+        running--;
+        for (int j = 0; j < next; j++) {
+            if (pids[j] != done) continue;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                fprintf(stderr, "rptc: %s/%s: failed\n", jobs[j].dir, jobs[j].name);
+                failed++;
+            } else if (verbose) {
+                fprintf(stderr, "rptc: %s/%s: ok\n", jobs[j].dir, jobs[j].name);
+            }
+            break;
+        }
+    }
+
+    printf("rptc: %d song(s) compiled, %d failed\n", job_count - failed, failed);
+    return failed ? 1 : 0;
+}
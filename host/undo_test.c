@@ -0,0 +1,136 @@
+// undo_test - checks that undo never restores part of an edit
+//
+// Fills patterns through the mock XRAM, runs edits larger than the undo ring
+// (pastes and duplicate merges) and enough small ones to wrap it, then undoes
+// everything and checks that each pattern and the order list end up exactly
+// as they were at some point, never a mix. Run by ctest.
+
+#include <rp6502.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "boot.h"
+#include "patterns.h"
+#include "player.h"
+#include "song.h"
+#include "undo.h"
+
+static int failures = 0;
+
+static void fill_pattern(uint8_t pat, unsigned seed) {
+    srand(seed);
+    RIA.addr0 = pattern_slot_addr(pat);
+    RIA.step0 = 1;
+    for (uint16_t i = 0; i < PATTERN_SIZE; i++) RIA.rw0 = (uint8_t)(rand() | 1);
+    mark_pattern_dirty(pat);
+}
+
+static void read_pattern(uint8_t pat, uint8_t *buf) {
+    RIA.addr0 = pattern_slot_addr(pat);
+    RIA.step0 = 1;
+    for (uint16_t i = 0; i < PATTERN_SIZE; i++) buf[i] = RIA.rw0;
+}
+
+// Sets a pattern without recording it for undo
+static void write_pattern(uint8_t pat, const uint8_t *buf) {
+    RIA.addr0 = pattern_slot_addr(pat);
+    RIA.step0 = 1;
+    for (uint16_t i = 0; i < PATTERN_SIZE; i++) RIA.rw0 = buf[i];
+    mark_pattern_dirty(pat);
+}
+
+static void expect(const char *what, bool ok) {
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static void undo_all(void) {
+    for (int i = 0; i < 1000; i++) undo();
+}
+
+int main(void) {
+    static uint8_t before[PATTERN_SIZE], after[PATTERN_SIZE], now[PATTERN_SIZE];
+
+    if (!freopen("/dev/null", "w", stdout)) return 1;
+    boot_tracker();
+
+    // A dense paste over a dense pattern needs more than the whole ring:
+    // it stays pasted, whole, and the history before it is dropped
+    fill_pattern(0, 1);
+    fill_pattern(1, 2);
+    read_pattern(1, after);
+    after[5] ^= 0xFF;       // A one-byte edit for the big paste to drop
+    write_pattern(2, after);
+    pattern_copy(2);
+    pattern_paste(1);
+    pattern_copy(1);
+    pattern_paste(0);
+    undo_all();
+    read_pattern(0, now);
+    expect("dense paste kept whole", memcmp(now, after, PATTERN_SIZE) == 0);
+    read_pattern(1, now);
+    expect("history before a too-large edit dropped", memcmp(now, after, PATTERN_SIZE) == 0);
+
+    // Small pastes that wrap the ring many times: each undo step restores
+    // a whole paste, down to the oldest one still kept
+    undo_reset();
+    fill_pattern(3, 4);
+    read_pattern(3, before);
+    memcpy(after, before, PATTERN_SIZE);
+    for (uint16_t i = 10; i < PATTERN_SIZE; i += 300) after[i] ^= 0xFF; // 5 records
+    for (int n = 0; n < 200; n++) {
+        write_pattern(4, (n & 1) ? before : after);
+        pattern_copy(4);
+        pattern_paste(3);
+    }
+    for (int i = 0; i < 1000; i++) {
+        undo();
+        read_pattern(3, now);
+        if (memcmp(now, before, PATTERN_SIZE) != 0 && memcmp(now, after, PATTERN_SIZE) != 0) {
+            expect("ring wrap: undo left a partial paste", false);
+            break;
+        }
+    }
+
+    // Merging 11 dense duplicates: too big to undo, so it stays merged
+    // whole, order list included
+    undo_reset();
+    for (uint8_t p = 0; p < 12; p++) {
+        fill_pattern(p, 5);
+        write_order_xram(p, p);
+    }
+    song_length = 12;
+    read_pattern(0, before);
+    memset(after, 0, PATTERN_SIZE);
+    pattern_dedupe(true);
+    undo_all();
+    bool merged = true;
+    for (uint8_t p = 1; p < 12; p++) {
+        read_pattern(p, now);
+        if (read_order_xram(p) != 0 || memcmp(now, after, PATTERN_SIZE) != 0) merged = false;
+    }
+    expect("large merge kept whole", merged);
+
+    // A small merge undoes in one step, order list included
+    undo_reset();
+    memset(after, 0, PATTERN_SIZE);
+    after[0] = 48;
+    after[1] = 1;
+    after[700] = 60;
+    write_pattern(0, after);
+    write_pattern(1, after);
+    write_order_xram(0, 1);
+    write_order_xram(1, 0);
+    song_length = 2;
+    pattern_dedupe(true);
+    expect("small merge merged", read_order_xram(0) == 0);
+    undo();
+    read_pattern(1, now);
+    expect("small merge undone", read_order_xram(0) == 1 && read_order_xram(1) == 0 &&
+                                 memcmp(now, after, PATTERN_SIZE) == 0);
+
+    if (failures == 0) fprintf(stderr, "undo_test: ok\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,237 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <strings.h>
+#include "constants.h"
+#include "browser.h"
+#include "input.h"
+#include "screen.h"
+#include "song.h"
+#include "usb_hid_keys.h"
+
+bool is_browser_active = false;
+
+// ============================================================================
+// SONG INDEX
+// ============================================================================
+// The index lists songs in directory order. Rescanning walks the directory
+// and the old index side by side: an entry whose size and timestamp still
+// match is kept (looking a few records ahead, so an added or deleted song
+// doesn't invalidate everything after it), anything else is read from the song.
+// Records stay in place while they still line up; from the first new or
+// moved song on, records are appended after the old index, so no old record
+// is overwritten before the lookahead is done with it, then copied down.
+
+#define INDEX_HEADER_SIZE 6
+#define INDEX_LOOKAHEAD   8
+#define FA_DIR            0x10  // FatFs AM_DIR
+
+static int idx_fd = -1;
+static uint16_t idx_count = 0;
+static uint16_t br_top = 0;     // First entry on the page
+static uint16_t br_sel = 0;     // Highlighted entry
+static BrowserEntry br_page[BROWSER_PAGE_SIZE];
+static f_stat_t br_dirent;      // ~280 bytes, kept off the stack
+
+static long index_offset(uint16_t i) {
+    return INDEX_HEADER_SIZE + (long)i * sizeof(BrowserEntry);
+}
+
+static bool index_read(uint16_t i, BrowserEntry *e) {
+    lseek(idx_fd, index_offset(i), SEEK_SET);
+    return read(idx_fd, e, sizeof(BrowserEntry)) == sizeof(BrowserEntry);
+}
+
+static void index_write(uint16_t i, const BrowserEntry *e) {
+    lseek(idx_fd, index_offset(i), SEEK_SET);
+    write(idx_fd, e, sizeof(BrowserEntry));
+}
+
+static bool is_song_file(const char *name) {
+    size_t len = strlen(name);
+    return len > 4 && strcasecmp(name + len - 4, ".RPT") == 0;
+}
+
+// Returns the number of songs that had to be read
+static uint16_t index_refresh(void) {
+    char head[INDEX_HEADER_SIZE];
+    uint16_t old_count = 0;
+    uint16_t old_pos = 0;       // Old record after the last one kept
+    uint16_t parsed = 0;
+    uint16_t moved = BROWSER_MAX_SONGS; // First record not in its old slot
+    BrowserEntry e, old;
+
+    idx_fd = open(BROWSER_INDEX_FILE, O_RDWR);
+    if (idx_fd >= 0 && read(idx_fd, head, sizeof(head)) == sizeof(head) &&
+        strncmp(head, "RPX1", 4) == 0) {
+        old_count = (uint8_t)head[4] | ((uint16_t)(uint8_t)head[5] << 8);
+    } else {
+        if (idx_fd >= 0) close(idx_fd);
+        idx_fd = open(BROWSER_INDEX_FILE, O_RDWR | O_CREAT | O_TRUNC);
+        if (idx_fd < 0) {
+            printf("Error: Cannot create %s\n", BROWSER_INDEX_FILE);
+            return 0;
+        }
+    }
+
+    idx_count = 0;
+    int dir = f_opendir("0:");
+    if (dir < 0) {
+        printf("Error: Cannot list the USB drive\n");
+    } else {
+        while (idx_count < BROWSER_MAX_SONGS &&
+               f_readdir(&br_dirent, dir) == 0 && br_dirent.fname[0]) {
+            const char *name = br_dirent.altname[0] ? br_dirent.altname : br_dirent.fname;
+            if ((br_dirent.fattrib & FA_DIR) || !is_song_file(name) ||
+                strlen(name) >= sizeof(e.name)) continue;
+
+            memset(&e, 0, sizeof(e));
+            e.fsize = br_dirent.fsize;
+            e.fdate = br_dirent.fdate;
+            e.ftime = br_dirent.ftime;
+            strcpy(e.name, name);
+            strncpy(e.title, br_dirent.fname, sizeof(e.title) - 1);
+
+            // Still current in the old index?
+            bool found = false;
+            for (uint16_t j = old_pos; j < old_count && j < old_pos + INDEX_LOOKAHEAD; j++) {
+                if (index_read(j, &old) && strcmp(old.name, e.name) == 0 &&
+                    old.fsize == e.fsize && old.fdate == e.fdate && old.ftime == e.ftime) {
+                    if (j != idx_count && moved == BROWSER_MAX_SONGS) moved = idx_count;
+                    if (moved != BROWSER_MAX_SONGS) index_write(old_count + idx_count, &old);
+                    old_pos = j + 1;
+                    found = true;
+                    break;
+                }
+            }
+
+            if (!found) {
+                SongInfo info;
+                if (!read_song_info(e.name, &info)) continue;
+                e.bpm = info.bpm;
+                e.length = info.length;
+                e.used = info.used;
+                if (moved == BROWSER_MAX_SONGS) moved = idx_count;
+                index_write(old_count + idx_count, &e);
+                parsed++;
+            }
+            idx_count++;
+        }
+        f_closedir(dir);
+    }
+
+    // Copy the appended records down; each source lies at or past its slot
+    if (old_count) {
+        for (uint16_t i = moved; i < idx_count; i++) {
+            index_read(old_count + i, &e);
+            index_write(i, &e);
+        }
+    }
+
+    memcpy(head, "RPX1", 4);
+    head[4] = (char)(idx_count & 0xFF);
+    head[5] = (char)(idx_count >> 8);
+    lseek(idx_fd, 0, SEEK_SET);
+    write(idx_fd, head, sizeof(head));
+    return parsed;
+}
+
+// ============================================================================
+// BROWSER VIEW
+// ============================================================================
+
+static void browser_close(void) {
+    if (idx_fd >= 0) close(idx_fd);
+    idx_fd = -1;
+    is_browser_active = false;
+    refresh_all_ui(); // Clear the box and restore the dashboard
+}
+
+static void browser_read_page(void) {
+    memset(br_page, 0, sizeof(br_page));
+    for (uint8_t i = 0; i < BROWSER_PAGE_SIZE && br_top + i < idx_count; i++) {
+        index_read(br_top + i, &br_page[i]);
+    }
+}
+
+static void browser_draw(void) {
+    const uint8_t box_x = 10, box_y = 10;
+    char line[64];
+
+    draw_string(box_x, box_y,     "+----------------------------------------------------+", HUD_COL_WHITE, HUD_COL_BLUE);
+    draw_string(box_x, box_y + 1, "| FILE         TITLE                 BPM  LEN  PATS  |", HUD_COL_WHITE, HUD_COL_BLUE);
+    for (uint8_t i = 0; i < BROWSER_PAGE_SIZE; i++) {
+        uint16_t idx = br_top + i;
+        const BrowserEntry *e = &br_page[i];
+        if (idx < idx_count) {
+            snprintf(line, sizeof(line), "| %-12.12s %-20.20s  %3u  %3u  %4u  |",
+                     e->name, e->title, e->bpm, e->length, e->used);
+        } else {
+            snprintf(line, sizeof(line), "|                                                    |");
+        }
+        draw_string(box_x, box_y + 2 + i, line,
+                    (idx == br_sel) ? HUD_COL_YELLOW : HUD_COL_WHITE,
+                    (idx == br_sel) ? HUD_COL_SELECT_BG : HUD_COL_BLUE);
+    }
+    draw_string(box_x, box_y + 2 + BROWSER_PAGE_SIZE, "| [ENTER] LOAD   [TAB] TYPE A NAME   [ESC] CANCEL    |", HUD_COL_WHITE, HUD_COL_BLUE);
+    draw_string(box_x, box_y + 3 + BROWSER_PAGE_SIZE, "+----------------------------------------------------+", HUD_COL_WHITE, HUD_COL_BLUE);
+}
+
+static void browser_move(int16_t delta) {
+    int16_t sel = (int16_t)br_sel + delta;
+    if (sel >= (int16_t)idx_count) sel = (int16_t)idx_count - 1;
+    if (sel < 0) sel = 0;
+    br_sel = (uint16_t)sel;
+
+    if (br_sel < br_top || br_sel >= br_top + BROWSER_PAGE_SIZE) {
+        br_top = br_sel - (br_sel % BROWSER_PAGE_SIZE);
+        browser_read_page();
+    }
+    browser_draw();
+}
+
+// Opens the typed-name dialog instead (the old Ctrl+O behaviour)
+static void browser_type_name(void) {
+    browser_close();
+    is_dialog_active = true;
+    is_saving = false;
+    dialog_pos = 0;
+    dialog_buffer[0] = '\0';
+}
+
+void browser_open(void) {
+    uint16_t parsed = index_refresh();
+    if (idx_fd < 0) {
+        browser_type_name();
+        return;
+    }
+    printf("Songs: %u (%u read, rest from %s)\n", idx_count, parsed, BROWSER_INDEX_FILE);
+
+    br_top = 0;
+    br_sel = 0;
+    browser_read_page();
+    is_browser_active = true;
+    browser_draw();
+}
+
+void browser_task(void) {
+    if (key_repeat(KEY_UP))       browser_move(-1);
+    if (key_repeat(KEY_DOWN))     browser_move(1);
+    if (key_repeat(KEY_PAGEUP))   browser_move(-BROWSER_PAGE_SIZE);
+    if (key_repeat(KEY_PAGEDOWN)) browser_move(BROWSER_PAGE_SIZE);
+
+    if (key_pressed(KEY_ENTER) && br_sel < idx_count) {
+        char name[sizeof(br_page[0].name)];
+        strcpy(name, br_page[br_sel - br_top].name);
+        browser_close();
+        load_song_begin(name); // Continues in load_task()
+    } else if (key_pressed(KEY_TAB)) {
+        browser_type_name();
+    } else if (key_pressed(KEY_ESC)) {
+        browser_close();
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef BROWSER_H
+#define BROWSER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Song browser for Ctrl+O. Song details come from an index file that is
+// brought up to date on open, so only new or changed songs are read.
+//
+// RPTINDEX.DAT: "RPX1", Entry count (2B), then BrowserEntry records
+#define BROWSER_INDEX_FILE "RPTINDEX.DAT"
+#define BROWSER_MAX_SONGS  255
+#define BROWSER_PAGE_SIZE  16
+
+typedef struct {
+    uint32_t fsize;     // Size and FAT timestamp decide if the entry is current
+    uint16_t fdate;
+    uint16_t ftime;
+    uint16_t bpm;
+    uint16_t length;    // Orders
+    uint16_t used;      // Distinct patterns in the order list
+    char name[13];      // 8.3 name to open
+    char title[21];     // Long file name, cut to fit
+} BrowserEntry;         // 48 bytes, no padding
+
+extern bool is_browser_active;
+
+extern void browser_open(void);
+extern void browser_task(void);
+
+#endif // BROWSER_H
@@ -11,9 +11,10 @@
 #define MESSAGE_LENGTH (MESSAGE_WIDTH * MESSAGE_HEIGHT) // Total number of characters in the message area
 #define BYTES_PER_CHAR 3            // Number of bytes per character in text RAM
 
-#define MAX_PATTERNS 32 // Maximum number of patterns
+#define MAX_PATTERNS 256 // Logical patterns (32 resident in XRAM, see patterns.h)
 
 #define TEXT_CONFIG 0xC000          // Text Plane Configuration
+#define GRID_CONFIG 0xF850          // Grid plane configuration (rows 28-59 of the same text RAM)
 extern unsigned text_message_addr; // Address where text message starts in XRAM
 
 // 5. Keyboard, Gamepad and Sound
@@ -28,10 +29,16 @@ extern unsigned text_message_addr; // Address where text message starts in XRAM
 #define KEYBOARD_INPUT  0xFFA0  // XRAM address for keyboard data
 #define PSG_XRAM_ADDR   0xFFC0  // PSG memory location (must match sound.c)
 
+// Undo journal (the free XRAM between the order list and the text plane)
+#define UNDO_RING_XRAM   0xB500
+#define UNDO_RING_SIZE   0x0B00
+
 // Data export buffer
-#define EXPORT_BUF_XRAM  0xF850  // End of message buffer
+#define EXPORT_BUF_XRAM  0xF860  // After the grid plane config
 #define EXPORT_BUF_MAX   0xFE00  // Ensure we don't overwrite OPL area
 #define EXPORT_CHUNK     512     // Bytes per disk write (must be multiple of 512)
+#define EXPORT_STEMS     9       // Stem export: one stream per channel
+#define EXPORT_STEM_SIZE 160     // Slice of the export buffer per stem (9 * 160 fits)
 
 // Controller input
 #define GAMEPAD_COUNT 4       // Support up to 4 gamepads
@@ -159,7 +159,7 @@ void process_arp_logic(uint8_t ch) {
 
     // Retrigger
     OPL_NoteOff(ch);
-    OPL_SetPatch(ch, &gm_bank[ch_arp[ch].inst]);
+    OPL_SetPatch(ch, gm_patch(ch_arp[ch].inst));
     
     // RETAIN: Your MIDI vol << 1 mapping
     uint8_t vol = ch_volslide[ch].active ? ch_volslide[ch].current_vol : ch_arp[ch].vol;
@@ -319,7 +319,7 @@ void process_notedelay_logic(uint8_t ch) {
 
             // Trigger the echo
             OPL_NoteOff(ch);
-            OPL_SetPatch(ch, &gm_bank[ch_notedelay[ch].inst]);
+            OPL_SetPatch(ch, gm_patch(ch_notedelay[ch].inst));
             OPL_SetVolume(ch, ch_notedelay[ch].vol << 1); // Maintain MIDI mapping
             OPL_NoteOn(ch, ch_notedelay[ch].note);
             
@@ -354,7 +354,7 @@ void process_retrigger_logic(uint8_t ch) {
         
         // --- THE ACTION ---
         OPL_NoteOff(ch);
-        OPL_SetPatch(ch, &gm_bank[ch_retrigger[ch].inst]);
+        OPL_SetPatch(ch, gm_patch(ch_retrigger[ch].inst));
         OPL_SetVolume(ch, ch_retrigger[ch].vol << 1); 
         OPL_NoteOn(ch, ch_retrigger[ch].note);
         
@@ -421,7 +421,7 @@ void process_gen_logic(uint8_t ch) {
 
     // 3. RETRIGGER
     OPL_NoteOff(ch);
-    OPL_SetPatch(ch, &gm_bank[ch_generator[ch].inst]);
+    OPL_SetPatch(ch, gm_patch(ch_generator[ch].inst));
     OPL_SetVolume(ch, ch_generator[ch].vol << 1); 
     OPL_NoteOn(ch, ch_generator[ch].base_note + offset);
     ch_peaks[ch] = ch_generator[ch].vol;
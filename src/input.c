@@ -17,9 +17,60 @@ uint8_t keystates[KEYBOARD_BYTES] = {0};
 uint8_t prev_keystates[KEYBOARD_BYTES] = {0}; // To track previous states
 bool handled_key = false;
 
+// This frame's key changes, in scancode order (see handle_input)
+KeyEvent key_events[KEY_EVENT_MAX];
+uint8_t key_event_count = 0;
+uint8_t key_press_count = 0;
+
+// Key repeat state (see input.h)
+uint8_t key_repeat_delay = KEY_REPEAT_DELAY;
+uint8_t key_repeat_rate = KEY_REPEAT_RATE;
+static uint8_t repeat_key = 0;      // Key that repeats, 0 = none
+static uint16_t repeat_held = 0;    // Frames it has been down
+static uint8_t repeat_wait = 0;     // Frames until the next repeat
+static bool repeat_fire = false;    // repeat_key repeats this frame
+
 // Button mapping storage
 ButtonMapping button_mappings[GAMEPAD_COUNT][ACTION_COUNT];
 
+// ============================================================================
+// KEY REPEAT
+// ============================================================================
+
+static void update_key_repeat(void) {
+    repeat_fire = false;
+
+    // The last key pressed this frame takes over (presses report themselves)
+    for (uint8_t e = 0; e < key_event_count; e++) {
+        if (key_events[e].down && key_events[e].code < KEY_LEFTCTRL) {
+            repeat_key = key_events[e].code;
+            repeat_held = 0;
+            repeat_wait = key_repeat_delay;
+        }
+    }
+    if (!repeat_key) return;
+    if (!key(repeat_key)) {
+        repeat_key = 0;
+        return;
+    }
+    if (repeat_held == 0) {
+        repeat_held = 1;    // Pressed this frame
+        return;
+    }
+    if (repeat_held < 0xFFFF) repeat_held++;
+    if (--repeat_wait) return;
+
+    repeat_fire = true;
+    uint16_t repeating = (repeat_held > key_repeat_delay) ? repeat_held - key_repeat_delay : 0;
+    uint8_t steps = (repeating / KEY_REPEAT_ACCEL > 7) ? 7 : (uint8_t)(repeating / KEY_REPEAT_ACCEL);
+    repeat_wait = key_repeat_rate >> steps;
+    if (repeat_wait == 0) repeat_wait = 1;
+}
+
+bool key_repeat(uint8_t code) {
+    return key_pressed(code) || (repeat_fire && code == repeat_key);
+}
+
 /**
  * Read keyboard and gamepad input
  */
@@ -36,6 +87,22 @@ void handle_input(void)
     for (uint8_t i = 0; i < KEYBOARD_BYTES; i++) {
         keystates[i] = RIA.rw0;
     }
+
+    // Turn the changed bits into press/release events
+    key_event_count = 0;
+    key_press_count = 0;
+    for (uint8_t i = 0; i < KEYBOARD_BYTES; i++) {
+        uint8_t diff = keystates[i] ^ prev_keystates[i];
+        if (!diff) continue;
+        for (uint8_t b = 0; b < 8; b++) {
+            if (!(diff & (1 << b)) || key_event_count == KEY_EVENT_MAX) continue;
+            KeyEvent *e = &key_events[key_event_count++];
+            e->code = (uint8_t)((i << 3) | b);
+            e->down = (keystates[i] >> b) & 1;
+            if (e->down) key_press_count++;
+        }
+    }
+    update_key_repeat();
     
     // Read gamepad data
     RIA.addr0 = GAMEPAD_INPUT;
@@ -23,9 +23,31 @@ extern bool handled_key;
 #define key_released(k) (!(keystates[(k)>>3] & (1<<((k)&7))) &&  (prev_keystates[(k)>>3] & (1<<((k)&7))) )
 #define key_held(k)     ( (keystates[(k)>>3] & (1<<((k)&7))) )
 
-// Key repeat settings
-#define REPEAT_DELAY 15
-#define REPEAT_RATE 3
+// Key events: handle_input() compares keystates with prev_keystates once per
+// frame and lists every key that went down or up. Consumers read the list;
+// nothing is removed from it.
+#define KEY_EVENT_MAX 32
+
+typedef struct {
+    uint8_t code;   // USB HID scancode
+    bool down;      // true = pressed this frame, false = released
+} KeyEvent;
+
+extern KeyEvent key_events[KEY_EVENT_MAX];
+extern uint8_t key_event_count;
+extern uint8_t key_press_count;  // How many of the events are presses
+
+// Key repeat: key_repeat(k) is true on the frame k goes down, then again
+// every key_repeat_rate frames once it has been held key_repeat_delay
+// frames. The rate doubles every KEY_REPEAT_ACCEL frames of repeating, up to
+// once per frame. Only the last key pressed repeats; modifiers never do.
+#define KEY_REPEAT_DELAY 20 // Frames before repeat starts
+#define KEY_REPEAT_RATE  4  // Frames between repeats
+#define KEY_REPEAT_ACCEL 30 // Frames of repeating per speed-up step
+
+extern uint8_t key_repeat_delay;
+extern uint8_t key_repeat_rate;
+extern bool key_repeat(uint8_t code);
 
 // ============================================================================
 // GAMEPAD SUPPORT
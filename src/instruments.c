@@ -1,311 +1,118 @@
 
 #include <rp6502.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "instruments.h"
+#include "midiout.h"
 
-// Auto-generated Standard Bank (AdLib Compatible)
-const OPL_Patch gm_bank[256] = {
-    [0] = { .m_ave=0x01, .m_ksl=0x4B, .m_atdec=0xF1, .m_susrel=0x50, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xD2, .c_susrel=0x76, .c_wave=0x00, .feedback=0x06 },
-    [1] = { .m_ave=0x13, .m_ksl=0x50, .m_atdec=0xF1, .m_susrel=0x50, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xD2, .c_susrel=0x76, .c_wave=0x00, .feedback=0x06 },
-    [2] = { .m_ave=0x13, .m_ksl=0x53, .m_atdec=0xF1, .m_susrel=0x54, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xD2, .c_susrel=0x76, .c_wave=0x00, .feedback=0x06 },
-    [3] = { .m_ave=0x53, .m_ksl=0x4E, .m_atdec=0xF1, .m_susrel=0x00, .m_wave=0x00, .c_ave=0x51, .c_ksl=0x00, .c_atdec=0xD2, .c_susrel=0x86, .c_wave=0x00, .feedback=0x06 },
-    [4] = { .m_ave=0x2C, .m_ksl=0xD4, .m_atdec=0xF9, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0xA1, .c_ksl=0x00, .c_atdec=0xC1, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x00 },
-    [5] = { .m_ave=0x34, .m_ksl=0x92, .m_atdec=0xFF, .m_susrel=0x13, .m_wave=0x00, .c_ave=0x23, .c_ksl=0x00, .c_atdec=0xF4, .c_susrel=0xF7, .c_wave=0x00, .feedback=0x0A },
-    [6] = { .m_ave=0x31, .m_ksl=0x81, .m_atdec=0xA1, .m_susrel=0x30, .m_wave=0x00, .c_ave=0x16, .c_ksl=0x80, .c_atdec=0xC2, .c_susrel=0x74, .c_wave=0x00, .feedback=0x08 },
-    [7] = { .m_ave=0x23, .m_ksl=0x8A, .m_atdec=0xF2, .m_susrel=0x7B, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x80, .c_atdec=0xF4, .c_susrel=0x7B, .c_wave=0x00, .feedback=0x08 },
-    [8] = { .m_ave=0x32, .m_ksl=0x80, .m_atdec=0x01, .m_susrel=0x10, .m_wave=0x00, .c_ave=0x12, .c_ksl=0x80, .c_atdec=0x72, .c_susrel=0x33, .c_wave=0x00, .feedback=0x08 },
-    [9] = { .m_ave=0x16, .m_ksl=0x4D, .m_atdec=0xFA, .m_susrel=0x11, .m_wave=0x00, .c_ave=0xE1, .c_ksl=0x00, .c_atdec=0xF1, .c_susrel=0xF1, .c_wave=0x00, .feedback=0x08 },
-    [10] = { .m_ave=0xD6, .m_ksl=0x4D, .m_atdec=0xFA, .m_susrel=0x11, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0xF5, .c_wave=0x00, .feedback=0x08 },
-    [11] = { .m_ave=0x45, .m_ksl=0x4E, .m_atdec=0xDA, .m_susrel=0x15, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x80, .c_atdec=0xF3, .c_susrel=0xF6, .c_wave=0x00, .feedback=0x00 },
-    [12] = { .m_ave=0x04, .m_ksl=0x00, .m_atdec=0xFE, .m_susrel=0xF0, .m_wave=0x00, .c_ave=0xC2, .c_ksl=0x00, .c_atdec=0xF6, .c_susrel=0xB5, .c_wave=0x00, .feedback=0x0E },
-    [13] = { .m_ave=0x05, .m_ksl=0x05, .m_atdec=0xFE, .m_susrel=0x65, .m_wave=0x00, .c_ave=0xC4, .c_ksl=0x00, .c_atdec=0xF8, .c_susrel=0x85, .c_wave=0x00, .feedback=0x0E },
-    [14] = { .m_ave=0xD7, .m_ksl=0x4F, .m_atdec=0xF2, .m_susrel=0x61, .m_wave=0x00, .c_ave=0xD2, .c_ksl=0x00, .c_atdec=0xF1, .c_susrel=0xB2, .c_wave=0x00, .feedback=0x08 },
-    [15] = { .m_ave=0x11, .m_ksl=0x11, .m_atdec=0xFE, .m_susrel=0x04, .m_wave=0x00, .c_ave=0x11, .c_ksl=0x00, .c_atdec=0xF2, .c_susrel=0xBD, .c_wave=0x00, .feedback=0x08 },
-    [16] = { .m_ave=0x64, .m_ksl=0x86, .m_atdec=0xFF, .m_susrel=0x0F, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x80, .c_atdec=0xFF, .c_susrel=0x0F, .c_wave=0x00, .feedback=0x01 },
-    [17] = { .m_ave=0x2B, .m_ksl=0xCA, .m_atdec=0xF8, .m_susrel=0xE5, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0xC0, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x00 },
-    [18] = { .m_ave=0x2C, .m_ksl=0xD4, .m_atdec=0xF9, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0xA1, .c_ksl=0x00, .c_atdec=0xC0, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x00 },
-    [19] = { .m_ave=0x64, .m_ksl=0x86, .m_atdec=0xFF, .m_susrel=0x0F, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x80, .c_atdec=0xFF, .c_susrel=0x0F, .c_wave=0x00, .feedback=0x01 },
-    [20] = { .m_ave=0xE2, .m_ksl=0xCA, .m_atdec=0xF8, .m_susrel=0xE5, .m_wave=0x00, .c_ave=0xE1, .c_ksl=0x00, .c_atdec=0xC0, .c_susrel=0x0E, .c_wave=0x00, .feedback=0x08 },
-    [21] = { .m_ave=0x64, .m_ksl=0xC9, .m_atdec=0xB0, .m_susrel=0x01, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x70, .c_susrel=0x87, .c_wave=0x00, .feedback=0x02 },
-    [22] = { .m_ave=0x24, .m_ksl=0x4F, .m_atdec=0xF2, .m_susrel=0x06, .m_wave=0x00, .c_ave=0x31, .c_ksl=0x00, .c_atdec=0x52, .c_susrel=0x06, .c_wave=0x00, .feedback=0x0E },
-    [23] = { .m_ave=0x24, .m_ksl=0x54, .m_atdec=0x55, .m_susrel=0xFD, .m_wave=0x00, .c_ave=0x31, .c_ksl=0x00, .c_atdec=0x50, .c_susrel=0x2D, .c_wave=0x00, .feedback=0x0E },
-    [24] = { .m_ave=0x01, .m_ksl=0x4D, .m_atdec=0xF1, .m_susrel=0x55, .m_wave=0x00, .c_ave=0x11, .c_ksl=0x02, .c_atdec=0xF1, .c_susrel=0x74, .c_wave=0x00, .feedback=0x06 },
-    [25] = { .m_ave=0x01, .m_ksl=0x90, .m_atdec=0xF1, .m_susrel=0x56, .m_wave=0x00, .c_ave=0x11, .c_ksl=0x04, .c_atdec=0xF1, .c_susrel=0x76, .c_wave=0x00, .feedback=0x06 },
-    [26] = { .m_ave=0x33, .m_ksl=0x24, .m_atdec=0xD2, .m_susrel=0xC1, .m_wave=0x01, .c_ave=0x31, .c_ksl=0x00, .c_atdec=0xF1, .c_susrel=0x9C, .c_wave=0x00, .feedback=0x0E },
-    [27] = { .m_ave=0x53, .m_ksl=0x16, .m_atdec=0xF2, .m_susrel=0xC8, .m_wave=0x00, .c_ave=0x11, .c_ksl=0x40, .c_atdec=0xF2, .c_susrel=0xC5, .c_wave=0x00, .feedback=0x04 },
-    [28] = { .m_ave=0x53, .m_ksl=0x20, .m_atdec=0xF2, .m_susrel=0xC8, .m_wave=0x00, .c_ave=0x11, .c_ksl=0x00, .c_atdec=0xF2, .c_susrel=0xC5, .c_wave=0x00, .feedback=0x04 },
-    [29] = { .m_ave=0x11, .m_ksl=0x43, .m_atdec=0xF1, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x54, .c_ksl=0x00, .c_atdec=0xF0, .c_susrel=0xFF, .c_wave=0x03, .feedback=0x08 },
-    [30] = { .m_ave=0x11, .m_ksl=0x43, .m_atdec=0xF1, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x54, .c_ksl=0x40, .c_atdec=0xF0, .c_susrel=0xFF, .c_wave=0x03, .feedback=0x08 },
-    [31] = { .m_ave=0xCA, .m_ksl=0x4E, .m_atdec=0xF0, .m_susrel=0xF0, .m_wave=0x00, .c_ave=0xEC, .c_ksl=0x00, .c_atdec=0x59, .c_susrel=0x68, .c_wave=0x00, .feedback=0x0C },
-    [32] = { .m_ave=0x21, .m_ksl=0x15, .m_atdec=0xD3, .m_susrel=0x2C, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x80, .c_atdec=0xC3, .c_susrel=0x2C, .c_wave=0x00, .feedback=0x0A },
-    [33] = { .m_ave=0x01, .m_ksl=0x18, .m_atdec=0xD4, .m_susrel=0xF2, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x80, .c_atdec=0xC4, .c_susrel=0x8A, .c_wave=0x00, .feedback=0x0A },
-    [34] = { .m_ave=0x21, .m_ksl=0x4E, .m_atdec=0xF0, .m_susrel=0x7B, .m_wave=0x00, .c_ave=0x31, .c_ksl=0x00, .c_atdec=0xF3, .c_susrel=0xC8, .c_wave=0x00, .feedback=0x04 },
-    [35] = { .m_ave=0x01, .m_ksl=0x18, .m_atdec=0xD4, .m_susrel=0xF2, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x80, .c_atdec=0x84, .c_susrel=0x8A, .c_wave=0x00, .feedback=0x0A },
-    [36] = { .m_ave=0x53, .m_ksl=0x0E, .m_atdec=0xF4, .m_susrel=0xC8, .m_wave=0x00, .c_ave=0x11, .c_ksl=0x0B, .c_atdec=0xF1, .c_susrel=0xBB, .c_wave=0x00, .feedback=0x04 },
-    [37] = { .m_ave=0x00, .m_ksl=0x1D, .m_atdec=0xB4, .m_susrel=0x7A, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xC3, .c_susrel=0x7C, .c_wave=0x00, .feedback=0x00 },
-    [38] = { .m_ave=0x21, .m_ksl=0x00, .m_atdec=0xF1, .m_susrel=0x38, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0xF1, .c_susrel=0x38, .c_wave=0x00, .feedback=0x01 },
-    [39] = { .m_ave=0x01, .m_ksl=0x00, .m_atdec=0xF1, .m_susrel=0x54, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xF1, .c_susrel=0x54, .c_wave=0x00, .feedback=0x00 },
-    [40] = { .m_ave=0x71, .m_ksl=0x56, .m_atdec=0x51, .m_susrel=0x03, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x54, .c_susrel=0x17, .c_wave=0x00, .feedback=0x0E },
-    [41] = { .m_ave=0x71, .m_ksl=0x20, .m_atdec=0x51, .m_susrel=0x03, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x54, .c_susrel=0x17, .c_wave=0x00, .feedback=0x0E },
-    [42] = { .m_ave=0x71, .m_ksl=0x1E, .m_atdec=0x51, .m_susrel=0x03, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x54, .c_susrel=0x17, .c_wave=0x00, .feedback=0x0E },
-    [43] = { .m_ave=0x71, .m_ksl=0x1E, .m_atdec=0x51, .m_susrel=0x03, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x54, .c_susrel=0x17, .c_wave=0x00, .feedback=0x0E },
-    [44] = { .m_ave=0x71, .m_ksl=0x1C, .m_atdec=0x51, .m_susrel=0x03, .m_wave=0x00, .c_ave=0x23, .c_ksl=0x00, .c_atdec=0x54, .c_susrel=0x17, .c_wave=0x00, .feedback=0x0E },
-    [45] = { .m_ave=0x00, .m_ksl=0x0B, .m_atdec=0xA8, .m_susrel=0x4C, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xD6, .c_susrel=0x4F, .c_wave=0x00, .feedback=0x00 },
-    [46] = { .m_ave=0x02, .m_ksl=0x29, .m_atdec=0xF5, .m_susrel=0x75, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x80, .c_atdec=0xF2, .c_susrel=0xF3, .c_wave=0x00, .feedback=0x00 },
-    [47] = { .m_ave=0x00, .m_ksl=0x7F, .m_atdec=0xF3, .m_susrel=0x53, .m_wave=0x00, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF7, .c_susrel=0x94, .c_wave=0x00, .feedback=0x0F },
-    [48] = { .m_ave=0xF1, .m_ksl=0x18, .m_atdec=0x32, .m_susrel=0x14, .m_wave=0x00, .c_ave=0xE1, .c_ksl=0x00, .c_atdec=0xF1, .c_susrel=0x16, .c_wave=0x00, .feedback=0x00 },
-    [49] = { .m_ave=0x31, .m_ksl=0x8B, .m_atdec=0x41, .m_susrel=0x11, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x22, .c_susrel=0x13, .c_wave=0x00, .feedback=0x06 },
-    [50] = { .m_ave=0xF1, .m_ksl=0x18, .m_atdec=0x32, .m_susrel=0x11, .m_wave=0x00, .c_ave=0xE1, .c_ksl=0x00, .c_atdec=0x51, .c_susrel=0x14, .c_wave=0x00, .feedback=0x00 },
-    [51] = { .m_ave=0x21, .m_ksl=0x8A, .m_atdec=0x32, .m_susrel=0x31, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x32, .c_susrel=0x15, .c_wave=0x00, .feedback=0x02 },
-    [52] = { .m_ave=0x61, .m_ksl=0x98, .m_atdec=0x72, .m_susrel=0x88, .m_wave=0x00, .c_ave=0xE1, .c_ksl=0x80, .c_atdec=0x50, .c_susrel=0x16, .c_wave=0x00, .feedback=0x02 },
-    [53] = { .m_ave=0x61, .m_ksl=0xA7, .m_atdec=0x72, .m_susrel=0x8B, .m_wave=0x00, .c_ave=0xE1, .c_ksl=0x81, .c_atdec=0x80, .c_susrel=0x17, .c_wave=0x00, .feedback=0x02 },
-    [54] = { .m_ave=0x41, .m_ksl=0x4F, .m_atdec=0xF1, .m_susrel=0x73, .m_wave=0x01, .c_ave=0x41, .c_ksl=0x10, .c_atdec=0x52, .c_susrel=0x74, .c_wave=0x00, .feedback=0x06 },
-    [55] = { .m_ave=0x11, .m_ksl=0x03, .m_atdec=0x84, .m_susrel=0x94, .m_wave=0x00, .c_ave=0xE4, .c_ksl=0x40, .c_atdec=0xF4, .c_susrel=0xF4, .c_wave=0x00, .feedback=0x08 },
-    [56] = { .m_ave=0x61, .m_ksl=0x19, .m_atdec=0x73, .m_susrel=0x57, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0xA0, .c_susrel=0x17, .c_wave=0x00, .feedback=0x0C },
-    [57] = { .m_ave=0x31, .m_ksl=0x1F, .m_atdec=0x41, .m_susrel=0x06, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0xA0, .c_susrel=0x36, .c_wave=0x00, .feedback=0x0C },
-    [58] = { .m_ave=0x61, .m_ksl=0x19, .m_atdec=0x53, .m_susrel=0x56, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0xA0, .c_susrel=0x16, .c_wave=0x00, .feedback=0x0C },
-    [59] = { .m_ave=0x71, .m_ksl=0x1C, .m_atdec=0x51, .m_susrel=0x03, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0x54, .c_susrel=0x67, .c_wave=0x00, .feedback=0x0E },
-    [60] = { .m_ave=0x21, .m_ksl=0x9A, .m_atdec=0x53, .m_susrel=0x56, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x80, .c_atdec=0xA0, .c_susrel=0x16, .c_wave=0x00, .feedback=0x0E },
-    [61] = { .m_ave=0x61, .m_ksl=0x19, .m_atdec=0x73, .m_susrel=0x57, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0xA0, .c_susrel=0x17, .c_wave=0x00, .feedback=0x0C },
-    [62] = { .m_ave=0x21, .m_ksl=0x1B, .m_atdec=0x71, .m_susrel=0xA6, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0xA1, .c_susrel=0x96, .c_wave=0x00, .feedback=0x0E },
-    [63] = { .m_ave=0x61, .m_ksl=0x1C, .m_atdec=0x63, .m_susrel=0x57, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0xA0, .c_susrel=0x17, .c_wave=0x00, .feedback=0x0C },
-    [64] = { .m_ave=0x21, .m_ksl=0x1B, .m_atdec=0x63, .m_susrel=0x0A, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0x63, .c_susrel=0x0B, .c_wave=0x00, .feedback=0x0C },
-    [65] = { .m_ave=0x21, .m_ksl=0x16, .m_atdec=0x63, .m_susrel=0x0E, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0x63, .c_susrel=0x0E, .c_wave=0x00, .feedback=0x0C },
-    [66] = { .m_ave=0x31, .m_ksl=0x16, .m_atdec=0x63, .m_susrel=0x0A, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0x63, .c_susrel=0x0B, .c_wave=0x00, .feedback=0x0C },
-    [67] = { .m_ave=0x20, .m_ksl=0x1B, .m_atdec=0x63, .m_susrel=0x0A, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0x63, .c_susrel=0x0B, .c_wave=0x00, .feedback=0x0C },
-    [68] = { .m_ave=0x70, .m_ksl=0x8D, .m_atdec=0x6E, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x22, .c_ksl=0x00, .c_atdec=0x6B, .c_susrel=0x0E, .c_wave=0x00, .feedback=0x02 },
-    [69] = { .m_ave=0x70, .m_ksl=0x16, .m_atdec=0x71, .m_susrel=0x0E, .m_wave=0x00, .c_ave=0x23, .c_ksl=0x07, .c_atdec=0x78, .c_susrel=0x0E, .c_wave=0x00, .feedback=0x0E },
-    [70] = { .m_ave=0x31, .m_ksl=0x45, .m_atdec=0x87, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x22, .c_ksl=0x00, .c_atdec=0x8B, .c_susrel=0x0E, .c_wave=0x00, .feedback=0x02 },
-    [71] = { .m_ave=0x32, .m_ksl=0x1C, .m_atdec=0x82, .m_susrel=0x18, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x80, .c_atdec=0x60, .c_susrel=0x07, .c_wave=0x00, .feedback=0x0C },
-    [72] = { .m_ave=0xA2, .m_ksl=0x1D, .m_atdec=0x95, .m_susrel=0x24, .m_wave=0x00, .c_ave=0xE2, .c_ksl=0x80, .c_atdec=0x60, .c_susrel=0x2A, .c_wave=0x00, .feedback=0x02 },
-    [73] = { .m_ave=0xA1, .m_ksl=0x13, .m_atdec=0xD6, .m_susrel=0xAF, .m_wave=0x00, .c_ave=0xE2, .c_ksl=0x80, .c_atdec=0x60, .c_susrel=0x2A, .c_wave=0x00, .feedback=0x02 },
-    [74] = { .m_ave=0xA2, .m_ksl=0x1D, .m_atdec=0x98, .m_susrel=0x24, .m_wave=0x00, .c_ave=0xE2, .c_ksl=0x80, .c_atdec=0x60, .c_susrel=0x2A, .c_wave=0x00, .feedback=0x02 },
-    [75] = { .m_ave=0xA1, .m_ksl=0x13, .m_atdec=0xD6, .m_susrel=0x4F, .m_wave=0x00, .c_ave=0xE2, .c_ksl=0x80, .c_atdec=0x60, .c_susrel=0x2A, .c_wave=0x00, .feedback=0x02 },
-    [76] = { .m_ave=0x53, .m_ksl=0x85, .m_atdec=0x3F, .m_susrel=0x06, .m_wave=0x01, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0x5F, .c_susrel=0x07, .c_wave=0x00, .feedback=0x06 },
-    [77] = { .m_ave=0xE0, .m_ksl=0xEC, .m_atdec=0x6E, .m_susrel=0x8F, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x65, .c_susrel=0x2A, .c_wave=0x00, .feedback=0x0E },
-    [78] = { .m_ave=0xF5, .m_ksl=0x9A, .m_atdec=0x0C, .m_susrel=0xC7, .m_wave=0x00, .c_ave=0xF6, .c_ksl=0x80, .c_atdec=0x60, .c_susrel=0xA5, .c_wave=0x00, .feedback=0x0D },
-    [79] = { .m_ave=0xE2, .m_ksl=0xCA, .m_atdec=0xF8, .m_susrel=0xE5, .m_wave=0x00, .c_ave=0xE1, .c_ksl=0x00, .c_atdec=0x70, .c_susrel=0x0E, .c_wave=0x00, .feedback=0x08 },
-    [80] = { .m_ave=0x21, .m_ksl=0x1D, .m_atdec=0xF2, .m_susrel=0x0F, .m_wave=0x03, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0xF2, .c_susrel=0x18, .c_wave=0x00, .feedback=0x00 },
-    [81] = { .m_ave=0x41, .m_ksl=0x11, .m_atdec=0xF0, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xF0, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x0A },
-    [82] = { .m_ave=0xA4, .m_ksl=0x12, .m_atdec=0xF4, .m_susrel=0x30, .m_wave=0x00, .c_ave=0xE2, .c_ksl=0x8B, .c_atdec=0x60, .c_susrel=0x2A, .c_wave=0x00, .feedback=0x02 },
-    [83] = { .m_ave=0xE2, .m_ksl=0xCA, .m_atdec=0xF8, .m_susrel=0xE5, .m_wave=0x00, .c_ave=0xE1, .c_ksl=0x00, .c_atdec=0xC0, .c_susrel=0x0E, .c_wave=0x00, .feedback=0x08 },
-    [84] = { .m_ave=0x01, .m_ksl=0xCE, .m_atdec=0xF1, .m_susrel=0xBD, .m_wave=0x00, .c_ave=0x02, .c_ksl=0x80, .c_atdec=0xF1, .c_susrel=0x9F, .c_wave=0x03, .feedback=0x00 },
-    [85] = { .m_ave=0x61, .m_ksl=0x19, .m_atdec=0x73, .m_susrel=0x57, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x00, .c_atdec=0xA0, .c_susrel=0x17, .c_wave=0x00, .feedback=0x0C },
-    [86] = { .m_ave=0x41, .m_ksl=0x0E, .m_atdec=0xF1, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x09, .c_atdec=0xF0, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x0A },
-    [87] = { .m_ave=0x31, .m_ksl=0x44, .m_atdec=0xF2, .m_susrel=0x9A, .m_wave=0x00, .c_ave=0x32, .c_ksl=0x00, .c_atdec=0xF0, .c_susrel=0x27, .c_wave=0x00, .feedback=0x06 },
-    [88] = { .m_ave=0x07, .m_ksl=0x51, .m_atdec=0xF5, .m_susrel=0x33, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0xF0, .c_susrel=0x25, .c_wave=0x00, .feedback=0x06 },
-    [89] = { .m_ave=0x21, .m_ksl=0x8E, .m_atdec=0x21, .m_susrel=0x13, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x22, .c_susrel=0x13, .c_wave=0x00, .feedback=0x06 },
-    [90] = { .m_ave=0x30, .m_ksl=0x90, .m_atdec=0xF4, .m_susrel=0x49, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x00, .c_atdec=0xF4, .c_susrel=0x33, .c_wave=0x00, .feedback=0x0C },
-    [91] = { .m_ave=0x31, .m_ksl=0x8E, .m_atdec=0xFF, .m_susrel=0x21, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x01, .c_atdec=0x94, .c_susrel=0x15, .c_wave=0x00, .feedback=0x0A },
-    [92] = { .m_ave=0xCA, .m_ksl=0x4E, .m_atdec=0xF0, .m_susrel=0xF0, .m_wave=0x00, .c_ave=0xCC, .c_ksl=0x00, .c_atdec=0x59, .c_susrel=0x64, .c_wave=0x00, .feedback=0x0C },
-    [93] = { .m_ave=0x18, .m_ksl=0x4D, .m_atdec=0x32, .m_susrel=0x13, .m_wave=0x00, .c_ave=0xE1, .c_ksl=0x0C, .c_atdec=0x51, .c_susrel=0xE3, .c_wave=0x00, .feedback=0x08 },
-    [94] = { .m_ave=0x01, .m_ksl=0x43, .m_atdec=0x20, .m_susrel=0x15, .m_wave=0x00, .c_ave=0xF1, .c_ksl=0x00, .c_atdec=0x21, .c_susrel=0xF2, .c_wave=0x00, .feedback=0x08 },
-    [95] = { .m_ave=0x11, .m_ksl=0x92, .m_atdec=0x20, .m_susrel=0x13, .m_wave=0x00, .c_ave=0xF1, .c_ksl=0x00, .c_atdec=0x31, .c_susrel=0xF2, .c_wave=0x00, .feedback=0x08 },
-    [96] = { .m_ave=0x34, .m_ksl=0x91, .m_atdec=0xFF, .m_susrel=0x10, .m_wave=0x00, .c_ave=0x03, .c_ksl=0x00, .c_atdec=0xFF, .c_susrel=0x04, .c_wave=0x00, .feedback=0x0A },
-    [97] = { .m_ave=0x17, .m_ksl=0xC0, .m_atdec=0x12, .m_susrel=0x41, .m_wave=0x00, .c_ave=0x31, .c_ksl=0x80, .c_atdec=0x13, .c_susrel=0x31, .c_wave=0x00, .feedback=0x06 },
-    [98] = { .m_ave=0xB3, .m_ksl=0x4A, .m_atdec=0xB6, .m_susrel=0x32, .m_wave=0x00, .c_ave=0xB0, .c_ksl=0x00, .c_atdec=0xD1, .c_susrel=0x31, .c_wave=0x00, .feedback=0x0E },
-    [99] = { .m_ave=0x03, .m_ksl=0x8F, .m_atdec=0xF5, .m_susrel=0x55, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x80, .c_atdec=0xF3, .c_susrel=0x33, .c_wave=0x00, .feedback=0x00 },
-    [100] = { .m_ave=0x73, .m_ksl=0x48, .m_atdec=0xF1, .m_susrel=0x53, .m_wave=0x00, .c_ave=0x71, .c_ksl=0x0B, .c_atdec=0xF1, .c_susrel=0x03, .c_wave=0x00, .feedback=0x08 },
-    [101] = { .m_ave=0x21, .m_ksl=0x8B, .m_atdec=0x11, .m_susrel=0x14, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x12, .c_susrel=0x13, .c_wave=0x00, .feedback=0x02 },
-    [102] = { .m_ave=0x11, .m_ksl=0x03, .m_atdec=0x82, .m_susrel=0x97, .m_wave=0x00, .c_ave=0xE4, .c_ksl=0x40, .c_atdec=0xF0, .c_susrel=0xF3, .c_wave=0x00, .feedback=0x08 },
-    [103] = { .m_ave=0xB4, .m_ksl=0x87, .m_atdec=0xA4, .m_susrel=0x02, .m_wave=0x00, .c_ave=0xD7, .c_ksl=0x80, .c_atdec=0x40, .c_susrel=0x42, .c_wave=0x00, .feedback=0x06 },
-    [104] = { .m_ave=0x01, .m_ksl=0x40, .m_atdec=0xF1, .m_susrel=0x53, .m_wave=0x00, .c_ave=0x08, .c_ksl=0x40, .c_atdec=0xF1, .c_susrel=0x53, .c_wave=0x00, .feedback=0x00 },
-    [105] = { .m_ave=0x31, .m_ksl=0x87, .m_atdec=0xA1, .m_susrel=0x11, .m_wave=0x00, .c_ave=0x16, .c_ksl=0x80, .c_atdec=0x7D, .c_susrel=0x45, .c_wave=0x00, .feedback=0x08 },
-    [106] = { .m_ave=0x00, .m_ksl=0x50, .m_atdec=0xF2, .m_susrel=0x70, .m_wave=0x00, .c_ave=0x13, .c_ksl=0x0B, .c_atdec=0xF2, .c_susrel=0x72, .c_wave=0x00, .feedback=0x0E },
-    [107] = { .m_ave=0x00, .m_ksl=0x40, .m_atdec=0x09, .m_susrel=0x53, .m_wave=0x00, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF7, .c_susrel=0x94, .c_wave=0x00, .feedback=0x0E },
-    [108] = { .m_ave=0x05, .m_ksl=0x05, .m_atdec=0xFE, .m_susrel=0x65, .m_wave=0x00, .c_ave=0xC4, .c_ksl=0x00, .c_atdec=0xF8, .c_susrel=0x85, .c_wave=0x00, .feedback=0x0E },
-    [109] = { .m_ave=0x01, .m_ksl=0x11, .m_atdec=0xF0, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xF0, .c_susrel=0xF8, .c_wave=0x00, .feedback=0x0A },
-    [110] = { .m_ave=0x71, .m_ksl=0x56, .m_atdec=0x51, .m_susrel=0x03, .m_wave=0x00, .c_ave=0x61, .c_ksl=0x00, .c_atdec=0x54, .c_susrel=0x17, .c_wave=0x00, .feedback=0x0E },
-    [111] = { .m_ave=0x30, .m_ksl=0x16, .m_atdec=0x71, .m_susrel=0xEE, .m_wave=0x00, .c_ave=0x23, .c_ksl=0x00, .c_atdec=0x88, .c_susrel=0x1E, .c_wave=0x00, .feedback=0x0E },
-    [112] = { .m_ave=0x87, .m_ksl=0x91, .m_atdec=0xF5, .m_susrel=0x55, .m_wave=0x00, .c_ave=0x22, .c_ksl=0x00, .c_atdec=0xF0, .c_susrel=0x54, .c_wave=0x00, .feedback=0x06 },
-    [113] = { .m_ave=0x95, .m_ksl=0x81, .m_atdec=0xE7, .m_susrel=0x01, .m_wave=0x00, .c_ave=0x16, .c_ksl=0x00, .c_atdec=0x96, .c_susrel=0x67, .c_wave=0x00, .feedback=0x04 },
-    [114] = { .m_ave=0x09, .m_ksl=0x4E, .m_atdec=0xDA, .m_susrel=0x25, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xF1, .c_susrel=0x15, .c_wave=0x00, .feedback=0x0A },
-    [115] = { .m_ave=0x32, .m_ksl=0x44, .m_atdec=0xF8, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x11, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x7F, .c_wave=0x00, .feedback=0x0E },
-    [116] = { .m_ave=0x00, .m_ksl=0x3F, .m_atdec=0x39, .m_susrel=0xF3, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xFF, .c_susrel=0x05, .c_wave=0x00, .feedback=0x01 },
-    [117] = { .m_ave=0x32, .m_ksl=0x44, .m_atdec=0xF8, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0xF8, .c_wave=0x00, .feedback=0x0E },
-    [118] = { .m_ave=0x00, .m_ksl=0x0D, .m_atdec=0xE8, .m_susrel=0xEF, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xA5, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x06 },
-    [119] = { .m_ave=0x07, .m_ksl=0x00, .m_atdec=0xF0, .m_susrel=0xF0, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0x5C, .c_susrel=0xDC, .c_wave=0x00, .feedback=0x0E },
-    [120] = { .m_ave=0x32, .m_ksl=0x21, .m_atdec=0x34, .m_susrel=0xB3, .m_wave=0x01, .c_ave=0x31, .c_ksl=0x00, .c_atdec=0x54, .c_susrel=0xF7, .c_wave=0x03, .feedback=0x0E },
-    [121] = { .m_ave=0x20, .m_ksl=0x5B, .m_atdec=0x00, .m_susrel=0x16, .m_wave=0x00, .c_ave=0xE2, .c_ksl=0x80, .c_atdec=0x50, .c_susrel=0x15, .c_wave=0x00, .feedback=0x0A },
-    [122] = { .m_ave=0x0F, .m_ksl=0x40, .m_atdec=0xD1, .m_susrel=0x53, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x0B, .c_atdec=0x22, .c_susrel=0x56, .c_wave=0x00, .feedback=0x0E },
-    [123] = { .m_ave=0x1C, .m_ksl=0x1E, .m_atdec=0xE5, .m_susrel=0x5B, .m_wave=0x00, .c_ave=0x0C, .c_ksl=0x0B, .c_atdec=0x5D, .c_susrel=0xFA, .c_wave=0x00, .feedback=0x0E },
-    [124] = { .m_ave=0xB0, .m_ksl=0xC4, .m_atdec=0xA4, .m_susrel=0x02, .m_wave=0x00, .c_ave=0xD7, .c_ksl=0x89, .c_atdec=0x40, .c_susrel=0x42, .c_wave=0x00, .feedback=0x00 },
-    [125] = { .m_ave=0x0F, .m_ksl=0x40, .m_atdec=0xD1, .m_susrel=0x53, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x0B, .c_atdec=0x22, .c_susrel=0x56, .c_wave=0x00, .feedback=0x0E },
-    [126] = { .m_ave=0x00, .m_ksl=0x40, .m_atdec=0xD1, .m_susrel=0x53, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x0B, .c_atdec=0x62, .c_susrel=0x56, .c_wave=0x00, .feedback=0x0E },
-    [127] = { .m_ave=0x06, .m_ksl=0x00, .m_atdec=0xF4, .m_susrel=0xA0, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xF6, .c_susrel=0x46, .c_wave=0x00, .feedback=0x0E },
-    [128] = { .m_ave=0x30, .m_ksl=0x00, .m_atdec=0xF1, .m_susrel=0xF4, .m_wave=0x01, .c_ave=0x30, .c_ksl=0x54, .c_atdec=0xF0, .c_susrel=0xF3, .c_wave=0x01, .feedback=0x0A }, // Acoustic Grand Piano
-    [129] = { .m_ave=0x30, .m_ksl=0x00, .m_atdec=0xF1, .m_susrel=0xF4, .m_wave=0x01, .c_ave=0x30, .c_ksl=0x52, .c_atdec=0xF0, .c_susrel=0xF3, .c_wave=0x00, .feedback=0x0A }, // Bright Acoustic Piano
-    [130] = { .m_ave=0x30, .m_ksl=0x00, .m_atdec=0xF1, .m_susrel=0xF4, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x4E, .c_atdec=0xE1, .c_susrel=0xF3, .c_wave=0x01, .feedback=0x08 }, // Electric Grand Piano
-    [131] = { .m_ave=0x10, .m_ksl=0x00, .m_atdec=0xD1, .m_susrel=0xF4, .m_wave=0x00, .c_ave=0x10, .c_ksl=0x4F, .c_atdec=0xF1, .c_susrel=0x53, .c_wave=0x01, .feedback=0x06 }, // Honky-tonk Piano
-    [132] = { .m_ave=0x31, .m_ksl=0x00, .m_atdec=0xD2, .m_susrel=0xE5, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x66, .c_atdec=0xF1, .c_susrel=0x51, .c_wave=0x00, .feedback=0x06 }, // Rhodes Paino
-    [133] = { .m_ave=0xB0, .m_ksl=0x40, .m_atdec=0xF1, .m_susrel=0xE5, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x51, .c_atdec=0xF1, .c_susrel=0xE6, .c_wave=0x00, .feedback=0x06 }, // Chorused Piano
-    [134] = { .m_ave=0x30, .m_ksl=0x00, .m_atdec=0xC1, .m_susrel=0xF4, .m_wave=0x01, .c_ave=0x30, .c_ksl=0x87, .c_atdec=0xF2, .c_susrel=0x01, .c_wave=0x02, .feedback=0x06 }, // Harpsichord
-    [135] = { .m_ave=0x10, .m_ksl=0x00, .m_atdec=0x91, .m_susrel=0xA7, .m_wave=0x01, .c_ave=0x90, .c_ksl=0x8E, .c_atdec=0xA1, .c_susrel=0x62, .c_wave=0x01, .feedback=0x0C }, // Clavinet
-    [136] = { .m_ave=0x31, .m_ksl=0x00, .m_atdec=0xF2, .m_susrel=0xE4, .m_wave=0x00, .c_ave=0x28, .c_ksl=0x4F, .c_atdec=0xF2, .c_susrel=0x64, .c_wave=0x01, .feedback=0x08 }, // Celesta
-    [137] = { .m_ave=0x14, .m_ksl=0x00, .m_atdec=0x7D, .m_susrel=0x34, .m_wave=0x00, .c_ave=0x13, .c_ksl=0x0E, .c_atdec=0x91, .c_susrel=0x11, .c_wave=0x00, .feedback=0x09 }, // * Glockenspiel
-    [138] = { .m_ave=0x90, .m_ksl=0x00, .m_atdec=0xD2, .m_susrel=0x92, .m_wave=0x00, .c_ave=0xB2, .c_ksl=0x0F, .c_atdec=0xF6, .c_susrel=0x41, .c_wave=0x00, .feedback=0x00 }, // * Music Box
-    [139] = { .m_ave=0xF2, .m_ksl=0x00, .m_atdec=0xF1, .m_susrel=0xF4, .m_wave=0x00, .c_ave=0xF0, .c_ksl=0x02, .c_atdec=0xF1, .c_susrel=0xF3, .c_wave=0x00, .feedback=0x01 }, // Vibraphone
-    [140] = { .m_ave=0x83, .m_ksl=0x00, .m_atdec=0xF8, .m_susrel=0x75, .m_wave=0x02, .c_ave=0x80, .c_ksl=0x00, .c_atdec=0x79, .c_susrel=0x15, .c_wave=0x00, .feedback=0x01 }, // Marimba
-    [141] = { .m_ave=0x10, .m_ksl=0x00, .m_atdec=0xF6, .m_susrel=0x53, .m_wave=0x00, .c_ave=0x14, .c_ksl=0x1F, .c_atdec=0xF6, .c_susrel=0x93, .c_wave=0x00, .feedback=0x08 }, // Xylophone
-    [142] = { .m_ave=0x02, .m_ksl=0x00, .m_atdec=0xFF, .m_susrel=0x13, .m_wave=0x00, .c_ave=0x81, .c_ksl=0x99, .c_atdec=0xB6, .c_susrel=0x13, .c_wave=0x01, .feedback=0x0A }, // * Tubular-bell
-    [143] = { .m_ave=0x11, .m_ksl=0x80, .m_atdec=0x52, .m_susrel=0x53, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x47, .c_atdec=0x91, .c_susrel=0x11, .c_wave=0x00, .feedback=0x08 }, // * Dulcimer
-    [144] = { .m_ave=0x61, .m_ksl=0x80, .m_atdec=0xD1, .m_susrel=0x17, .m_wave=0x01, .c_ave=0xA0, .c_ksl=0x88, .c_atdec=0xB1, .c_susrel=0x16, .c_wave=0x00, .feedback=0x07 }, // Hammond Organ
-    [145] = { .m_ave=0x94, .m_ksl=0x00, .m_atdec=0xF4, .m_susrel=0x36, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x00, .c_atdec=0xF1, .c_susrel=0x05, .c_wave=0x01, .feedback=0x07 }, // Percussive Organ
-    [146] = { .m_ave=0x60, .m_ksl=0x80, .m_atdec=0xFF, .m_susrel=0x07, .m_wave=0x01, .c_ave=0xE2, .c_ksl=0x9E, .c_atdec=0xF2, .c_susrel=0x17, .c_wave=0x00, .feedback=0x00 }, // Rock Organ
-    [147] = { .m_ave=0x31, .m_ksl=0x80, .m_atdec=0x54, .m_susrel=0x14, .m_wave=0x01, .c_ave=0x30, .c_ksl=0x92, .c_atdec=0x30, .c_susrel=0x04, .c_wave=0x00, .feedback=0x09 }, // Church Organ
-    [148] = { .m_ave=0x81, .m_ksl=0x80, .m_atdec=0x60, .m_susrel=0x17, .m_wave=0x01, .c_ave=0x00, .c_ksl=0x49, .c_atdec=0x80, .c_susrel=0x17, .c_wave=0x00, .feedback=0x06 }, // Reed Organ
-    [149] = { .m_ave=0x31, .m_ksl=0x00, .m_atdec=0x41, .m_susrel=0x26, .m_wave=0x01, .c_ave=0x20, .c_ksl=0x48, .c_atdec=0xA2, .c_susrel=0x15, .c_wave=0x00, .feedback=0x0A }, // Accordion
-    [150] = { .m_ave=0xB2, .m_ksl=0x80, .m_atdec=0x42, .m_susrel=0x16, .m_wave=0x00, .c_ave=0xB0, .c_ksl=0x0C, .c_atdec=0x60, .c_susrel=0x34, .c_wave=0x00, .feedback=0x08 }, // Harmonica
-    [151] = { .m_ave=0x31, .m_ksl=0x00, .m_atdec=0x52, .m_susrel=0x05, .m_wave=0x02, .c_ave=0x20, .c_ksl=0x92, .c_atdec=0xF0, .c_susrel=0x05, .c_wave=0x01, .feedback=0x08 }, // Tango Accordion
-    [152] = { .m_ave=0x20, .m_ksl=0x00, .m_atdec=0xF1, .m_susrel=0xF6, .m_wave=0x00, .c_ave=0x20, .c_ksl=0x8D, .c_atdec=0xF1, .c_susrel=0xF5, .c_wave=0x00, .feedback=0x00 }, // Acoustic Guitar (nylon)
-    [153] = { .m_ave=0x30, .m_ksl=0x00, .m_atdec=0xF2, .m_susrel=0xE3, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x0D, .c_atdec=0xE1, .c_susrel=0xE4, .c_wave=0x01, .feedback=0x0A }, // Acoustic Guitar (steel)
-    [154] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF4, .m_susrel=0x88, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x21, .c_atdec=0xF1, .c_susrel=0x1F, .c_wave=0x02, .feedback=0x0A }, // Electric Guitar (jazz)
-    [155] = { .m_ave=0x10, .m_ksl=0x00, .m_atdec=0xD2, .m_susrel=0xE7, .m_wave=0x02, .c_ave=0x10, .c_ksl=0x87, .c_atdec=0xEA, .c_susrel=0x32, .c_wave=0x01, .feedback=0x02 }, // * Electric Guitar (clean)
-    [156] = { .m_ave=0x30, .m_ksl=0x80, .m_atdec=0xF2, .m_susrel=0xF5, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x92, .c_atdec=0xE0, .c_susrel=0xF4, .c_wave=0x00, .feedback=0x00 }, // Electric Guitar (muted)
-    [157] = { .m_ave=0x51, .m_ksl=0x00, .m_atdec=0xF0, .m_susrel=0xFF, .m_wave=0x01, .c_ave=0x10, .c_ksl=0x06, .c_atdec=0xF1, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x02 }, // Overdriven Guitar
-    [158] = { .m_ave=0x51, .m_ksl=0x00, .m_atdec=0xF0, .m_susrel=0xFF, .m_wave=0x01, .c_ave=0x10, .c_ksl=0x0D, .c_atdec=0xF1, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x0C }, // Distortion Guitar
-    [159] = { .m_ave=0x11, .m_ksl=0x00, .m_atdec=0xE1, .m_susrel=0xE7, .m_wave=0x00, .c_ave=0x10, .c_ksl=0x43, .c_atdec=0xA1, .c_susrel=0x97, .c_wave=0x02, .feedback=0x00 }, // * Guitar Harmonics
-    [160] = { .m_ave=0xA2, .m_ksl=0x00, .m_atdec=0xC3, .m_susrel=0xA6, .m_wave=0x00, .c_ave=0x21, .c_ksl=0x0E, .c_atdec=0x94, .c_susrel=0x06, .c_wave=0x00, .feedback=0x02 }, // Acoustic Bass
-    [161] = { .m_ave=0x31, .m_ksl=0x00, .m_atdec=0xF1, .m_susrel=0xF8, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x96, .c_atdec=0xF0, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x0A }, // Electric Bass (finger)
-    [162] = { .m_ave=0x30, .m_ksl=0x80, .m_atdec=0xE1, .m_susrel=0xD6, .m_wave=0x00, .c_ave=0x20, .c_ksl=0x8F, .c_atdec=0xE0, .c_susrel=0x14, .c_wave=0x00, .feedback=0x08 }, // Electric Bass (pick)
-    [163] = { .m_ave=0x10, .m_ksl=0x00, .m_atdec=0x81, .m_susrel=0xF6, .m_wave=0x00, .c_ave=0x10, .c_ksl=0x1A, .c_atdec=0x60, .c_susrel=0x00, .c_wave=0x01, .feedback=0x08 }, // Fretless Bass
-    [164] = { .m_ave=0x31, .m_ksl=0x00, .m_atdec=0xF1, .m_susrel=0x47, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x12, .c_atdec=0xF0, .c_susrel=0xE7, .c_wave=0x02, .feedback=0x00 }, // * Slap Bass 1
-    [165] = { .m_ave=0x31, .m_ksl=0x80, .m_atdec=0xF1, .m_susrel=0xF5, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x90, .c_atdec=0xF0, .c_susrel=0xE5, .c_wave=0x00, .feedback=0x08 }, // Slap Bass 2
-    [166] = { .m_ave=0x30, .m_ksl=0x00, .m_atdec=0xF3, .m_susrel=0xF6, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x0A, .c_atdec=0xF4, .c_susrel=0xF5, .c_wave=0x01, .feedback=0x0A }, // Synth Bass 1
-    [167] = { .m_ave=0x31, .m_ksl=0x00, .m_atdec=0xD2, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x30, .c_ksl=0x15, .c_atdec=0x83, .c_susrel=0x46, .c_wave=0x01, .feedback=0x0A }, // Synth Bass 2
-    [168] = { .m_ave=0xA1, .m_ksl=0x00, .m_atdec=0x61, .m_susrel=0x46, .m_wave=0x01, .c_ave=0x60, .c_ksl=0x17, .c_atdec=0x50, .c_susrel=0x45, .c_wave=0x01, .feedback=0x06 }, // Violin
-    [169] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xFB, .m_susrel=0x46, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xF9, .c_susrel=0x57, .c_wave=0x02, .feedback=0x00 }, // Acoustic Bass Drum
-    [170] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF9, .m_susrel=0x06, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xFA, .c_susrel=0x47, .c_wave=0x00, .feedback=0x06 }, // Acoustic Bass Drum
-    [171] = { .m_ave=0x03, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x78, .m_wave=0x00, .c_ave=0x02, .c_ksl=0x80, .c_atdec=0xFD, .c_susrel=0x67, .c_wave=0x00, .feedback=0x06 }, // Slide Stick
-    [172] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF9, .m_susrel=0x47, .m_wave=0x02, .c_ave=0x0F, .c_ksl=0x05, .c_atdec=0xF7, .c_susrel=0x14, .c_wave=0x02, .feedback=0x0E }, // Acoustic Snare
-    [173] = { .m_ave=0xFF, .m_ksl=0x00, .m_atdec=0xA6, .m_susrel=0xA8, .m_wave=0x02, .c_ave=0xE1, .c_ksl=0x00, .c_atdec=0x88, .c_susrel=0xFB, .c_wave=0x03, .feedback=0x0F }, // Hand Clap
-    [174] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0xFA, .m_wave=0x00, .c_ave=0x06, .c_ksl=0x00, .c_atdec=0xAA, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x0E }, // Electric Snare
-    [175] = { .m_ave=0x03, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x38, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x6C, .c_wave=0x00, .feedback=0x07 }, // Low Floor Tom
-    [176] = { .m_ave=0x0F, .m_ksl=0x00, .m_atdec=0xFB, .m_susrel=0x06, .m_wave=0x03, .c_ave=0x0C, .c_ksl=0x00, .c_atdec=0x98, .c_susrel=0x5E, .c_wave=0x02, .feedback=0x0F }, // Closed High-Hat
-    [177] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x37, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x78, .c_wave=0x00, .feedback=0x07 }, // High Floor Tom
-    [178] = { .m_ave=0x0A, .m_ksl=0x80, .m_atdec=0x8A, .m_susrel=0x2B, .m_wave=0x03, .c_ave=0x0C, .c_ksl=0x00, .c_atdec=0x78, .c_susrel=0x5E, .c_wave=0x02, .feedback=0x0F }, // Pedal High Hat
-    [179] = { .m_ave=0x02, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x37, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x37, .c_wave=0x00, .feedback=0x03 }, // Low Tom
-    [180] = { .m_ave=0x0B, .m_ksl=0x00, .m_atdec=0xF9, .m_susrel=0x33, .m_wave=0x02, .c_ave=0x00, .c_ksl=0x45, .c_atdec=0xC7, .c_susrel=0x01, .c_wave=0x02, .feedback=0x0E }, // Open High Hat
-    [181] = { .m_ave=0x02, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x37, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x37, .c_wave=0x00, .feedback=0x03 }, // Low-Mid Tom
-    [182] = { .m_ave=0x02, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x37, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x37, .c_wave=0x00, .feedback=0x03 }, // High-Mid Tom
-    [183] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xE8, .m_susrel=0x43, .m_wave=0x03, .c_ave=0x04, .c_ksl=0x10, .c_atdec=0xC2, .c_susrel=0xE6, .c_wave=0x00, .feedback=0x0E }, // Crash Cymbal 1
-    [184] = { .m_ave=0x02, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x37, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x37, .c_wave=0x00, .feedback=0x03 }, // High Tom
-    [185] = { .m_ave=0x02, .m_ksl=0x80, .m_atdec=0xFD, .m_susrel=0x05, .m_wave=0x02, .c_ave=0x03, .c_ksl=0x80, .c_atdec=0xFD, .c_susrel=0x12, .c_wave=0x02, .feedback=0x0A }, // Ride Cymbal 1
-    [186] = { .m_ave=0xC0, .m_ksl=0x80, .m_atdec=0xD7, .m_susrel=0x34, .m_wave=0x02, .c_ave=0x00, .c_ksl=0x80, .c_atdec=0xE4, .c_susrel=0x85, .c_wave=0x00, .feedback=0x0E }, // Chinses Cymbal
-    [187] = { .m_ave=0x01, .m_ksl=0x00, .m_atdec=0xB8, .m_susrel=0x44, .m_wave=0x01, .c_ave=0x04, .c_ksl=0x90, .c_atdec=0xE2, .c_susrel=0xE6, .c_wave=0x00, .feedback=0x0E }, // Ride Bell
-    [188] = { .m_ave=0x07, .m_ksl=0x00, .m_atdec=0xC6, .m_susrel=0xA3, .m_wave=0x03, .c_ave=0x04, .c_ksl=0x81, .c_atdec=0x94, .c_susrel=0x70, .c_wave=0x02, .feedback=0x0E }, // Splash Cymbal
-    [189] = { .m_ave=0x01, .m_ksl=0x00, .m_atdec=0xF6, .m_susrel=0x98, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xFD, .c_susrel=0x67, .c_wave=0x00, .feedback=0x06 }, // Cowbell
-    [191] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xE8, .m_susrel=0x43, .m_wave=0x03, .c_ave=0x04, .c_ksl=0x10, .c_atdec=0xC2, .c_susrel=0xE6, .c_wave=0x00, .feedback=0x0E }, // Crash Cymbal 2
-    [192] = { .m_ave=0x1F, .m_ksl=0xC3, .m_atdec=0xF4, .m_susrel=0x04, .m_wave=0x00, .c_ave=0x81, .c_ksl=0x00, .c_atdec=0xF0, .c_susrel=0x00, .c_wave=0x00, .feedback=0x0A }, // Vibraslap
-    [193] = { .m_ave=0x02, .m_ksl=0x80, .m_atdec=0xFD, .m_susrel=0x05, .m_wave=0x02, .c_ave=0x03, .c_ksl=0x80, .c_atdec=0xFD, .c_susrel=0x12, .c_wave=0x02, .feedback=0x0A }, // Ride Cymbal 2
-    [194] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xFA, .m_susrel=0x26, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x02, .feedback=0x04 }, // High Bongo
-    [195] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xFA, .m_susrel=0x26, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x02, .feedback=0x04 }, // Low Bango
-    [196] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x80, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x02, .feedback=0x00 }, // Mute High Conga
-    [197] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x80, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x02, .feedback=0x00 }, // Open High Conga
-    [198] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x80, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x02, .feedback=0x00 }, // Low Conga
-    [199] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x03, .c_ksl=0x81, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x00, .feedback=0x00 }, // High Timbale
-    [200] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x03, .c_ksl=0x81, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x00, .feedback=0x00 }, // Low Timbale
-    [201] = { .m_ave=0x01, .m_ksl=0x00, .m_atdec=0xF6, .m_susrel=0x98, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xFD, .c_susrel=0x67, .c_wave=0x03, .feedback=0x08 }, // High Agogo
-    [202] = { .m_ave=0x01, .m_ksl=0x00, .m_atdec=0xF6, .m_susrel=0x98, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xFD, .c_susrel=0x67, .c_wave=0x03, .feedback=0x08 }, // Low Agogo
-    [203] = { .m_ave=0x0A, .m_ksl=0x80, .m_atdec=0x8A, .m_susrel=0x2B, .m_wave=0x03, .c_ave=0x0C, .c_ksl=0x00, .c_atdec=0x78, .c_susrel=0x5E, .c_wave=0x02, .feedback=0x0F }, // Cabasa
-    [204] = { .m_ave=0xBF, .m_ksl=0xC0, .m_atdec=0xFF, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x0E, .c_atdec=0x5A, .c_susrel=0xD6, .c_wave=0x02, .feedback=0x0A }, // Maracas
-    [205] = { .m_ave=0x12, .m_ksl=0x00, .m_atdec=0xF5, .m_susrel=0x78, .m_wave=0x00, .c_ave=0x13, .c_ksl=0x44, .c_atdec=0xF8, .c_susrel=0xD1, .c_wave=0x01, .feedback=0x06 }, // Claves
-    [206] = { .m_ave=0x12, .m_ksl=0x00, .m_atdec=0xF5, .m_susrel=0x78, .m_wave=0x00, .c_ave=0x13, .c_ksl=0x44, .c_atdec=0xF8, .c_susrel=0xD1, .c_wave=0x01, .feedback=0x06 }, // High Wood Block
-    [207] = { .m_ave=0x12, .m_ksl=0x00, .m_atdec=0xF5, .m_susrel=0x78, .m_wave=0x00, .c_ave=0x13, .c_ksl=0x44, .c_atdec=0xF8, .c_susrel=0xD1, .c_wave=0x01, .feedback=0x06 }, // Low Wood Block
-    [208] = { .m_ave=0xBF, .m_ksl=0xC0, .m_atdec=0xFF, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x0B, .c_atdec=0x5E, .c_susrel=0xDC, .c_wave=0x01, .feedback=0x0A }, // Mute Cuica
-    [209] = { .m_ave=0xD4, .m_ksl=0x80, .m_atdec=0xF4, .m_susrel=0x7A, .m_wave=0x00, .c_ave=0xC5, .c_ksl=0x4F, .c_atdec=0xF2, .c_susrel=0x60, .c_wave=0x00, .feedback=0x08 }, // Mute Triangle
-    [210] = { .m_ave=0x94, .m_ksl=0x80, .m_atdec=0xF2, .m_susrel=0xB7, .m_wave=0x00, .c_ave=0x85, .c_ksl=0x4F, .c_atdec=0xF2, .c_susrel=0x60, .c_wave=0x01, .feedback=0x08 }, // Open Triangle
-    [211] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xFB, .m_susrel=0x46, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xF9, .c_susrel=0x57, .c_wave=0x02, .feedback=0x00 }, // Acoustic Bass Drum
-    [212] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF9, .m_susrel=0x06, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xFA, .c_susrel=0x47, .c_wave=0x00, .feedback=0x06 }, // Acoustic Bass Drum
-    [213] = { .m_ave=0x03, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x78, .m_wave=0x00, .c_ave=0x02, .c_ksl=0x80, .c_atdec=0xFD, .c_susrel=0x67, .c_wave=0x00, .feedback=0x06 }, // Slide Stick
-    [214] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF9, .m_susrel=0x47, .m_wave=0x02, .c_ave=0x0F, .c_ksl=0x05, .c_atdec=0xF7, .c_susrel=0x14, .c_wave=0x02, .feedback=0x0E }, // Acoustic Snare
-    [215] = { .m_ave=0xFF, .m_ksl=0x00, .m_atdec=0xA6, .m_susrel=0xA8, .m_wave=0x02, .c_ave=0xE1, .c_ksl=0x00, .c_atdec=0x88, .c_susrel=0xFB, .c_wave=0x03, .feedback=0x0F }, // Hand Clap
-    [216] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0xFA, .m_wave=0x00, .c_ave=0x06, .c_ksl=0x00, .c_atdec=0xAA, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x0E }, // Electric Snare
-    [217] = { .m_ave=0x03, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x38, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x6C, .c_wave=0x00, .feedback=0x07 }, // Low Floor Tom
-    [218] = { .m_ave=0x0F, .m_ksl=0x00, .m_atdec=0xFB, .m_susrel=0x06, .m_wave=0x03, .c_ave=0x0C, .c_ksl=0x00, .c_atdec=0x98, .c_susrel=0x5E, .c_wave=0x02, .feedback=0x0F }, // Closed High-Hat
-    [219] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x37, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x78, .c_wave=0x00, .feedback=0x07 }, // High Floor Tom
-    [220] = { .m_ave=0x0A, .m_ksl=0x80, .m_atdec=0x8A, .m_susrel=0x2B, .m_wave=0x03, .c_ave=0x0C, .c_ksl=0x00, .c_atdec=0x78, .c_susrel=0x5E, .c_wave=0x02, .feedback=0x0F }, // Pedal High Hat
-    [221] = { .m_ave=0x02, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x37, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x37, .c_wave=0x00, .feedback=0x03 }, // Low Tom
-    [222] = { .m_ave=0x0B, .m_ksl=0x00, .m_atdec=0xF9, .m_susrel=0x33, .m_wave=0x02, .c_ave=0x00, .c_ksl=0x45, .c_atdec=0xC7, .c_susrel=0x01, .c_wave=0x02, .feedback=0x0E }, // Open High Hat
-    [223] = { .m_ave=0x02, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x37, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x37, .c_wave=0x00, .feedback=0x03 }, // Low-Mid Tom
-    [224] = { .m_ave=0x02, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x37, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x37, .c_wave=0x00, .feedback=0x03 }, // High-Mid Tom
-    [225] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xE8, .m_susrel=0x43, .m_wave=0x03, .c_ave=0x04, .c_ksl=0x10, .c_atdec=0xC2, .c_susrel=0xE6, .c_wave=0x00, .feedback=0x0E }, // Crash Cymbal 1
-    [226] = { .m_ave=0x02, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x37, .m_wave=0x01, .c_ave=0x02, .c_ksl=0x00, .c_atdec=0xF5, .c_susrel=0x37, .c_wave=0x00, .feedback=0x03 }, // High Tom
-    [227] = { .m_ave=0x02, .m_ksl=0x80, .m_atdec=0xFD, .m_susrel=0x05, .m_wave=0x02, .c_ave=0x03, .c_ksl=0x80, .c_atdec=0xFD, .c_susrel=0x12, .c_wave=0x02, .feedback=0x0A }, // Ride Cymbal 1
-    [228] = { .m_ave=0xC0, .m_ksl=0x80, .m_atdec=0xD7, .m_susrel=0x34, .m_wave=0x02, .c_ave=0x00, .c_ksl=0x80, .c_atdec=0xE4, .c_susrel=0x85, .c_wave=0x00, .feedback=0x0E }, // Chinses Cymbal
-    [229] = { .m_ave=0x01, .m_ksl=0x00, .m_atdec=0xB8, .m_susrel=0x44, .m_wave=0x01, .c_ave=0x04, .c_ksl=0x90, .c_atdec=0xE2, .c_susrel=0xE6, .c_wave=0x00, .feedback=0x0E }, // Ride Bell
-    [230] = { .m_ave=0x01, .m_ksl=0x00, .m_atdec=0x98, .m_susrel=0x67, .m_wave=0x03, .c_ave=0x02, .c_ksl=0x87, .c_atdec=0x76, .c_susrel=0x77, .c_wave=0x02, .feedback=0x0F }, // Tambourine
-    [231] = { .m_ave=0x07, .m_ksl=0x00, .m_atdec=0xC6, .m_susrel=0xA3, .m_wave=0x03, .c_ave=0x04, .c_ksl=0x81, .c_atdec=0x94, .c_susrel=0x70, .c_wave=0x02, .feedback=0x0E }, // Splash Cymbal
-    [232] = { .m_ave=0x01, .m_ksl=0x00, .m_atdec=0xF6, .m_susrel=0x98, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xFD, .c_susrel=0x67, .c_wave=0x00, .feedback=0x06 }, // Cowbell
-    [233] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xE8, .m_susrel=0x43, .m_wave=0x03, .c_ave=0x04, .c_ksl=0x10, .c_atdec=0xC2, .c_susrel=0xE6, .c_wave=0x00, .feedback=0x0E }, // Crash Cymbal 2
-    [234] = { .m_ave=0x1F, .m_ksl=0xC3, .m_atdec=0xF4, .m_susrel=0x04, .m_wave=0x00, .c_ave=0x81, .c_ksl=0x00, .c_atdec=0xF0, .c_susrel=0x00, .c_wave=0x00, .feedback=0x0A }, // Vibraslap
-    [235] = { .m_ave=0x02, .m_ksl=0x80, .m_atdec=0xFD, .m_susrel=0x05, .m_wave=0x02, .c_ave=0x03, .c_ksl=0x80, .c_atdec=0xFD, .c_susrel=0x12, .c_wave=0x02, .feedback=0x0A }, // Ride Cymbal 2
-    [236] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xFA, .m_susrel=0x26, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x02, .feedback=0x04 }, // High Bongo
-    [237] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xFA, .m_susrel=0x26, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x02, .feedback=0x04 }, // Low Bango
-    [238] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x80, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x02, .feedback=0x00 }, // Mute High Conga
-    [239] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x80, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x02, .feedback=0x00 }, // Open High Conga
-    [240] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x80, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x02, .feedback=0x00 }, // Low Conga
-    [241] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x03, .c_ksl=0x81, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x00, .feedback=0x00 }, // High Timbale
-    [242] = { .m_ave=0x00, .m_ksl=0x00, .m_atdec=0xF7, .m_susrel=0x17, .m_wave=0x00, .c_ave=0x03, .c_ksl=0x81, .c_atdec=0xFB, .c_susrel=0x56, .c_wave=0x00, .feedback=0x00 }, // Low Timbale
-    [243] = { .m_ave=0x01, .m_ksl=0x00, .m_atdec=0xF6, .m_susrel=0x98, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xFD, .c_susrel=0x67, .c_wave=0x03, .feedback=0x08 }, // High Agogo
-    [244] = { .m_ave=0x01, .m_ksl=0x00, .m_atdec=0xF6, .m_susrel=0x98, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x00, .c_atdec=0xFD, .c_susrel=0x67, .c_wave=0x03, .feedback=0x08 }, // Low Agogo
-    [245] = { .m_ave=0x0A, .m_ksl=0x80, .m_atdec=0x8A, .m_susrel=0x2B, .m_wave=0x03, .c_ave=0x0C, .c_ksl=0x00, .c_atdec=0x78, .c_susrel=0x5E, .c_wave=0x02, .feedback=0x0F }, // Cabasa
-    [246] = { .m_ave=0xBF, .m_ksl=0xC0, .m_atdec=0xFF, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x0E, .c_atdec=0x5A, .c_susrel=0xD6, .c_wave=0x02, .feedback=0x0A }, // Maracas
-    [247] = { .m_ave=0x12, .m_ksl=0x00, .m_atdec=0xF5, .m_susrel=0x78, .m_wave=0x00, .c_ave=0x13, .c_ksl=0x44, .c_atdec=0xF8, .c_susrel=0xD1, .c_wave=0x01, .feedback=0x06 }, // Claves
-    [248] = { .m_ave=0x12, .m_ksl=0x00, .m_atdec=0xF5, .m_susrel=0x78, .m_wave=0x00, .c_ave=0x13, .c_ksl=0x44, .c_atdec=0xF8, .c_susrel=0xD1, .c_wave=0x01, .feedback=0x06 }, // High Wood Block
-    [249] = { .m_ave=0x12, .m_ksl=0x00, .m_atdec=0xF5, .m_susrel=0x78, .m_wave=0x00, .c_ave=0x13, .c_ksl=0x44, .c_atdec=0xF8, .c_susrel=0xD1, .c_wave=0x01, .feedback=0x06 }, // Low Wood Block
-    [250] = { .m_ave=0xBF, .m_ksl=0xC0, .m_atdec=0xFF, .m_susrel=0xFF, .m_wave=0x00, .c_ave=0x01, .c_ksl=0x0B, .c_atdec=0x5E, .c_susrel=0xDC, .c_wave=0x01, .feedback=0x0A }, // Mute Cuica
-    [251] = { .m_ave=0xD4, .m_ksl=0x80, .m_atdec=0xF4, .m_susrel=0x7A, .m_wave=0x00, .c_ave=0xC5, .c_ksl=0x4F, .c_atdec=0xF2, .c_susrel=0x60, .c_wave=0x00, .feedback=0x08 }, // Mute Triangle
-    [252] = { .m_ave=0x94, .m_ksl=0x80, .m_atdec=0xF2, .m_susrel=0xB7, .m_wave=0x00, .c_ave=0x85, .c_ksl=0x4F, .c_atdec=0xF2, .c_susrel=0x60, .c_wave=0x01, .feedback=0x08 }, // Open Triangle
-    [253] = { .m_ave=0x00, .m_ksl=0x0D, .m_atdec=0xE8, .m_susrel=0xEF, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xA5, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x06 },
-    [254] = { .m_ave=0x06, .m_ksl=0x00, .m_atdec=0xF0, .m_susrel=0xF0, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xF7, .c_susrel=0xF7, .c_wave=0x00, .feedback=0x0E },
-    [255] = { .m_ave=0x05, .m_ksl=0x00, .m_atdec=0xF0, .m_susrel=0x77, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xFA, .c_susrel=0xEA, .c_wave=0x00, .feedback=0x0E },
-};
+// ============================================================================
+// STANDARD BANK (ROM ASSET)
+// ============================================================================
+// gm_bank.txt is built into the GMBANK asset: 256 patches, then 256 names of
+// GM_NAME_LEN bytes. Keeping it out of the program saves about 6 KB of RAM.
+// user_bank starts as a copy and is what songs play; the standard patches
+// themselves are only read for effects, the pad kit and save comparisons,
+// so a few recently used ones are cached.
 
-const char* const patch_names[256] = {
-    /* 0-127: Standard General MIDI Bank */
-    "Piano 1", "Piano 2", "Piano 3", "Honky-tonk", "E. Piano 1", "E. Piano 2", "Harpsichord", "Clavinet",
-    "Celesta", "Glockenspiel", "Music Box", "Vibraphone", "Marimba", "Xylophone", "Tubular Bell", "Dulcimer",
-    "Drawbar Organ", "Perc. Organ", "Rock Organ", "Church Organ", "Reed Organ", "Accordion", "Harmonica", "Tango Accord.",
-    "Nylon Guitar", "Steel Guitar", "Jazz Guitar", "Clean Guitar", "Muted Guitar", "Overdrive Gtr", "Distortion Gtr", "Gtr Harmonics",
-    "Acoustic Bass", "Finger Bass", "Pick Bass", "Fretless Bass", "Slap Bass 1", "Slap Bass 2", "Synth Bass 1", "Synth Bass 2",
-    "Violin", "Viola", "Cello", "Contrabass", "Tremolo Str.", "Pizzicato Str.", "Harp", "Timpani",
-    "Strings 1", "Strings 2", "Synth Str. 1", "Synth Str. 2", "Choir Aahs", "Voice Oohs", "Synth Voice", "Orchestra Hit",
-    "Trumpet", "Trombone", "Tuba", "Muted Trumpet", "French Horn", "Brass Section", "Synth Brass 1", "Synth Brass 2",
-    "Soprano Sax", "Alto Sax", "Tenor Sax", "Baritone Sax", "Oboe", "English Horn", "Bassoon", "Clarinet",
-    "Piccolo", "Flute", "Recorder", "Pan Flute", "Blown Bottle", "Shakuhachi", "Whistle", "Ocarina",
-    "Square Lead", "Sawtooth Lead", "Calliope Lead", "Chiff Lead", "Charang Lead", "Voice Lead", "Fifths Lead", "Bass+Lead",
-    "New Age Pad", "Warm Pad", "Polysynth Pad", "Choir Pad", "Bowed Pad", "Metallic Pad", "Halo Pad", "Sweep Pad",
-    "Rain FX", "Soundtrack FX", "Crystal FX", "Atmosphere FX", "Brightness FX", "Goblins FX", "Echoes FX", "Sci-Fi FX",
-    "Sitar", "Banjo", "Shamisen", "Koto", "Kalimba", "Bagpipe", "Fiddle", "Shanai",
-    "Tinkle Bell", "Agogo", "Steel Drums", "Woodblock", "Taiko Drum", "Melodic Tom", "Synth Drum", "Reverse Cym.",
-    "Gtr Fret Noise", "Breath Noise", "Seashore", "Bird Tweet", "Teleph. Ring", "Helicopter", "Applause", "Gunshot",
+#define GM_NAMES_OFFSET (256L * sizeof(OPL_Patch))
 
-    /* 128-168: Alternate Melodic Bank (Fixed Names) */
-    "Grand Piano", "Bright Piano", "E. Grand Piano", "Honky-tonk 2", "Rhodes Piano", "Chorused Piano", "Harpsichord 2", "Clavinet 2",
-    "Celesta 2", "Glockenspiel 2", "Music Box 2", "Vibraphone 2", "Marimba 2", "Xylophone 2", "Tubular Bell 2", "Dulcimer 2",
-    "Hammond Organ", "Perc. Organ 2", "Rock Organ 2", "Church Organ 2", "Reed Organ 2", "Accordion 2", "Harmonica 2", "Tango Accord 2",
-    "Nylon Gtr 2", "Steel Gtr 2", "Jazz Gtr 2", "Clean Gtr 2", "Muted Gtr 2", "Overdriven Gtr", "Distortion Gtr 2", "Gtr Harmonics 2",
-    "Acoustic Bass 2", "Finger Bass 2", "Pick Bass 2", "Fretless Bass 2", "Slap Bass 1b", "Slap Bass 2b", "Synth Bass 1b", "Synth Bass 2b",
-    "Violin 2",
+typedef struct {
+    OPL_Patch patch;
+    uint8_t slot;
+    uint8_t stamp;      // gm_clock at the last use
+    bool used;
+} GmCacheEntry;
 
-    /* 169-210: Percussion Bank 1 */
-    "Ac. Bass Drum", "Ac. Bass Drum 2", "Slide Stick", "Ac. Snare", "Hand Clap", "Electric Snare", "Low Floor Tom", "Closed Hi-Hat",
-    "High Floor Tom", "Pedal Hi-Hat", "Low Tom", "Open Hi-Hat", "Low-Mid Tom", "Hi-Mid Tom", "Crash Cymbal 1", "High Tom",
-    "Ride Cymbal 1", "Chinese Cymbal", "Ride Bell", "Splash Cymbal", "Cowbell", "Crash Cymbal 2", "Vibraslap", "Ride Cymbal 2",
-    "High Bongo", "Low Bongo", "Mute Hi Conga", "Open Hi Conga", "Low Conga", "High Timbale", "Low Timbale", "High Agogo",
-    "Low Agogo", "Cabasa", "Maracas", "Claves", "Hi Wood Block", "Low Wood Block", "Mute Cuica", "Mute Triangle", "Open Triangle", "Tambourine",
+static GmCacheEntry gm_cache[GM_CACHE_SIZE];
+static uint8_t gm_clock = 0;
+static int gm_fd = -1;
+static bool gm_missing = false;
 
-    /* 211-252: Percussion Bank 2 (Extended/Repeats) */
-    "Ac. Bass Drum 3", "Side Stick 2", "Ac. Snare 2", "Hand Clap 2", "Elec. Snare 2", "Low Floor Tom 2", "Closed Hi-Hat 2", "High Floor Tom 2",
-    "Pedal Hi-Hat 2", "Low Tom 2", "Open Hi-Hat 2", "Low-Mid Tom 2", "Hi-Mid Tom 2", "Crash Cymbal 1b", "High Tom 2", "Ride Cymbal 1b",
-    "Chinese Cym. 2", "Ride Bell 2", "Splash Cym. 2", "Cowbell 2", "Crash Cym. 2b", "Vibraslap 2", "Ride Cym. 2b", "High Bongo 2",
-    "Low Bongo 2", "Mute Hi Conga 2", "Open Hi Conga 2", "Low Conga 2", "High Timbale 2", "Low Timbale 2", "High Agogo 2", "Low Agogo 2",
-    "Cabasa 2", "Maracas 2", "Claves 2", "Hi Wood Block 2", "Low Wood Block 2", "Mute Cuica 2", "Mute Triangle 2", "Open Triangle 2", "Log Drum", "Castanets",
+static char gm_name[GM_NAME_LEN + 1];
+static uint16_t gm_name_slot = 0xFFFF;  // Slot gm_name holds, 0xFFFF = none
 
-    /* 253-255: Custom Kit */
-    "Bass Drum", "Snare", "Hat"
-};
+// Reads len bytes at offset; a missing asset reads as zeros
+static void gm_read(long offset, void *buf, uint16_t len) {
+    if (gm_fd < 0 && !gm_missing) {
+        gm_fd = open(GM_BANK_FILE, O_RDONLY);
+        if (gm_fd < 0) {
+            gm_missing = true;
+            printf("Error: %s missing, standard patches are silent\n", GM_BANK_FILE);
+        }
+    }
+    if (gm_fd < 0 || lseek(gm_fd, offset, SEEK_SET) < 0 || read(gm_fd, buf, len) != (int)len) {
+        memset(buf, 0, len);
+    }
+}
+
+const OPL_Patch *gm_patch(uint8_t slot) {
+    GmCacheEntry *e = gm_cache;
+    uint8_t oldest = 0;
+
+    for (uint8_t i = 0; i < GM_CACHE_SIZE; i++) {
+        GmCacheEntry *c = &gm_cache[i];
+        if (c->used && c->slot == slot) {
+            c->stamp = ++gm_clock;
+            return &c->patch;
+        }
+        // Victim: a free entry, else the least recently used
+        uint8_t age = c->used ? (uint8_t)(gm_clock - c->stamp) : 0xFF;
+        if (age > oldest || i == 0) {
+            e = c;
+            oldest = age;
+        }
+    }
+
+    gm_read((long)slot * sizeof(OPL_Patch), &e->patch, sizeof(OPL_Patch));
+    e->slot = slot;
+    e->used = true;
+    e->stamp = ++gm_clock;
+    return &e->patch;
+}
+
+// Slot of a patch returned by gm_patch(), or -1 for any other pointer
+static int16_t gm_cache_slot(const OPL_Patch *p) {
+    for (uint8_t i = 0; i < GM_CACHE_SIZE; i++) {
+        if (p == &gm_cache[i].patch) return gm_cache[i].slot;
+    }
+    return -1;
+}
+
+void gm_bank_copy(OPL_Patch *bank) {
+    gm_read(0, bank, 256 * sizeof(OPL_Patch));
+}
+
+const char *patch_name(uint8_t slot) {
+    if (gm_name_slot != slot) {
+        gm_read(GM_NAMES_OFFSET + (long)slot * GM_NAME_LEN, gm_name, GM_NAME_LEN);
+        gm_name[GM_NAME_LEN] = '\0';
+        gm_name_slot = slot;
+    }
+    return gm_name;
+}
+
+// Sets bit n of map for every user_bank slot that differs from the standard
+// bank, reading the asset in order a few patches at a time
+uint16_t patch_edited_map(uint8_t *map) {
+    OPL_Patch chunk[8];
+    uint16_t count = 0;
+
+    memset(map, 0, 32);
+    for (uint16_t i = 0; i < 256; i += 8) {
+        gm_read((long)i * sizeof(OPL_Patch), chunk, sizeof(chunk));
+        for (uint8_t n = 0; n < 8; n++) {
+            if (memcmp(&user_bank[i + n], &chunk[n], sizeof(OPL_Patch)) != 0) {
+                map[(i + n) >> 3] |= (uint8_t)(1 << n);
+                count++;
+            }
+        }
+    }
+    return count;
+}
 
 const OPL_Patch drum_bd    = { .m_ave=0x00, .m_ksl=0x0D, .m_atdec=0xE8, .m_susrel=0xEF, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xA5, .c_susrel=0xFF, .c_wave=0x00, .feedback=0x06 };
 const OPL_Patch drum_snare = { .m_ave=0x06, .m_ksl=0x00, .m_atdec=0xF0, .m_susrel=0xF0, .m_wave=0x00, .c_ave=0x00, .c_ksl=0x00, .c_atdec=0xF7, .c_susrel=0xF7, .c_wave=0x00, .feedback=0x0E };
@@ -335,6 +142,16 @@ void OPL_SetPatch(uint8_t channel, const OPL_Patch* p) {
     OPL_Write(0xE0 + c, p->c_wave);
     OPL_Write(0xC0 + channel, p->feedback);
 
+    // Mirrored playback names the bank slot the patch came from
+    if (midi_out_step) {
+        if (p >= user_bank && p < user_bank + 256) {
+            midi_out_program(channel, (uint8_t)((p - user_bank) >> 7), (uint8_t)((p - user_bank) & 0x7F));
+        } else {
+            int16_t slot = gm_cache_slot(p);
+            if (slot >= 0) midi_out_program(channel, (uint8_t)(slot >> 7), (uint8_t)(slot & 0x7F));
+        }
+    }
+
     // SYNC logic shadows with the new patch data
     shadow_ksl_m[channel] = p->m_ksl & 0xC0;
     shadow_ksl_c[channel] = p->c_ksl & 0xC0;
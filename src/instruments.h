@@ -1,6 +1,8 @@
 #ifndef INSTRUMENTS_H
 #define INSTRUMENTS_H
 
+#include <stdint.h>
+#include <stdbool.h>
 #include "opl.h"
 
 typedef struct {
@@ -9,9 +11,22 @@ typedef struct {
     uint8_t feedback;
 } OPL_Patch;
 
-extern const OPL_Patch gm_bank[];
+// The standard bank and patch names are read from a ROM asset on demand
+// (see gm_bank.txt); user_bank is the song's editable copy in RAM.
+#define GM_BANK_FILE  "ROM:GMBANK"
+#define GM_NAME_LEN   16
+#define GM_CACHE_SIZE 8     // Standard patches kept in RAM
+
 extern OPL_Patch user_bank[256];
-extern const char* const patch_names[];
+
+// Standard patch for a slot. The pointer stays valid until GM_CACHE_SIZE
+// other slots have been fetched, so use it straight away.
+extern const OPL_Patch *gm_patch(uint8_t slot);
+extern void gm_bank_copy(OPL_Patch *bank);
+// Name of a slot, valid until the next call
+extern const char *patch_name(uint8_t slot);
+// Bitmap (32 bytes) of user_bank slots edited away from the standard bank
+extern uint16_t patch_edited_map(uint8_t *map);
 extern const OPL_Patch drum_bd;
 extern const OPL_Patch drum_snare;
 extern const OPL_Patch drum_hihat;
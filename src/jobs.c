@@ -0,0 +1,69 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "jobs.h"
+
+// ============================================================================
+// UI JOB QUEUE
+// ============================================================================
+// A ring of pending jobs, run in order. Each job states its cost up front;
+// jobs_run() stops when the budget is spent or the next vsync has already
+// arrived, but always runs at least one job so the queue keeps moving.
+
+typedef struct {
+    JobFn fn;
+    uint8_t a;
+    uint8_t b;
+    uint8_t cost;
+} Job;
+
+static Job job_ring[JOB_QUEUE_SIZE];
+static uint8_t job_head = 0;    // Next job to run
+static uint8_t job_count = 0;
+
+static Job *job_at(uint8_t n) {
+    return &job_ring[(job_head + n) % JOB_QUEUE_SIZE];
+}
+
+static void job_pop_run(void) {
+    Job j = job_ring[job_head];
+    job_head = (job_head + 1) % JOB_QUEUE_SIZE;
+    job_count--;
+    j.fn(j.a, j.b);
+}
+
+void job_queue(JobFn fn, uint8_t a, uint8_t b, uint8_t cost) {
+    for (uint8_t n = 0; n < job_count; n++) {
+        Job *j = job_at(n);
+        if (j->fn == fn && j->a == a && j->b == b) return;
+    }
+
+    // Full: make room by finishing the oldest job now
+    if (job_count == JOB_QUEUE_SIZE) job_pop_run();
+
+    Job *j = job_at(job_count++);
+    j->fn = fn;
+    j->a = a;
+    j->b = b;
+    j->cost = cost;
+}
+
+void jobs_run(uint8_t vsync_start) {
+    uint8_t spent = 0;
+
+    while (job_count) {
+        uint8_t cost = job_ring[job_head].cost;
+        if (spent && (spent + cost > JOB_FRAME_BUDGET || RIA.vsync != vsync_start)) return;
+        spent += cost;
+        job_pop_run();
+    }
+}
+
+// Runs everything now, for code that needs the screen up to date
+void jobs_flush(void) {
+    while (job_count) job_pop_run();
+}
+
+bool jobs_pending(void) {
+    return job_count != 0;
+}
@@ -0,0 +1,21 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Deferred UI work. Heavy redraws are queued as small jobs and run at the
+// end of the frame, after the sequencer, player and MIDI, while the frame's
+// budget lasts. The rest waits for the next frame.
+#define JOB_QUEUE_SIZE   16
+#define JOB_FRAME_BUDGET 8   // Cost units per frame (1 unit ~ one grid row)
+
+typedef void (*JobFn)(uint8_t a, uint8_t b);
+
+// Queues fn(a, b) unless the same job is already waiting
+extern void job_queue(JobFn fn, uint8_t a, uint8_t b, uint8_t cost);
+extern void jobs_run(uint8_t vsync_start);
+extern void jobs_flush(void);
+extern bool jobs_pending(void);
+
+#endif // JOBS_H
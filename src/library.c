@@ -0,0 +1,185 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include "constants.h"
+#include "input.h"
+#include "instruments.h"
+#include "library.h"
+#include "player.h"
+#include "screen.h"
+#include "song.h"
+#include "undo.h"
+#include "usb_hid_keys.h"
+
+bool is_library_active = false;
+bool is_library_dialog = false;
+
+// ============================================================================
+// INSTRUMENT LIBRARY (.RPI)
+// ============================================================================
+
+#define LIB_HEADER_SIZE 6
+
+static int lib_fd = -1;
+static uint16_t lib_count = 0;
+static uint16_t lib_top = 0;    // First index entry on the page
+static uint16_t lib_sel = 0;    // Highlighted entry
+static char lib_names[LIB_PAGE_SIZE][LIB_NAME_LEN + 1];
+
+static long lib_patch_offset(uint16_t idx) {
+    return LIB_HEADER_SIZE + (long)lib_count * LIB_NAME_LEN + (long)idx * sizeof(OPL_Patch);
+}
+
+static void lib_close(void) {
+    if (lib_fd >= 0) close(lib_fd);
+    lib_fd = -1;
+    is_library_active = false;
+    refresh_all_ui(); // Clear the box and restore the dashboard
+}
+
+// Reads the index entries of the page starting at lib_top
+static void lib_read_page(void) {
+    memset(lib_names, 0, sizeof(lib_names));
+    lseek(lib_fd, LIB_HEADER_SIZE + (long)lib_top * LIB_NAME_LEN, SEEK_SET);
+    for (uint8_t i = 0; i < LIB_PAGE_SIZE && lib_top + i < lib_count; i++) {
+        read(lib_fd, lib_names[i], LIB_NAME_LEN);
+    }
+}
+
+static void lib_draw(void) {
+    const uint8_t box_x = 20, box_y = 10;
+    char line[40];
+
+    draw_string(box_x, box_y,     "+----------------------------------+", HUD_COL_WHITE, HUD_COL_BLUE);
+    draw_string(box_x, box_y + 1, "| INSTRUMENT LIBRARY               |", HUD_COL_WHITE, HUD_COL_BLUE);
+    for (uint8_t i = 0; i < LIB_PAGE_SIZE; i++) {
+        uint16_t idx = lib_top + i;
+        if (idx < lib_count) {
+            snprintf(line, sizeof(line), "| %03u %-12.12s                 |", idx, lib_names[i]);
+        } else {
+            snprintf(line, sizeof(line), "|                                  |");
+        }
+        draw_string(box_x, box_y + 2 + i, line,
+                    (idx == lib_sel) ? HUD_COL_YELLOW : HUD_COL_WHITE,
+                    (idx == lib_sel) ? HUD_COL_SELECT_BG : HUD_COL_BLUE);
+    }
+    snprintf(line, sizeof(line), "| [ENTER] LOAD INTO %02X   [ESC] EXIT |", current_instrument);
+    draw_string(box_x, box_y + 2 + LIB_PAGE_SIZE, line, HUD_COL_WHITE, HUD_COL_BLUE);
+    draw_string(box_x, box_y + 3 + LIB_PAGE_SIZE, "+----------------------------------+", HUD_COL_WHITE, HUD_COL_BLUE);
+}
+
+// Moves the highlight, reading a new index page only when it leaves this one
+static void lib_move(int16_t delta) {
+    int16_t sel = (int16_t)lib_sel + delta;
+    if (sel < 0) sel = 0;
+    if (sel >= (int16_t)lib_count) sel = (int16_t)lib_count - 1;
+    lib_sel = (uint16_t)sel;
+
+    if (lib_sel < lib_top || lib_sel >= lib_top + LIB_PAGE_SIZE) {
+        lib_top = lib_sel - (lib_sel % LIB_PAGE_SIZE);
+        lib_read_page();
+    }
+    lib_draw();
+}
+
+// Pulls one patch from the library into the current instrument slot
+static void lib_load_selected(void) {
+    OPL_Patch p;
+
+    lseek(lib_fd, lib_patch_offset(lib_sel), SEEK_SET);
+    if (read(lib_fd, &p, sizeof(OPL_Patch)) != sizeof(OPL_Patch)) {
+        printf("Error: Library patch %u unreadable\n", lib_sel);
+        return;
+    }
+    undo_record(UNDO_PATCH, current_instrument, 0, (const uint8_t *)&user_bank[current_instrument],
+                (const uint8_t *)&p, sizeof(OPL_Patch));
+    user_bank[current_instrument] = p;
+    mark_song_dirty(DIRTY_PATCHES);
+    select_instrument(current_instrument);
+    OPL_SetPatch(cur_channel, &active_patch);
+    printf("Patch %s -> %02X\n", lib_names[lib_sel - lib_top], current_instrument);
+}
+
+void library_open(const char *filename) {
+    char head[LIB_HEADER_SIZE];
+
+    lib_fd = open(filename, O_RDONLY);
+    if (lib_fd < 0) {
+        printf("Error: Could not open %s\n", filename);
+        return;
+    }
+    if (read(lib_fd, head, sizeof(head)) != sizeof(head) || strncmp(head, "RPI1", 4) != 0) {
+        printf("Error: %s is not an instrument library\n", filename);
+        close(lib_fd);
+        lib_fd = -1;
+        return;
+    }
+    lib_count = (uint8_t)head[4] | ((uint16_t)(uint8_t)head[5] << 8);
+    if (lib_count == 0) {
+        printf("%s is empty\n", filename);
+        close(lib_fd);
+        lib_fd = -1;
+        return;
+    }
+
+    lib_top = 0;
+    lib_sel = 0;
+    lib_read_page();
+    is_library_active = true;
+    lib_draw();
+    printf("Library: %s (%u patches)\n", filename, lib_count);
+}
+
+void library_task(void) {
+    if (key_repeat(KEY_UP))       lib_move(-1);
+    if (key_repeat(KEY_DOWN))     lib_move(1);
+    if (key_repeat(KEY_PAGEUP))   lib_move(-LIB_PAGE_SIZE);
+    if (key_repeat(KEY_PAGEDOWN)) lib_move(LIB_PAGE_SIZE);
+
+    if (key_pressed(KEY_ENTER)) {
+        lib_load_selected();
+        lib_close();
+    } else if (key_pressed(KEY_ESC)) {
+        lib_close();
+    }
+}
+
+// Writes every patch the song changed from the GM bank, named after its slot
+void library_save(const char *filename) {
+    uint8_t edited[32];
+    char name[LIB_NAME_LEN];
+
+    uint16_t count = patch_edited_map(edited);
+    if (count == 0) {
+        printf("No edited patches to save\n");
+        return;
+    }
+
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC);
+    if (fd < 0) {
+        printf("Error: Could not create %s\n", filename);
+        return;
+    }
+
+    write(fd, "RPI1", 4);
+    write(fd, &count, 2);
+    for (uint16_t i = 0; i < 256; i++) {
+        if (!(edited[i >> 3] & (1 << (i & 7)))) continue;
+        // Fixed-width field: NUL-padded, not terminated when full
+        const char *src = patch_name((uint8_t)i);
+        size_t len = strlen(src);
+        memset(name, 0, sizeof(name));
+        memcpy(name, src, len < sizeof(name) ? len : sizeof(name));
+        write(fd, name, sizeof(name));
+    }
+    for (uint16_t i = 0; i < 256; i++) {
+        if (!(edited[i >> 3] & (1 << (i & 7)))) continue;
+        write(fd, &user_bank[i], sizeof(OPL_Patch));
+    }
+    close(fd);
+    printf("Saved: %s (%u patches)\n", filename, count);
+}
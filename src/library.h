@@ -0,0 +1,25 @@
+#ifndef LIBRARY_H
+#define LIBRARY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// .RPI instrument library: many named OPL patches in one file.
+//
+// "RPI1", Patch count (2B)
+// Index: per patch a 12-byte name (zero padded, not terminated when full)
+// Patches: per patch an OPL_Patch (11B), in index order
+//
+// The browser only reads the index page it is showing; a patch's 11 bytes
+// are read when it is picked.
+#define LIB_NAME_LEN  12
+#define LIB_PAGE_SIZE 16   // Index entries on screen at once
+
+extern bool is_library_active;     // Browser is open and owns the keyboard
+extern bool is_library_dialog;     // Filename dialog is for a library
+
+extern void library_open(const char *filename);
+extern void library_save(const char *filename);
+extern void library_task(void);
+
+#endif // LIBRARY_H
@@ -0,0 +1,188 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "instruments.h"
+#include "macros.h"
+#include "opl.h"
+#include "screen.h"
+
+// ============================================================================
+// SEQUENCES
+// ============================================================================
+// A bit per instrument says whether it has any sequence, so notes of plain
+// instruments cost one test. Notes that do have them look them up once, at
+// note-on; after that each frame is a table read per running sequence.
+
+MacroSeq macro_seqs[MACRO_MAX_SEQS];
+uint8_t macro_count = 0;
+
+static uint8_t macro_inst_map[32];  // Bit n: instrument n has sequences
+
+typedef struct {
+    uint8_t seq[MACRO_TYPES];   // Index into macro_seqs, or MACRO_NONE
+    uint8_t pos[MACRO_TYPES];   // Next step; length = finished
+    uint8_t note;
+    uint8_t vol;                // Volume the note was played at
+    uint8_t out_vol;            // Volume last written
+    uint8_t connection;         // Patch feedback bit 0, kept by wave steps
+    int8_t  arp;
+    int16_t pitch;              // Sum of the pitch steps so far
+    bool    released;
+    bool    skip;               // Stepped by macro_note_on() this frame
+    bool    active;
+} MacroChannel;
+
+static MacroChannel macro_ch[9];
+
+void macro_clear(void) {
+    macro_count = 0;
+    memset(macro_inst_map, 0, sizeof(macro_inst_map));
+    for (uint8_t ch = 0; ch < 9; ch++) macro_ch[ch].active = false;
+}
+
+void macro_index(void) {
+    uint8_t kept = 0;
+
+    if (macro_count > MACRO_MAX_SEQS) macro_count = MACRO_MAX_SEQS;
+    memset(macro_inst_map, 0, sizeof(macro_inst_map));
+    for (uint8_t i = 0; i < macro_count; i++) {
+        MacroSeq *m = &macro_seqs[i];
+        if (m->type >= MACRO_TYPES || m->length == 0 || m->length > MACRO_LEN) continue;
+        if (m->loop >= m->length) m->loop = MACRO_NONE;
+        if (m->release >= m->length) m->release = MACRO_NONE;
+        if (kept != i) macro_seqs[kept] = *m;
+        macro_inst_map[m->inst >> 3] |= (uint8_t)(1 << (m->inst & 7));
+        kept++;
+    }
+    macro_count = kept;
+    for (uint8_t ch = 0; ch < 9; ch++) macro_ch[ch].active = false;
+}
+
+// ============================================================================
+// ENGINE
+// ============================================================================
+
+static const uint8_t macro_mod_offsets[] = {0x00,0x01,0x02,0x08,0x09,0x0A,0x10,0x11,0x12};
+static const uint8_t macro_car_offsets[] = {0x03,0x04,0x05,0x0B,0x0C,0x0D,0x13,0x14,0x15};
+
+// Step after pos, or m->length once the sequence has nothing more to play
+static uint8_t macro_advance(const MacroSeq *m, uint8_t pos, bool released) {
+    if (!released && pos == m->release) {
+        // Sustain: repeat the loop if it sits before the release point
+        return (m->loop < m->release) ? m->loop : pos;
+    }
+    if (++pos < m->length) return pos;
+    if (m->loop != MACRO_NONE && (m->release == MACRO_NONE || m->loop > m->release)) return m->loop;
+    return m->length;
+}
+
+static void macro_step(uint8_t ch) {
+    MacroChannel *mc = &macro_ch[ch];
+    bool keyed = (opl_hardware_shadow[0xB0 + ch] & 0x20) != 0;
+    bool pitch_dirty = false;
+
+    // Key went up (note-off, cut, stop or panic): leave the sustain part
+    if (!keyed && !mc->released) {
+        mc->released = true;
+        for (uint8_t t = 0; t < MACRO_TYPES; t++) {
+            if (mc->seq[t] == MACRO_NONE) continue;
+            const MacroSeq *m = &macro_seqs[mc->seq[t]];
+            if (m->release != MACRO_NONE && mc->pos[t] <= m->release) mc->pos[t] = m->release + 1;
+        }
+    }
+
+    for (uint8_t t = 0; t < MACRO_TYPES; t++) {
+        if (mc->seq[t] == MACRO_NONE) continue;
+        const MacroSeq *m = &macro_seqs[mc->seq[t]];
+        uint8_t pos = mc->pos[t];
+        if (pos >= m->length) continue;
+        int8_t v = m->value[pos];
+        mc->pos[t] = macro_advance(m, pos, mc->released);
+
+        switch (t) {
+            case MACRO_VOL: {
+                uint8_t scale = (v < 0) ? 0 : (v > 15) ? 15 : (uint8_t)v;
+                // vol * scale / 15, rounded
+                uint8_t out = (uint8_t)(((uint16_t)mc->vol * scale * 17 + 128) >> 8);
+                if (out != mc->out_vol) {
+                    mc->out_vol = out;
+                    OPL_SetVolume(ch, out << 1);
+                    ch_peaks[ch] = out;
+                }
+                break;
+            }
+            case MACRO_ARP:
+                if (v != mc->arp) {
+                    mc->arp = v;
+                    pitch_dirty = true;
+                }
+                break;
+            case MACRO_PITCH:
+                if (v != 0) {
+                    mc->pitch += v;
+                    if (mc->pitch < -128) mc->pitch = -128;
+                    if (mc->pitch > 127) mc->pitch = 127;
+                    pitch_dirty = true;
+                }
+                break;
+            case MACRO_WAVE:
+                // OPL_Write() drops values the chip already has
+                OPL_Write(0xE0 + macro_mod_offsets[ch], (v >> 2) & 0x03);
+                OPL_Write(0xE0 + macro_car_offsets[ch], v & 0x03);
+                OPL_Write(0xC0 + ch, ((v >> 3) & 0x0E) | mc->connection);
+                break;
+        }
+    }
+
+    // A pitch write keys the note on, so a released note keeps its pitch
+    if (pitch_dirty && keyed) {
+        int16_t note = (int16_t)mc->note + mc->arp;
+        if (note < 0) note = 0;
+        if (note > 127) note = 127;
+        OPL_SetPitch_Fine(ch, (uint8_t)note, (int8_t)mc->pitch);
+    }
+}
+
+void macro_note_on(uint8_t ch, uint8_t inst, uint8_t note, uint8_t vol) {
+    MacroChannel *mc = &macro_ch[ch];
+
+    mc->active = false;
+    if (!(macro_inst_map[inst >> 3] & (1 << (inst & 7)))) return;
+
+    for (uint8_t t = 0; t < MACRO_TYPES; t++) mc->seq[t] = MACRO_NONE;
+    for (uint8_t i = 0; i < macro_count; i++) {
+        const MacroSeq *m = &macro_seqs[i];
+        if (m->inst == inst && mc->seq[m->type] == MACRO_NONE) {
+            mc->seq[m->type] = i;
+            mc->pos[m->type] = 0;
+        }
+    }
+
+    mc->note = note;
+    mc->vol = vol;
+    mc->out_vol = vol;
+    mc->connection = user_bank[inst].feedback & 0x01;
+    mc->arp = 0;
+    mc->pitch = 0;
+    mc->released = false;
+    mc->active = true;
+
+    macro_step(ch);
+    mc->skip = true;
+}
+
+void macro_stop(uint8_t ch) {
+    macro_ch[ch].active = false;
+}
+
+void macro_tick(void) {
+    for (uint8_t ch = 0; ch < 9; ch++) {
+        MacroChannel *mc = &macro_ch[ch];
+        if (!mc->active) continue;
+        if (mc->skip) {
+            mc->skip = false;
+            continue;
+        }
+        macro_step(ch);
+    }
+}
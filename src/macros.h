@@ -0,0 +1,51 @@
+#ifndef MACROS_H
+#define MACROS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Instrument macros: per-frame value sequences that run while a note of the
+// instrument plays, FamiTracker style. An instrument has at most one
+// sequence of each type; a note of it starts them all from step 0.
+//
+// A sequence holds at the release step (or repeats from the loop step, when
+// the loop is before it) until the key goes up, then plays on from the step
+// after it. Past the last step it repeats from the loop step if the loop is
+// after the release point, else holds the last value.
+#define MACRO_VOL       0   // 0-15, scales the note's volume (15 = as played)
+#define MACRO_ARP       1   // Semitones added to the note
+#define MACRO_PITCH     2   // Added to a running fine pitch (8 ~ 1 semitone)
+#define MACRO_WAVE      3   // Bits 0-1 carrier wave, 2-3 modulator wave, 4-6 feedback
+#define MACRO_TYPES     4
+
+#define MACRO_MAX_SEQS  32  // Sequences per song
+#define MACRO_LEN       32  // Steps per sequence
+#define MACRO_NONE      0xFF
+
+typedef struct {
+    uint8_t inst;
+    uint8_t type;
+    uint8_t length;     // Steps used (1-MACRO_LEN)
+    uint8_t loop;       // Step to repeat from, or MACRO_NONE
+    uint8_t release;    // Step held until key-off, or MACRO_NONE
+    int8_t  value[MACRO_LEN];
+} MacroSeq;
+
+// The song's sequences, saved with RPT5/6 files
+extern MacroSeq macro_seqs[MACRO_MAX_SEQS];
+extern uint8_t macro_count;
+
+// Drops every sequence and stops the channels
+extern void macro_clear(void);
+// Checks macro_seqs[0..macro_count) after they are filled in and rebuilds
+// the instrument lookup
+extern void macro_index(void);
+
+// Starts inst's macros on ch for a note just keyed on at vol (0-63).
+// The first step is applied straight away.
+extern void macro_note_on(uint8_t ch, uint8_t inst, uint8_t note, uint8_t vol);
+extern void macro_stop(uint8_t ch);
+// Advances every channel by one frame
+extern void macro_tick(void);
+
+#endif // MACROS_H
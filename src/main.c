@@ -1,14 +1,21 @@
 #include <rp6502.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include "browser.h"
 #include "constants.h"
 #include "input.h"
 #include "instruments.h"
+#include "jobs.h"
+#include "library.h"
+#include "macros.h"
 #include "midi.h"
+#include "midiout.h"
 #include "opl.h"
+#include "patterns.h"
 #include "player.h"
 #include "screen.h"
 #include "song.h"
+#include "sync.h"
 #include "usb_hid_keys.h"
 #include "effects.h"
 
@@ -39,8 +46,22 @@ static void init_graphics(void)
     xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, xram_palette_ptr, 0xFFFF);
     xram0_struct_set(TEXT_CONFIG, vga_mode1_config_t, xram_font_ptr, 0xFFFF);
 
-    // 4 parameters: text mode, 8-bit, config, plane
-    xregn(1, 0, 1, 4, 1, 3, TEXT_CONFIG, 2);
+    // The grid rows get a plane of their own over the same text RAM. With
+    // y_wrap its 32 rows form a ring that follow mode scrolls (see screen.c).
+    xram0_struct_set(GRID_CONFIG, vga_mode1_config_t, x_wrap, 0);
+    xram0_struct_set(GRID_CONFIG, vga_mode1_config_t, y_wrap, 1);
+    xram0_struct_set(GRID_CONFIG, vga_mode1_config_t, x_pos_px, 0);
+    xram0_struct_set(GRID_CONFIG, vga_mode1_config_t, y_pos_px, 0);
+    xram0_struct_set(GRID_CONFIG, vga_mode1_config_t, width_chars, MESSAGE_WIDTH);
+    xram0_struct_set(GRID_CONFIG, vga_mode1_config_t, height_chars, 32);
+    xram0_struct_set(GRID_CONFIG, vga_mode1_config_t, xram_data_ptr,
+                     text_message_addr + GRID_SCREEN_OFFSET * MESSAGE_WIDTH * BYTES_PER_CHAR);
+    xram0_struct_set(GRID_CONFIG, vga_mode1_config_t, xram_palette_ptr, 0xFFFF);
+    xram0_struct_set(GRID_CONFIG, vga_mode1_config_t, xram_font_ptr, 0xFFFF);
+
+    // 6 parameters: text mode, 8-bit, config, plane, first and end scanline
+    xregn(1, 0, 1, 6, 1, 3, TEXT_CONFIG, 2, 0, GRID_SCREEN_OFFSET * 8);
+    xregn(1, 0, 1, 6, 1, 3, GRID_CONFIG, 1, GRID_SCREEN_OFFSET * 8, SCREEN_HEIGHT);
 
     // Clear message buffer to spaces
     for (int i = 0; i < MESSAGE_LENGTH; ++i) message[i] = ' ';
@@ -113,7 +134,7 @@ int main(int argc, char *argv[])
 
     // Default all OPL channels to Piano
     for (uint8_t i = 0; i < 9; i++){
-        OPL_SetPatch(i, &gm_bank[0]);
+        OPL_SetPatch(i, gm_patch(0));
     }
 
     // 5. Load RPT file from command line argument if provided
@@ -144,7 +165,14 @@ int main(int argc, char *argv[])
             printf("PANIC: All notes killed.\n");
         }
 
-        if (is_dialog_active) {
+        if (is_loading) {
+            load_task();     // One chunk per frame; MIDI above stays live
+            update_meters();
+        } else if (is_browser_active) {
+            browser_task();
+        } else if (is_library_active) {
+            library_task();
+        } else if (is_dialog_active) {
             handle_filename_input();
         } else 
         {
@@ -153,12 +181,19 @@ int main(int argc, char *argv[])
                 if (key_pressed(KEY_S)) {
                     is_dialog_active = true;
                     is_saving = true;
+                    is_library_dialog = false;
                     dialog_pos = 0;
                     dialog_buffer[0] = '\0'; // Start with empty string
                 }
                 if (key_pressed(KEY_O)) {
+                    is_library_dialog = false;
+                    browser_open();
+                }
+                if (key_pressed(KEY_L)) {
+                    // Instrument library: browse, or Ctrl+Shift+L to save one
                     is_dialog_active = true;
-                    is_saving = false;
+                    is_saving = is_shift_down();
+                    is_library_dialog = true;
                     dialog_pos = 0;
                     dialog_buffer[0] = '\0';
                 }
@@ -176,12 +211,24 @@ int main(int argc, char *argv[])
 
             // The Sequencer "Heartbeat"
             sequencer_step();
+            sync_task(); // MIDI clock out follows the step just taken
+            midi_out_flush();
 
             player_tick();
+            if (!seq.is_playing) macro_tick(); // Live notes; playback ticks them itself
+
+            // Background save of anything changed (idle frames only)
+            autosave_task();
+
+            // Keep pattern hashes current for Ctrl+D
+            pattern_hash_task();
 
             // Always animate the meters every frame
             update_meters();
 
+            // Follow mode scrolls the grid plane
+            grid_scroll_task();
+
             // Playhead Visuals
             if (play_row != last_p_row || !seq.is_playing) {
                 mark_playhead(play_row);
@@ -207,6 +254,9 @@ int main(int argc, char *argv[])
                 update_dashboard(); 
             }
 
+            // Deferred redraws get whatever is left of the frame
+            jobs_run(vsync_last);
+
         }
 
     }
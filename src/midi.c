@@ -3,15 +3,18 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
+#include "player.h"
+#include "sync.h"
+#include "sysex.h"
 
 // MIDI note entry from a USB MIDI keyboard on MIDI0: in RAW mode.
 // The device delivers plain wire MIDI bytes: channel voice messages
 // (with running status), system common, single-byte real-time messages
 // that may appear anywhere, and System Exclusive. There are no delta times.
+// SysEx data is handed to sysex.c byte by byte as it arrives.
 
 #define MIDI_DEBUG 0
 
-#define MIDI_DEVICE "MIDI0:"
 #define MIDI_RETRY_FRAMES 60 // retry open once per second at 60 fps
 
 static bool midi_off_pending = false;
@@ -52,59 +55,120 @@ static uint8_t midi_data_len(uint8_t status)
     return 0;
 }
 
+// ============================================================================
+// RECEIVE RING
+// ============================================================================
+// Complete messages are queued with the play position they arrived at, then
+// dispatched once the device has been drained. A full ring dispatches its
+// oldest message early so nothing is dropped.
+
+typedef struct {
+    uint8_t status;
+    uint8_t data[2];
+    MidiStamp stamp;
+} MidiMessage;
+
+static MidiMessage midi_ring[MIDI_RING_SIZE];
+static uint8_t midi_ring_head = 0;  // Next message to dispatch
+static uint8_t midi_ring_count = 0;
+static MidiStamp midi_read_stamp;   // Position when the current read began
+
 /**
- * Track the held note from note on/off messages
+ * Hand one message to the player callbacks
  */
-static void midi_handle_message(void)
+static void midi_dispatch(const MidiMessage *m)
 {
-    uint8_t kind = midi_status & 0xF0;
-    uint8_t chan = midi_status & 0x0F;
-    if (kind == 0x90 && midi_data[1]) {
+    uint8_t kind = m->status & 0xF0;
+    uint8_t chan = m->status & 0x0F;
+
+    midi_stamp = m->stamp;
+    if (kind == 0xF0) {
+        // Real-time and Song Position Pointer drive the clock sync
+        switch (m->status) {
+            case 0xF8: sync_clock_in(); break;
+            case 0xFA: sync_start_in(); break;
+            case 0xFB: sync_continue_in(); break;
+            case 0xFC: sync_stop_in(); break;
+            case 0xF2: sync_song_position_in(((uint16_t)m->data[1] << 7) | m->data[0]); break;
+        }
+    } else if (kind == 0x90 && m->data[1]) {
         // Note On: velocity > 0. Note number 0 is the "none" sentinel
         // and is ignored.
-        if (midi_data[0]) {
+        if (m->data[0]) {
 #if MIDI_DEBUG
-            printf("[on %02X %02X]", midi_data[0], midi_data[1]);
+            printf("[on %02X %02X]", m->data[0], m->data[1]);
 #endif
-            midi_process_note_on(chan, midi_data[0], midi_data[1]);
+            midi_process_note_on(chan, m->data[0], m->data[1]);
         }
     } else if (kind == 0x80 || kind == 0x90) {
         // Note Off: 0x80, or 0x90 with velocity 0.
 #if MIDI_DEBUG
-        printf("[off %02X]", midi_data[0]);
+        printf("[off %02X]", m->data[0]);
 #endif
-        midi_process_note_off(chan, midi_data[0]);
+        midi_process_note_off(chan, m->data[0]);
     } else if (kind == 0xB0) {
         // CC Change
 #if MIDI_DEBUG
-        printf("[cc %02X %02X]", midi_data[0], midi_data[1]);
+        printf("[cc %02X %02X]", m->data[0], m->data[1]);
 #endif
-        midi_process_cc(chan, midi_data[0], midi_data[1]);
+        midi_process_cc(chan, m->data[0], m->data[1]);
     } else if (kind == 0xC0) {
         // Program Change
 #if MIDI_DEBUG
-        printf("[pc %02X]", midi_data[0]);
+        printf("[pc %02X]", m->data[0]);
 #endif
-        midi_process_program_change(chan, midi_data[0]);
+        midi_process_program_change(chan, m->data[0]);
     } else if (kind == 0xE0) {
-        // Pitch Bend LSB is midi_data[0], MSB is midi_data[1]
-        midi_process_pitch_bend(chan, ((uint16_t)midi_data[1] << 7) | midi_data[0]);
+        // Pitch Bend LSB is data[0], MSB is data[1]
+        midi_process_pitch_bend(chan, ((uint16_t)m->data[1] << 7) | m->data[0]);
     }
 }
 
+static void midi_dispatch_oldest(void)
+{
+    MidiMessage m = midi_ring[midi_ring_head];
+    midi_ring_head = (midi_ring_head + 1) % MIDI_RING_SIZE;
+    midi_ring_count--;
+    midi_dispatch(&m);
+}
+
+/**
+ * Queue a complete message behind the ones already read
+ */
+static void midi_queue(uint8_t status, uint8_t d0, uint8_t d1)
+{
+    if (midi_ring_count == MIDI_RING_SIZE)
+        midi_dispatch_oldest();
+
+    MidiMessage *m = &midi_ring[(midi_ring_head + midi_ring_count++) % MIDI_RING_SIZE];
+    m->status = status;
+    m->data[0] = d0;
+    m->data[1] = d1;
+    m->stamp = midi_read_stamp;
+}
+
 /**
  * Parse one byte of the raw wire MIDI stream
  */
 static void midi_parse_byte(uint8_t b)
 {
-    if (b >= 0xF8)
-        return; // system real-time: single byte, leaves all state untouched
+    if (b >= 0xF8) {
+        // System real-time: single byte, leaves all parser state untouched.
+        // Clock and transport are queued in order with everything else.
+        if (b == 0xF8 || (b >= 0xFA && b <= 0xFC))
+            midi_queue(b, 0, 0);
+        return;
+    }
 
     if (b & 0x80) {
-        // Status byte (0x80-0xF7).
+        // Status byte (0x80-0xF7). Any of them ends a System Exclusive;
+        // only F7 ends it complete.
+        if (midi_status == 0xF0)
+            sysex_end(b == 0xF7);
         if (b == 0xF0) {
-            // System Exclusive begins; swallow data until any status byte.
+            // System Exclusive begins; its data goes to sysex.c
             midi_status = 0xF0;
+            sysex_begin();
         } else if (b >= 0xF1) {
             // System common (incl. 0xF7 EOX and undefined 0xF4/0xF5):
             // cancels running status. Arm only if it carries data bytes,
@@ -119,15 +183,21 @@ static void midi_parse_byte(uint8_t b)
     }
 
     // Data byte (0x00-0x7F).
-    if (midi_status == 0xF0 || midi_status == 0)
-        return; // inside SysEx, or no status armed: ignore
+    if (midi_status == 0xF0) {
+        sysex_byte(b);
+        return;
+    }
+    if (midi_status == 0)
+        return; // no status armed: ignore
 
     midi_data[midi_have++] = b;
     if (midi_have >= midi_data_len(midi_status)) {
         if (midi_status < 0xF0) {
-            midi_handle_message();
+            midi_queue(midi_status, midi_data[0], midi_data[1]);
             midi_have = 0;   // keep running status armed for the next message
         } else {
+            if (midi_status == 0xF2)
+                midi_queue(0xF2, midi_data[0], midi_data[1]);
             midi_status = 0; // system common does not run on
         }
     }
@@ -155,22 +225,34 @@ void midi_task(void)
 #endif
     }
 
-    n = read_xstack(buf, sizeof(buf), midi_fd);
-    if (n < 0) {
+    // Drain the device so a chord or CC sweep is never cut at one read
+    midi_read_stamp.row = play_row;
+    midi_read_stamp.tick_fp = seq.tick_counter_fp;
+    for (uint8_t reads = 0; reads < MIDI_DRAIN_MAX; reads++) {
+        n = read_xstack(buf, sizeof(buf), midi_fd);
+        if (n < 0) {
 #if MIDI_DEBUG
-        printf("[midi err]\n");
+            printf("[midi err]\n");
 #endif
-        close(midi_fd);
-        midi_fd = -1;
-        midi_retry = 0;
-        midi_status = 0;
-        midi_have = 0;
-        return;
-    }
+            close(midi_fd);
+            midi_fd = -1;
+            midi_retry = 0;
+            if (midi_status == 0xF0)
+                sysex_end(false);
+            midi_status = 0;
+            midi_have = 0;
+            break;
+        }
 #if MIDI_DEBUG
-    for (int i = 0; i < n; i++)
-        printf(" %02X", buf[i]);
+        for (int i = 0; i < n; i++)
+            printf(" %02X", buf[i]);
 #endif
-    for (int i = 0; i < n; i++)
-        midi_parse_byte(buf[i]);
+        for (int i = 0; i < n; i++)
+            midi_parse_byte(buf[i]);
+        if (n < (int)sizeof(buf))
+            break;
+    }
+
+    while (midi_ring_count)
+        midi_dispatch_oldest();
 }
@@ -8,6 +8,8 @@
 // MIDI INPUT SUPPORT
 // ============================================================================
 
+#define MIDI_DEVICE "MIDI0:"
+
 // Event-driven MIDI callbacks (implemented in player.c)
 void midi_process_note_on(uint8_t chan, uint8_t note, uint8_t velocity);
 void midi_process_note_off(uint8_t chan, uint8_t note);
@@ -15,6 +17,19 @@ void midi_process_cc(uint8_t chan, uint8_t cc_num, uint8_t cc_val);
 void midi_process_program_change(uint8_t chan, uint8_t program);
 void midi_process_pitch_bend(uint8_t chan, uint16_t pb_val);
 
+// Where the sequencer was when a message arrived. Stamps are taken when the
+// device is read, so they are as fine as the frame (one tick).
+typedef struct {
+    uint8_t row;        // play_row
+    uint16_t tick_fp;   // seq.tick_counter_fp, 8.8 ticks into the row
+} MidiStamp;
+
+#define MIDI_RING_SIZE 64   // Parsed messages waiting for dispatch
+#define MIDI_DRAIN_MAX 16   // Reads per frame before leaving the rest for next frame
+
+// Stamp of the message being dispatched, for the midi_process_* callbacks
+extern MidiStamp midi_stamp;
+
 // Poll MIDI input, called once per frame
 void midi_task(void);
 
@@ -0,0 +1,233 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "midi.h"
+#include "midiout.h"
+#include "player.h"
+#include "screen.h"
+
+bool midi_out_enabled = false;
+bool midi_out_step = false;
+
+static int out_fd = -1;
+static uint8_t out_users = 0;
+
+// ============================================================================
+// OUTPUT QUEUE
+// ============================================================================
+
+typedef struct {
+    uint8_t status;
+    uint8_t d0;
+    uint8_t d1;
+} OutMessage;
+
+static OutMessage out_queue[MIDI_OUT_QUEUE];
+static uint8_t out_count = 0;
+
+// Queue slot + 1 of a bend or expression message that can still be
+// replaced, 0 = none. A note event on the channel closes them so the order
+// of bends and notes is kept.
+static uint8_t pend_bend[9];
+static uint8_t pend_expr[9];
+
+static void out_send(void) {
+    uint8_t buf[MIDI_OUT_QUEUE * 3];
+    uint8_t running = 0;
+    uint16_t n = 0;
+
+    for (uint8_t i = 0; i < out_count; i++) {
+        OutMessage *m = &out_queue[i];
+        if (m->status >= 0xF8) {
+            buf[n++] = m->status; // Real-time leaves running status alone
+            continue;
+        }
+        if (m->status != running || m->status >= 0xF0) buf[n++] = m->status;
+        running = (m->status < 0xF0) ? m->status : 0;
+        buf[n++] = m->d0;
+        if ((m->status & 0xE0) != 0xC0) buf[n++] = m->d1; // Program/pressure have one
+    }
+    out_count = 0;
+    for (uint8_t ch = 0; ch < 9; ch++) pend_bend[ch] = pend_expr[ch] = 0;
+    if (n && out_fd >= 0) write(out_fd, buf, n);
+}
+
+static void out_queue_msg(uint8_t status, uint8_t d0, uint8_t d1) {
+    if (out_count == MIDI_OUT_QUEUE) out_send();
+    OutMessage *m = &out_queue[out_count++];
+    m->status = status;
+    m->d0 = d0;
+    m->d1 = d1;
+}
+
+// Bend and expression: rewrite the waiting message if there is one
+static void out_queue_merged(uint8_t *pend, uint8_t status, uint8_t d0, uint8_t d1) {
+    if (*pend) {
+        out_queue[*pend - 1].d0 = d0;
+        out_queue[*pend - 1].d1 = d1;
+        return;
+    }
+    out_queue_msg(status, d0, d1);
+    *pend = out_count; // out_send() may have emptied the queue first
+}
+
+static void out_queue_event(uint8_t status, uint8_t ch, uint8_t note, uint8_t vel) {
+    pend_bend[ch] = pend_expr[ch] = 0;
+    out_queue_msg(status | ch, note, vel);
+}
+
+// ============================================================================
+// CHANNEL STATE
+// ============================================================================
+// What the external synth was last told, per channel
+
+static uint8_t out_note[9];         // Sounding note, 0 = none
+static uint8_t out_vel[9];          // Velocity of the sounding note
+static uint8_t out_level[9];        // Latest OPL volume (0-127)
+static uint8_t out_expr[9];         // Expression (CC 11) last queued
+static uint16_t out_bend[9];        // Pitch bend last queued
+static uint16_t out_prog[9];        // Bank << 8 | program, 0xFFFF = unknown
+
+static void reset_channels(void) {
+    for (uint8_t ch = 0; ch < 9; ch++) {
+        out_note[ch] = 0;
+        out_vel[ch] = 0;
+        out_level[ch] = 127;
+        out_expr[ch] = 0xFF;
+        out_bend[ch] = 0xFFFF;
+        out_prog[ch] = 0xFFFF;
+        pend_bend[ch] = pend_expr[ch] = 0;
+    }
+}
+
+static void set_bend(uint8_t ch, int16_t offset32) {
+    int32_t v = 8192 + ((int32_t)offset32 * 8192) / (MIDI_OUT_BEND_RANGE * 32);
+    if (v < 0) v = 0;
+    if (v > 16383) v = 16383;
+    if ((uint16_t)v == out_bend[ch]) return;
+    out_bend[ch] = (uint16_t)v;
+    out_queue_merged(&pend_bend[ch], 0xE0 | ch, v & 0x7F, (v >> 7) & 0x7F);
+}
+
+static void set_expression(uint8_t ch, uint8_t expr) {
+    if (expr > 127) expr = 127;
+    if (expr == out_expr[ch]) return;
+    out_expr[ch] = expr;
+    out_queue_merged(&pend_expr[ch], 0xB0 | ch, 11, expr);
+}
+
+void midi_out_note_on(uint8_t ch, uint8_t note, int16_t detune) {
+    if (note > 127) note = 127;
+    if (out_note[ch]) out_queue_event(0x80, ch, out_note[ch], 0);
+
+    set_bend(ch, detune);
+    set_expression(ch, 127);
+    out_vel[ch] = out_level[ch] ? out_level[ch] : 1;
+    out_note[ch] = note;
+    out_queue_event(0x90, ch, note, out_vel[ch]);
+}
+
+void midi_out_note_off(uint8_t ch) {
+    if (!out_note[ch]) return;
+    out_queue_event(0x80, ch, out_note[ch], 0);
+    out_note[ch] = 0;
+}
+
+// Pitch moves on a held note become bends; past the bend range the note is
+// struck again at the new pitch
+void midi_out_pitch(uint8_t ch, uint8_t note, int16_t detune) {
+    if (!out_note[ch]) return;
+    int16_t offset = ((int16_t)note - out_note[ch]) * 32 + detune;
+    if (offset > MIDI_OUT_BEND_RANGE * 32 || offset < -MIDI_OUT_BEND_RANGE * 32) {
+        midi_out_note_on(ch, note, detune);
+        return;
+    }
+    set_bend(ch, offset);
+}
+
+// Volume changes on a held note become expression, relative to its velocity
+void midi_out_volume(uint8_t ch, uint8_t velocity) {
+    out_level[ch] = velocity;
+    if (out_note[ch]) set_expression(ch, (uint8_t)(((uint16_t)velocity * 127) / out_vel[ch]));
+}
+
+void midi_out_program(uint8_t ch, uint8_t bank, uint8_t program) {
+    uint16_t prog = ((uint16_t)bank << 8) | program;
+    if (prog == out_prog[ch]) return;
+    if ((out_prog[ch] >> 8) != bank) out_queue_event(0xB0, ch, 0, bank);
+    out_prog[ch] = prog;
+    out_queue_event(0xC0, ch, program, 0);
+}
+
+void midi_out_realtime(uint8_t status) {
+    out_queue_msg(status, 0, 0);
+}
+
+void midi_out_song_position(uint16_t pos) {
+    out_queue_msg(0xF2, pos & 0x7F, (pos >> 7) & 0x7F);
+}
+
+void midi_out_sysex(const uint8_t *buf, uint8_t len) {
+    out_send();
+    if (out_fd >= 0) write(out_fd, buf, len);
+}
+
+// ============================================================================
+// DEVICE
+// ============================================================================
+
+static void release_all(void) {
+    for (uint8_t ch = 0; ch < 9; ch++) midi_out_note_off(ch);
+}
+
+void midi_out_flush(void) {
+    if (!seq.is_playing && midi_out_enabled) release_all();
+    if (out_count) out_send();
+}
+
+bool midi_out_open(const char *device) {
+    if (out_users == 0) {
+        out_fd = open(device, O_WRONLY);
+        if (out_fd < 0) {
+            printf("Error: Could not open %s for MIDI out\n", device);
+            return false;
+        }
+        out_count = 0;
+        reset_channels();
+    }
+    out_users++;
+    return true;
+}
+
+void midi_out_close(void) {
+    if (out_users == 0) return;
+    out_send();
+    if (--out_users == 0) {
+        close(out_fd);
+        out_fd = -1;
+    }
+}
+
+void midi_out_toggle(void) {
+    if (midi_out_enabled) {
+        release_all();
+        midi_out_enabled = false;
+        midi_out_close();
+        printf("MIDI out: off\n");
+    } else if (midi_out_open(MIDI_DEVICE)) {
+        // Announce the bend range (RPN 0) on every channel
+        for (uint8_t ch = 0; ch < 9; ch++) {
+            out_queue_msg(0xB0 | ch, 101, 0);
+            out_queue_msg(0xB0 | ch, 100, 0);
+            out_queue_msg(0xB0 | ch, 6, MIDI_OUT_BEND_RANGE);
+            out_queue_msg(0xB0 | ch, 38, 0);
+        }
+        out_send();
+        midi_out_enabled = true;
+        printf("MIDI out: playback on channels 1-9\n");
+    }
+    update_dashboard();
+}
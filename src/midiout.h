@@ -0,0 +1,41 @@
+#ifndef MIDIOUT_H
+#define MIDIOUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// MIDI output. Sequencer playback is mirrored onto MIDI channels 1-9, one
+// per OPL channel, from the same OPL calls that play it; sync.c sends its
+// clock through here too. Messages wait in a queue until the end of the
+// frame. Bend and expression changes to a channel are merged while they
+// wait, then everything goes out with running status in one write.
+#define MIDI_OUT_QUEUE      64
+#define MIDI_OUT_BEND_RANGE 12   // Semitones, announced with RPN 0 on open
+
+extern bool midi_out_enabled;    // Mirror playback (Ctrl+M)
+extern bool midi_out_step;       // True while a mirrored sequencer step runs
+
+// Any writable path works, so a plain file can stand in for MIDI0: in
+// tests. Opens are counted; the device closes with its last user.
+extern bool midi_out_open(const char *device);
+extern void midi_out_close(void);
+extern void midi_out_toggle(void);
+
+// Hooks in opl.c and instruments.c. Pitch offsets are in 1/32 semitone.
+extern void midi_out_note_on(uint8_t ch, uint8_t note, int16_t detune);
+extern void midi_out_note_off(uint8_t ch);
+extern void midi_out_pitch(uint8_t ch, uint8_t note, int16_t detune);
+extern void midi_out_volume(uint8_t ch, uint8_t velocity);
+extern void midi_out_program(uint8_t ch, uint8_t bank, uint8_t program);
+
+// For sync.c
+extern void midi_out_realtime(uint8_t status);
+extern void midi_out_song_position(uint16_t pos);
+
+// Raw bytes (SysEx), sent after everything already queued
+extern void midi_out_sysex(const uint8_t *buf, uint8_t len);
+
+// Once per frame: releases notes if playback stopped, then sends the queue
+extern void midi_out_flush(void);
+
+#endif // MIDIOUT_H
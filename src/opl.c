@@ -9,6 +9,9 @@
 #include "effects.h"
 #include "player.h"
 #include "screen.h"
+#include "voices.h"
+#include "midiout.h"
+#include "macros.h"
 
 
 #ifdef USE_NATIVE_OPL2
@@ -35,13 +38,99 @@ static bool export_pending_valid = false;
 static uint8_t export_pending_reg = 0;
 static uint8_t export_pending_val = 0;
 
+// Stem export: each channel gets its own stream in an EXPORT_STEM_SIZE slice
+// of the export buffer, with its own pending packet and delay counter.
+// Chip-wide registers are copied into every stem.
+bool export_stems = false;
+uint16_t stem_idx[EXPORT_STEMS];
+static uint16_t stem_delay[EXPORT_STEMS];
+static bool stem_pending_valid[EXPORT_STEMS];
+static uint8_t stem_pending_reg[EXPORT_STEMS];
+static uint8_t stem_pending_val[EXPORT_STEMS];
+
+#define STEM_ALL  0xFE  // Register goes to every stem
+#define STEM_NONE 0xFF  // Unused address, nothing to capture
+
+// Channel that owns an OPL2 register
+static uint8_t opl_reg_channel(uint8_t reg) {
+    // Operator slot offset (reg & 0x1F) -> channel, for 0x20-0x95 and 0xE0-0xF5
+    static const uint8_t slot_chan[22] = {
+        0, 1, 2, 0, 1, 2, STEM_NONE, STEM_NONE,
+        3, 4, 5, 3, 4, 5, STEM_NONE, STEM_NONE,
+        6, 7, 8, 6, 7, 8
+    };
+
+    if ((reg >= 0x20 && reg < 0xA0) || reg >= 0xE0) {
+        uint8_t slot = reg & 0x1F;
+        return (slot < 22) ? slot_chan[slot] : STEM_NONE;
+    }
+    if (reg == 0xBD) return STEM_ALL;
+    if (reg >= 0xA0 && reg <= 0xC8) {
+        uint8_t ch = reg & 0x0F;
+        return (ch < 9) ? ch : STEM_NONE;
+    }
+    if ((reg >= 0x01 && reg <= 0x04) || reg == 0x08) return STEM_ALL;
+    return STEM_NONE;
+}
+
+static void stem_write_pending(uint8_t s) {
+    if (!stem_pending_valid[s]) return;
+
+    RIA.addr0 = EXPORT_BUF_XRAM + (uint16_t)s * EXPORT_STEM_SIZE + stem_idx[s];
+    RIA.step0 = 1;
+
+    RIA.rw0 = stem_pending_reg[s];
+    RIA.rw0 = stem_pending_val[s];
+    RIA.rw0 = (uint8_t)(stem_delay[s] & 0xFF);
+    RIA.rw0 = (uint8_t)(stem_delay[s] >> 8);
+
+    stem_idx[s] += 4;
+    stem_pending_valid[s] = false;
+
+    // Slices are small, so write them out as soon as they fill up
+    if (stem_idx[s] >= EXPORT_STEM_SIZE) {
+        export_flush_stem(s);
+    }
+}
+
+static void stem_capture(uint8_t s, uint8_t reg, uint8_t data) {
+    stem_write_pending(s);
+
+    stem_pending_reg[s] = reg;
+    stem_pending_val[s] = data;
+    stem_pending_valid[s] = true;
+    stem_delay[s] = 0;
+}
+
 void OPL_ExportResetPending(void) {
     export_pending_valid = false;
     export_pending_reg = 0;
     export_pending_val = 0;
+
+    for (uint8_t s = 0; s < EXPORT_STEMS; s++) {
+        stem_idx[s] = 0;
+        stem_delay[s] = 0;
+        stem_pending_valid[s] = false;
+    }
+}
+
+// Called once per exported frame
+void OPL_ExportTick(void) {
+    accumulated_delay++;
+    for (uint8_t s = 0; s < EXPORT_STEMS; s++) {
+        stem_delay[s]++;
+    }
 }
 
 void OPL_ExportFlushPending(void) {
+    if (export_stems) {
+        for (uint8_t s = 0; s < EXPORT_STEMS; s++) {
+            stem_write_pending(s);
+            stem_delay[s] = 0;
+        }
+        return;
+    }
+
     if (export_pending_valid) {
         // Point RIA to our staging buffer in XRAM
         RIA.addr0 = EXPORT_BUF_XRAM + export_idx;
@@ -113,8 +202,26 @@ void OPL_Write(uint8_t reg, uint8_t data) {
     // Update the shadow
     opl_hardware_shadow[reg] = data;
 
+    // Key-on changes feed the voice allocator, whoever plays the note
+    if (is_note_onoff_reg) {
+        if (data & 0x20) voice_key_on(reg - 0xB0);
+        else voice_key_off(reg - 0xB0);
+    }
+
     // Intercept for Binary Export
     if (is_exporting) {
+        if (export_stems) {
+            uint8_t ch = opl_reg_channel(reg);
+            if (ch == STEM_ALL) {
+                for (uint8_t s = 0; s < EXPORT_STEMS; s++) {
+                    stem_capture(s, reg, data);
+                }
+            } else if (ch != STEM_NONE) {
+                stem_capture(ch, reg, data);
+            }
+            return;
+        }
+
         // Check if buffer would overflow
         if (export_idx >= (EXPORT_BUF_MAX - EXPORT_BUF_XRAM - 4)) {
             // Buffer full - this shouldn't happen with proper flushing
@@ -187,6 +294,7 @@ void OPL_NoteOn(uint8_t channel, uint8_t midi_note) {
     OPL_Write(0xA0 + channel, freq & 0xFF);
     OPL_Write(0xB0 + channel, b0_value);
     shadow_b0[channel] = b0_value;  // Store FULL value including key-on bit
+    if (midi_out_step) midi_out_note_on(channel, midi_note, 0);
 }
 
 void OPL_SetPitch_Fine(uint8_t channel, uint8_t midi_note, int8_t fine_offset) {
@@ -209,6 +317,7 @@ void OPL_SetPitch_Fine(uint8_t channel, uint8_t midi_note, int8_t fine_offset) {
     OPL_Write(0xB0 + channel, b_val);
     
     shadow_b0[channel] = b_val & 0x1F;
+    if (midi_out_step) midi_out_pitch(channel, midi_note, fine_offset * 4); // 8 steps ~ 1 semitone
 }
 
 void OPL_SetPitch(uint8_t channel, uint8_t midi_note) {
@@ -227,6 +336,7 @@ void OPL_SetPitch(uint8_t channel, uint8_t midi_note) {
     // Preserve key-on bit (bit 5) from shadow
     OPL_Write(0xB0 + channel, block_fnum_high | (shadow_b0[channel] & 0x20));
     shadow_b0[channel] = (shadow_b0[channel] & 0x20) | block_fnum_high;
+    if (midi_out_step) midi_out_pitch(channel, midi_note, 0);
 }
 
 void OPL_NoteOff(uint8_t channel) {
@@ -241,6 +351,7 @@ void OPL_NoteOff(uint8_t channel) {
     
     // Update shadow to reflect key-off state
     shadow_b0[channel] = b0_value;
+    if (midi_out_step) midi_out_note_off(channel);
 }
 
 // Clear all 256 registers correctly
@@ -256,6 +367,7 @@ void OPL_SetVolume(uint8_t chan, uint8_t velocity) {
     // Convert MIDI velocity (0-127) to OPL Total Level (63-0)
     // Formula: 63 - (velocity / 2)
     uint8_t vol = 63 - (velocity >> 1);
+    if (midi_out_step) midi_out_volume(chan, velocity);
     
     static const uint8_t mod_offsets[] = {0x00,0x01,0x02,0x08,0x09,0x0A,0x10,0x11,0x12};
     static const uint8_t car_offsets[] = {0x03,0x04,0x05,0x0B,0x0C,0x0D,0x13,0x14,0x15};
@@ -370,12 +482,17 @@ void OPL_NoteOn_Detuned(uint8_t channel, uint8_t midi_note, int8_t detune) {
     OPL_Write(0xB0 + channel, b_val);
     
     shadow_b0[channel] = b_val & 0x1F;
+    if (midi_out_step) midi_out_note_on(channel, midi_note, detune);
 }
 
 void OPL_Write_Force(uint8_t reg, uint8_t data) {
     // We update the shadow so it stays in sync, 
     // but we DO NOT check it to skip the write.
     opl_hardware_shadow[reg] = data;
+    if (reg >= 0xB0 && reg <= 0xB8) {
+        if (data & 0x20) voice_key_on(reg - 0xB0);
+        else voice_key_off(reg - 0xB0);
+    }
 
 #ifdef USE_NATIVE_OPL2
     RIA.addr1 = OPL_ADDR + reg;
@@ -409,6 +526,7 @@ void OPL_Panic(void) {
         ch_porta[i].active = false;
         ch_retrigger[i].active = false;
         ch_notecut[i].active = false;
+        macro_stop(i);
         
         // 4. Reset internal software trackers
         shadow_b0[i] = 0;
@@ -417,7 +535,7 @@ void OPL_Panic(void) {
 
     // 5. Reset global keyboard memory
     active_midi_note = 0;
-    memset(active_midi_notes, 0, sizeof(active_midi_notes));
+    midi_release_all();
     
     // 6. Reset Effect Shadowing so the next note is forced to send everything
     for (int i = 0; i < 9; i++) last_effect[i] = 0xFFFF;
@@ -23,8 +23,12 @@ extern bool is_exporting;
 extern uint16_t export_idx;
 extern uint16_t accumulated_delay;
 
+extern bool export_stems;
+extern uint16_t stem_idx[];
+
 extern void OPL_ExportFlushPending(void);
 extern void OPL_ExportResetPending(void);
+extern void OPL_ExportTick(void);
 
 extern const uint16_t fnum_table[12];
 
@@ -0,0 +1,353 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include "constants.h"
+#include "patterns.h"
+#include "player.h"
+#include "screen.h"
+#include "song.h"
+#include "undo.h"
+
+// ============================================================================
+// PATTERN CACHE
+// ============================================================================
+// Slot n is XRAM n * PATTERN_SIZE. Each resident logical pattern owns one
+// slot; when all slots are taken the least recently used one is evicted.
+// A dirty slot is written to the swap file first (pattern p at p * 1440),
+// unless it turned out empty. Patterns that were never written and never
+// swapped are empty and page in as zeros.
+
+#define SLOT_NONE  0xFF
+
+#define SLOT_USED  0x01
+#define SLOT_DIRTY 0x02  // XRAM copy differs from the swap file
+
+char pattern_swap_filename[64] = "PATSWAP.TMP";
+
+static uint8_t slot_of[MAX_PATTERNS];           // Logical pattern -> slot + 1, 0 = paged out
+static uint8_t slot_pattern[PATTERN_SLOTS];     // Slot -> logical pattern
+static uint8_t slot_flags[PATTERN_SLOTS];
+static uint16_t slot_stamp[PATTERN_SLOTS];      // LRU clock at last use
+static uint16_t lru_clock = 0;
+static uint8_t swapped[MAX_PATTERNS / 8];       // Pattern has data in the swap file
+static int swap_fd = -1;
+
+// Pattern hashes (see PATTERN HASHES below)
+static uint16_t pat_hash[MAX_PATTERNS];         // Raw bytes
+static uint16_t pat_thash[MAX_PATTERNS];        // Notes relative to pat_base
+static uint8_t pat_base[MAX_PATTERNS];          // First note, 0 = none
+static uint8_t hash_stale[MAX_PATTERNS / 8];
+static uint8_t hash_empty[MAX_PATTERNS / 8];
+
+// Fast path: render_grid() asks for the same pattern hundreds of times
+static uint16_t last_pat = 0xFFFF;
+static uint16_t last_addr = 0;
+
+static bool swap_open(void) {
+    if (swap_fd < 0) {
+        swap_fd = open(pattern_swap_filename, O_RDWR | O_CREAT | O_TRUNC);
+        if (swap_fd < 0) printf("Error: Cannot create %s\n", pattern_swap_filename);
+    }
+    return swap_fd >= 0;
+}
+
+static void swap_transfer(uint8_t pat, uint16_t addr, bool to_swap) {
+    uint16_t total = 0;
+
+    lseek(swap_fd, (long)pat * PATTERN_SIZE, SEEK_SET);
+    while (total < PATTERN_SIZE) {
+        int n = to_swap ? write_xram(addr + total, PATTERN_SIZE - total, swap_fd)
+                      : read_xram(addr + total, PATTERN_SIZE - total, swap_fd);
+        if (n <= 0) break;
+        total += (uint16_t)n;
+    }
+}
+
+static bool slot_is_empty(uint8_t slot) {
+    RIA.addr0 = (uint16_t)slot * PATTERN_SIZE;
+    RIA.step0 = 1;
+    for (uint16_t i = 0; i < PATTERN_SIZE; i++) {
+        if (RIA.rw0) return false;
+    }
+    return true;
+}
+
+static void hash_pattern(uint8_t pat, uint16_t addr);
+
+static void evict(uint8_t slot) {
+    if (!(slot_flags[slot] & SLOT_USED)) return;
+
+    uint8_t pat = slot_pattern[slot];
+    uint8_t bit = (uint8_t)(1 << (pat & 7));
+
+    // Hash while the data is still at hand
+    if (hash_stale[pat >> 3] & bit) hash_pattern(pat, (uint16_t)slot * PATTERN_SIZE);
+
+    if (slot_flags[slot] & SLOT_DIRTY) {
+        if (slot_is_empty(slot)) {
+            swapped[pat >> 3] &= (uint8_t)~bit;
+        } else if (swap_open()) {
+            swap_transfer(pat, (uint16_t)slot * PATTERN_SIZE, true);
+            swapped[pat >> 3] |= bit;
+        }
+    }
+
+    slot_of[pat] = 0;
+    slot_flags[slot] = 0;
+    if (last_pat == pat) last_pat = 0xFFFF;
+}
+
+static uint8_t pick_victim(void) {
+    uint8_t victim = SLOT_NONE;
+    uint16_t oldest = 0;
+
+    for (uint8_t s = 0; s < PATTERN_SLOTS; s++) {
+        if (!(slot_flags[s] & SLOT_USED)) return s;
+        // Never page out what is on screen / playing
+        if (slot_pattern[s] == cur_pattern) continue;
+        uint16_t age = lru_clock - slot_stamp[s];
+        if (victim == SLOT_NONE || age > oldest) {
+            victim = s;
+            oldest = age;
+        }
+    }
+    return victim;
+}
+
+static uint8_t page_in(uint8_t pat) {
+    uint8_t slot = pick_victim();
+    uint16_t addr = (uint16_t)slot * PATTERN_SIZE;
+
+    evict(slot);
+
+    if (swapped[pat >> 3] & (1 << (pat & 7))) {
+        swap_transfer(pat, addr, false);
+    } else {
+        RIA.addr0 = addr;
+        RIA.step0 = 1;
+        for (uint16_t i = 0; i < PATTERN_SIZE; i++) {
+            RIA.rw0 = 0;
+        }
+    }
+
+    slot_of[pat] = slot + 1;
+    slot_pattern[slot] = pat;
+    slot_flags[slot] = SLOT_USED;
+    return slot;
+}
+
+// XRAM address of a logical pattern, paging it in if needed
+uint16_t pattern_slot_addr(uint8_t pat) {
+    if (pat == last_pat) return last_addr;
+
+    uint8_t slot = slot_of[pat] ? slot_of[pat] - 1 : page_in(pat);
+
+    slot_stamp[slot] = ++lru_clock;
+    last_pat = pat;
+    last_addr = (uint16_t)slot * PATTERN_SIZE;
+    return last_addr;
+}
+
+// identity: slots 0-31 hold patterns 0-31 as they are in XRAM now (boot, or
+// about to be bulk-loaded). Otherwise every pattern starts out empty.
+void pattern_cache_reset(bool identity) {
+    memset(slot_of, 0, sizeof(slot_of));
+    memset(swapped, 0, sizeof(swapped)); // Old swap contents are ignored
+    memset(hash_stale, 0xFF, sizeof(hash_stale));
+    for (uint8_t s = 0; s < PATTERN_SLOTS; s++) {
+        slot_stamp[s] = 0;
+        if (identity) {
+            slot_of[s] = s + 1;
+            slot_pattern[s] = s;
+            slot_flags[s] = SLOT_USED | SLOT_DIRTY;
+        } else {
+            slot_flags[s] = 0;
+        }
+    }
+    lru_clock = 0;
+    last_pat = 0xFFFF;
+}
+
+void pattern_cache_mark_dirty(uint8_t pat) {
+    if (slot_of[pat]) slot_flags[slot_of[pat] - 1] |= SLOT_DIRTY;
+    hash_stale[pat >> 3] |= (uint8_t)(1 << (pat & 7));
+}
+
+// False means the pattern is certainly empty (never written, never swapped)
+bool pattern_is_stored(uint8_t pat) {
+    return slot_of[pat] || (swapped[pat >> 3] & (1 << (pat & 7)));
+}
+
+// Page a pattern in ahead of time so the row it starts on doesn't stall
+void pattern_prefetch(uint8_t pat) {
+    if (!slot_of[pat]) pattern_slot_addr(pat);
+}
+
+// ============================================================================
+// PATTERN HASHES
+// ============================================================================
+// Every pattern carries two 16-bit hashes: one of its raw bytes, and one with
+// each note taken relative to the pattern's first note, so transposed copies
+// collide as well. Edits mark the hashes stale; pattern_hash_task() refreshes
+// one resident pattern per frame and eviction hashes a pattern on its way out,
+// so a dedupe pass rarely has to read anything. A hash match only nominates a
+// candidate: duplicates are always confirmed byte for byte.
+
+#define HASH_SEED 5381
+
+static void hash_pattern(uint8_t pat, uint16_t addr) {
+    uint16_t h = HASH_SEED;
+    uint16_t t = HASH_SEED;
+    uint8_t base = 0;
+    uint8_t col = 0; // Byte within the 5-byte cell, 0 = note
+    bool empty = true;
+    uint8_t bit = (uint8_t)(1 << (pat & 7));
+
+    RIA.addr0 = addr;
+    RIA.step0 = 1;
+    for (uint16_t i = 0; i < PATTERN_SIZE; i++) {
+        uint8_t b = RIA.rw0;
+        uint8_t tb = b;
+
+        if (b) empty = false;
+        if (col == 0 && b != 0 && b != 255) {
+            if (!base) base = b;
+            tb = (uint8_t)(b - base);
+        }
+        h = (uint16_t)((h << 5) + h) ^ b;
+        t = (uint16_t)((t << 5) + t) ^ tb;
+        if (++col == 5) col = 0;
+    }
+
+    pat_hash[pat] = h;
+    pat_thash[pat] = t;
+    pat_base[pat] = base;
+    if (empty) hash_empty[pat >> 3] |= bit;
+    else hash_empty[pat >> 3] &= (uint8_t)~bit;
+    hash_stale[pat >> 3] &= (uint8_t)~bit;
+}
+
+// Brings a pattern's hashes up to date, paging it in if it has to
+static void hash_refresh(uint8_t pat) {
+    uint8_t bit = (uint8_t)(1 << (pat & 7));
+
+    if (!(hash_stale[pat >> 3] & bit)) return;
+    if (!pattern_is_stored(pat)) {
+        hash_empty[pat >> 3] |= bit;
+        hash_stale[pat >> 3] &= (uint8_t)~bit;
+        return;
+    }
+    hash_pattern(pat, pattern_slot_addr(pat));
+}
+
+// Rehash at most one stale pattern per frame. Paged-out patterns are left for
+// eviction or the next dedupe pass, so this never touches the disk.
+void pattern_hash_task(void) {
+    static uint8_t next = 0;
+
+    for (uint16_t n = 0; n < MAX_PATTERNS; n++) {
+        uint8_t pat = next++;
+        if (!(hash_stale[pat >> 3] & (1 << (pat & 7)))) continue;
+        if (slot_of[pat]) {
+            hash_pattern(pat, (uint16_t)(slot_of[pat] - 1) * PATTERN_SIZE);
+            return;
+        }
+        if (!pattern_is_stored(pat)) {
+            hash_refresh(pat);
+            return;
+        }
+    }
+}
+
+// Byte compare of two patterns, with notes in a offset by shift from b's
+static bool patterns_match(uint8_t a, uint8_t b, uint8_t shift) {
+    uint16_t addr_b = pattern_slot_addr(b);
+    uint16_t addr_a = pattern_slot_addr(a); // b was just used, so it stays
+    uint8_t col = 0;
+
+    RIA.addr0 = addr_a;
+    RIA.step0 = 1;
+    RIA.addr1 = addr_b;
+    RIA.step1 = 1;
+    for (uint16_t i = 0; i < PATTERN_SIZE; i++) {
+        uint8_t va = RIA.rw0;
+        uint8_t vb = RIA.rw1;
+        if (col == 0 && vb != 0 && vb != 255) vb += shift;
+        if (va != vb) return false;
+        if (++col == 5) col = 0;
+    }
+    return true;
+}
+
+static void clear_pattern(uint8_t pat) {
+    undo_record_pattern(pat, NULL);
+    RIA.addr0 = pattern_slot_addr(pat);
+    RIA.step0 = 1;
+    for (uint16_t i = 0; i < PATTERN_SIZE; i++) {
+        RIA.rw0 = 0;
+    }
+    mark_pattern_dirty(pat);
+}
+
+// Finds patterns that repeat an earlier one exactly or transposed. With merge
+// set, the order list is pointed at the first copy of each exact duplicate and
+// the duplicates are cleared, so they no longer take up space in saved songs.
+// Transposed copies are only listed: the order list has no transpose column.
+void pattern_dedupe(bool merge) {
+    uint8_t same = 0, transposed = 0;
+    uint8_t merged_into[MAX_PATTERNS]; // Exact duplicate -> first copy, else itself
+
+    for (uint16_t p = 0; p < MAX_PATTERNS; p++) {
+        hash_refresh((uint8_t)p);
+        merged_into[p] = (uint8_t)p;
+    }
+
+    for (uint16_t p = 1; p < MAX_PATTERNS; p++) {
+        if (hash_empty[p >> 3] & (1 << (p & 7))) continue;
+
+        for (uint16_t q = 0; q < p; q++) {
+            if (merged_into[q] != q || pat_hash[p] != pat_hash[q]) continue;
+            if (patterns_match((uint8_t)p, (uint8_t)q, 0)) {
+                printf("Pattern %02X = %02X\n", (uint8_t)p, (uint8_t)q);
+                merged_into[p] = (uint8_t)q;
+                same++;
+                break;
+            }
+        }
+        if (merged_into[p] != p) continue;
+
+        for (uint16_t q = 0; q < p; q++) {
+            if (merged_into[q] != q || pat_thash[p] != pat_thash[q] ||
+                pat_base[p] == pat_base[q]) continue;
+            uint8_t shift = (uint8_t)(pat_base[p] - pat_base[q]);
+            if (patterns_match((uint8_t)p, (uint8_t)q, shift)) {
+                printf("Pattern %02X = %02X %+d\n", (uint8_t)p, (uint8_t)q, (int8_t)shift);
+                transposed++;
+                break;
+            }
+        }
+    }
+
+    printf("Dedupe: %u duplicate, %u transposed\n", same, transposed);
+    if (!merge || !same) return;
+
+    // One Ctrl+Z restores the whole merge, unless it is too big for the
+    // undo ring; then none of it can be undone
+    undo_group_begin();
+    for (uint16_t i = 0; i < song_length; i++) {
+        uint8_t pat = read_order_xram((uint8_t)i);
+        if (merged_into[pat] != pat) write_order_xram((uint8_t)i, merged_into[pat]);
+    }
+    for (uint16_t p = 0; p < MAX_PATTERNS; p++) {
+        if (merged_into[p] != p) clear_pattern((uint8_t)p);
+    }
+    bool undoable = undo_group_end();
+    if (merged_into[cur_pattern] != cur_pattern) cur_pattern = merged_into[cur_pattern];
+
+    printf("Merged %u patterns%s\n", same, undoable ? "" : " (cannot be undone)");
+    refresh_all_ui();
+}
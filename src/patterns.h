@@ -0,0 +1,25 @@
+#ifndef PATTERNS_H
+#define PATTERNS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Pattern cache: songs address MAX_PATTERNS logical patterns, but only
+// PATTERN_SLOTS of them live in XRAM ($0000-$B3FF) at any time. The rest are
+// paged out to a swap file on USB and brought back on demand.
+#define PATTERN_SLOTS        32
+#define PATTERN_PREFETCH_ROW 24  // Song mode pages in the next order's pattern here
+
+extern char pattern_swap_filename[64];
+
+extern uint16_t pattern_slot_addr(uint8_t pat);
+extern void pattern_cache_reset(bool identity);
+extern void pattern_cache_mark_dirty(uint8_t pat);
+extern bool pattern_is_stored(uint8_t pat);
+extern void pattern_prefetch(uint8_t pat);
+
+// Duplicate detection (content hashes, kept current as patterns change)
+extern void pattern_hash_task(void);
+extern void pattern_dedupe(bool merge);
+
+#endif // PATTERNS_H
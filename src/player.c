@@ -11,6 +11,12 @@
 #include "instruments.h"
 #include "song.h"
 #include "effects.h"
+#include "patterns.h"
+#include "undo.h"
+#include "sync.h"
+#include "voices.h"
+#include "midiout.h"
+#include "macros.h"
 
 
 // Unity (1.0) is 256. 
@@ -43,6 +49,12 @@ bool midi_polyphonic = false;
 uint8_t active_midi_notes[9] = {0};
 static uint8_t midi_held_count = 0;
 static uint8_t active_midi_note_rows[9] = {0};
+MidiStamp midi_stamp;                   // Set by midi.c before each callback
+
+// Channels recorded early onto the row about to play. Its trigger leaves
+// them alone so the take is neither cleared by overwrite nor played twice.
+static uint16_t rec_ahead_mask = 0;
+static uint8_t rec_ahead_row = 0;
 
 OPL_Patch active_patch;
 static uint16_t current_pitch_bend = 8192;
@@ -53,11 +65,13 @@ static char export_filename[16] = {0};
 static int export_fd = -1;
 static uint32_t export_total_bytes = 0;
 static bool export_song_ended = false;
+static int stem_fd[EXPORT_STEMS];
+static uint32_t stem_total_bytes[EXPORT_STEMS];
 
 uint16_t get_pattern_xram_addr(uint8_t pat, uint8_t row, uint8_t chan) {
-    // addr = (pat * 1440) + (row * 45) + (chan * 5)
-    // 1440 is 0x05A0
-    uint16_t p_off = (uint16_t)pat * 1440U;
+    // addr = (slot * 1440) + (row * 45) + (chan * 5)
+    // The pattern cache maps the logical pattern to its XRAM slot
+    uint16_t p_off = pattern_slot_addr(pat);
     // 45 is 0x2D
     uint16_t r_off = (uint16_t)row * 45U;
     
@@ -70,10 +84,6 @@ static bool clipboard_full = false;
 // Initialize: 150 BPM = 6.0 ticks/row in 8.8 fixed-point = 0x0600 (1536)
 SequencerState seq = {false, 0x0600, 0, 150};
 
-#define KEY_REPEAT_DELAY 20 // Frames before repeat starts
-#define KEY_REPEAT_RATE  4  // Frames between repeats
-uint8_t repeat_timer = 0;
-uint8_t last_scancode = 0;
 
 // Piano Mapping: Scancode -> MIDI Offset from C
 // (0 = C, 1 = C#, 2 = D, etc.)
@@ -108,7 +118,10 @@ void select_instrument(uint8_t inst_idx) {
 }
 
 void player_init(void) {
-    memcpy(user_bank, gm_bank, sizeof(user_bank));
+    pattern_cache_reset(true); // Slots 0-31 start as patterns 0-31
+    undo_reset();
+    gm_bank_copy(user_bank);
+    macro_clear();
     select_instrument(0);
 }
 
@@ -151,6 +164,19 @@ static void flush_export_buffer(void) {
     export_idx = 0;
 }
 
+static uint16_t stem_buf_addr(uint8_t s) {
+    return EXPORT_BUF_XRAM + (uint16_t)s * EXPORT_STEM_SIZE;
+}
+
+// Called by the OPL capture whenever a stem's slice of the buffer fills up
+void export_flush_stem(uint8_t s) {
+    if (stem_idx[s] == 0) return;
+
+    write_xram(stem_buf_addr(s), stem_idx[s], stem_fd[s]);
+    stem_total_bytes[s] += stem_idx[s];
+    stem_idx[s] = 0;
+}
+
 static void derive_export_filename(void) {
     // Start with the active tracker filename
     if (active_filename[0] == '\0') {
@@ -171,11 +197,40 @@ static void derive_export_filename(void) {
     }
 }
 
-static void start_export(void) {
+// Stem names keep 8.3: up to 6 chars of the song name + "_<channel>.BIN"
+static void derive_stem_filename(char *out, uint8_t s) {
+    uint8_t len = (uint8_t)(strchr(export_filename, '.') - export_filename);
+    if (len > 6) len = 6;
+
+    memcpy(out, export_filename, len);
+    out[len] = '_';
+    out[len + 1] = '0' + s;
+    strcpy(out + len + 2, ".BIN");
+}
+
+static bool open_stem_files(void) {
+    char name[16];
+
+    for (uint8_t s = 0; s < EXPORT_STEMS; s++) {
+        derive_stem_filename(name, s);
+        stem_fd[s] = open(name, O_WRONLY | O_CREAT | O_TRUNC);
+        stem_total_bytes[s] = 0;
+        if (stem_fd[s] < 0) {
+            printf("Error: Cannot create %s\n", name);
+            while (s--) close(stem_fd[s]);
+            return false;
+        }
+    }
+    printf("Export to: %s .. _8.BIN\n", export_filename);
+    return true;
+}
+
+static bool start_export(bool stems) {
     printf("Starting export...\n");
 
     // Initialize export state FIRST so OPL_Init is captured
     is_exporting = true;
+    export_stems = stems;
     export_idx = 0;
     accumulated_delay = 0;
     export_total_bytes = 0;
@@ -184,17 +239,28 @@ static void start_export(void) {
     // Reset pending export packet logic
     OPL_ExportResetPending();
 
-    OPL_Init(); // Reset OPL state and capture it to the file
-    
-    // Derive filename
     derive_export_filename();
-    printf("Export to: %s\n", export_filename);
+
+    // Stem slices flush as they fill, so their files must be open before
+    // OPL_Init starts producing packets
+    if (stems && !open_stem_files()) {
+        is_exporting = false;
+        export_stems = false;
+        return false;
+    }
+
+    OPL_Init(); // Reset OPL state and capture it to the file
     
-    // Open file for writing
-    export_fd = open(export_filename, O_WRONLY | O_CREAT | O_TRUNC);
-    if (export_fd < 0) {
-        printf("Error: Cannot create export file\n");
-        return;
+    if (!stems) {
+        printf("Export to: %s\n", export_filename);
+
+        // Open file for writing
+        export_fd = open(export_filename, O_WRONLY | O_CREAT | O_TRUNC);
+        if (export_fd < 0) {
+            printf("Error: Cannot create export file\n");
+            is_exporting = false;
+            return false;
+        }
     }
     
     // Force song mode and reset to beginning
@@ -225,39 +291,35 @@ static void start_export(void) {
     cur_pattern = read_order_xram(cur_order_idx);
     
     printf("Exporting song...\n");
+    return true;
 }
 
-static void finish_export(void) {
-    // 1. Wipe the OPL2 registers so hanging notes don't bleed into the loop
-    OPL_Clear();
-    
-    // Flush the very last pending packet emitted by OPL_Clear
-    OPL_ExportFlushPending();
-    
+// Terminate one stream: end marker, 512-byte padding, close.
+// The caller leaves at least 4 free bytes at buf + idx.
+static uint32_t end_export_stream(int fd, uint16_t buf, uint16_t buf_size,
+                                  uint16_t idx, uint32_t total) {
     // Write end marker: 0xFF, 0xFF, 0x00, 0x00
-    if (export_idx >= (EXPORT_CHUNK - 4)) {
-        flush_export_buffer();
-    }
-    
-    RIA.addr0 = EXPORT_BUF_XRAM + export_idx;
+    RIA.addr0 = buf + idx;
     RIA.step0 = 1;
     RIA.rw0 = 0xFF;
     RIA.rw0 = 0xFF;
     RIA.rw0 = 0x00;
     RIA.rw0 = 0x00;
-    export_idx += 4;
+    idx += 4;
     
     // Flush remaining data
-    flush_export_buffer();
+    write_xram(buf, idx, fd);
+    total += idx;
     
     // Pad to 512-byte boundary
-    uint16_t remainder = export_total_bytes % 512;
+    uint16_t remainder = total % 512;
     if (remainder != 0) {
         uint16_t padding = 512 - remainder;
         
         // Fill buffer with end markers
-        uint16_t pad_repeats = padding / 4;
-        RIA.addr0 = EXPORT_BUF_XRAM;
+        uint16_t fill = (padding < buf_size) ? padding : buf_size;
+        uint16_t pad_repeats = fill / 4;
+        RIA.addr0 = buf;
         RIA.step0 = 1;
         for (uint16_t i = 0; i < pad_repeats; i++) {
             RIA.rw0 = 0xFF; // Reg
@@ -266,21 +328,70 @@ static void finish_export(void) {
             RIA.rw0 = 0x00; // Delay Hi
         }
         
-        // Write padding
-        write_xram(EXPORT_BUF_XRAM, padding, export_fd);
-        export_total_bytes += padding;
+        // Write padding (in several pieces if it is larger than the buffer)
+        total += padding;
+        while (padding) {
+            uint16_t n = (padding < fill) ? padding : fill;
+            write_xram(buf, n, fd);
+            padding -= n;
+        }
     }
     
     // Close file
-    close(export_fd);
-    export_fd = -1;
+    close(fd);
+    return total;
+}
+
+static void finish_export(void) {
+    // 1. Wipe the OPL2 registers so hanging notes don't bleed into the loop
+    OPL_Clear();
+    
+    // Flush the very last pending packet emitted by OPL_Clear
+    OPL_ExportFlushPending();
+    
+    if (export_stems) {
+        export_total_bytes = 0;
+        for (uint8_t s = 0; s < EXPORT_STEMS; s++) {
+            if (stem_idx[s] > EXPORT_STEM_SIZE - 4) {
+                export_flush_stem(s);
+            }
+            stem_total_bytes[s] = end_export_stream(stem_fd[s], stem_buf_addr(s), EXPORT_STEM_SIZE,
+                                                    stem_idx[s], stem_total_bytes[s]);
+            stem_fd[s] = -1;
+            export_total_bytes += stem_total_bytes[s];
+        }
+    } else {
+        if (export_idx >= (EXPORT_CHUNK - 4)) {
+            flush_export_buffer();
+        }
+        export_total_bytes = end_export_stream(export_fd, EXPORT_BUF_XRAM, EXPORT_BUF_MAX - EXPORT_BUF_XRAM,
+                                               export_idx, export_total_bytes);
+        export_idx = 0;
+        export_fd = -1;
+    }
     
     // Reset export state
     is_exporting = false;
     seq.is_playing = false;
     
     printf("Export complete: %lu bytes\n", (unsigned long)export_total_bytes);
-    printf("File: %s\n", export_filename);
+    if (export_stems) {
+        printf("Files: %u stems\n", EXPORT_STEMS);
+    } else {
+        printf("File: %s\n", export_filename);
+    }
+    export_stems = false;
+}
+
+// Bytes written so far by the longest stream, for the runaway-song guard
+static uint32_t export_bytes_written(void) {
+    if (!export_stems) return export_total_bytes;
+
+    uint32_t longest = 0;
+    for (uint8_t s = 0; s < EXPORT_STEMS; s++) {
+        if (stem_total_bytes[s] > longest) longest = stem_total_bytes[s];
+    }
+    return longest;
 }
 
 static void process_per_frame_effects(void) {
@@ -296,6 +407,7 @@ static void process_per_frame_effects(void) {
         process_finepitch_logic(ch);
         process_gen_logic(ch);
     }
+    macro_tick(); // After the effects, so instrument macros have the last word
 }
 
 static void export_loop(void) {
@@ -305,15 +417,16 @@ static void export_loop(void) {
     
     // Run sequencer until song ends
     while (is_exporting) {
-        // Increment delay counter each frame
-        accumulated_delay++;
+        // Increment delay counters each frame
+        OPL_ExportTick();
         
         // Run sequencer step — this already runs all per-frame effects in Phase B
         // (arp, portamento, vibrato, notecut, etc.), exactly as live playback does.
         sequencer_step();
         
         // Check if buffer is getting full (leave room for end marker)
-        if (export_idx >= (EXPORT_CHUNK - 8)) {
+        // Stem slices flush themselves as they fill.
+        if (!export_stems && export_idx >= (EXPORT_CHUNK - 8)) {
             flush_export_buffer();
         }
         
@@ -329,7 +442,7 @@ static void export_loop(void) {
         }
         
         // Safety: prevent infinite loop (max ~10 minutes at 60fps)
-        if (export_total_bytes > 36000) {
+        if (export_bytes_written() > 36000) {
             printf("Warning: Export size limit reached\n");
             finish_export();
             break;
@@ -337,6 +450,29 @@ static void export_loop(void) {
     }
 }
 
+// Render the whole song to a .BIN register stream named after active_filename.
+// With stems set, a single pass writes one stream per channel instead.
+void export_song(bool stems) {
+    if (start_export(stems)) {
+        export_loop();
+    }
+}
+
+static uint8_t piano_key = 0;   // Scancode of the piano key sounding, 0 = none
+
+// After the sounding key is released: any other piano key still down? Only
+// the non-zero keystate bytes are looked at.
+static uint8_t find_held_piano_key(void) {
+    for (uint8_t i = 0; i < KEYBOARD_BYTES; i++) {
+        if (!keystates[i]) continue;
+        for (uint8_t b = 0; b < 8; b++) {
+            uint8_t k = (uint8_t)((i << 3) | b);
+            if ((keystates[i] & (1 << b)) && get_semitone(k) != -1) return k;
+        }
+    }
+    return 0;
+}
+
 void player_tick(void) {
     uint8_t channel = cur_channel; // Map piano to the active grid channel
     bool note_pressed_this_frame = false;
@@ -344,6 +480,19 @@ void player_tick(void) {
     uint8_t semitone = 0;
     uint8_t live_volume = current_volume;
 
+    // Track the piano key from this frame's key events (also while Ctrl is
+    // held, so a key pressed then still plays once Ctrl is let go)
+    for (uint8_t e = 0; e < key_event_count; e++) {
+        uint8_t k = key_events[e].code;
+        if (key_events[e].down) {
+            if (get_semitone(k) != -1) piano_key = k; // Latest key wins
+        } else if (k == piano_key) {
+            piano_key = find_held_piano_key();
+        }
+    }
+    // Released while a dialog had the keyboard?
+    if (piano_key && !key(piano_key)) piano_key = find_held_piano_key();
+
     // If Ctrl is held, we check for shortcuts and then STOP processing.
     // Clipboard operations
     if (is_ctrl_down()) {
@@ -361,10 +510,27 @@ void player_tick(void) {
             record_overwrite = !record_overwrite;
             update_dashboard();
         }
+        if (key_pressed(KEY_K)) {
+            sync_cycle_mode();
+        }
+        if (key_pressed(KEY_M)) {
+            midi_out_toggle();
+        }
+        if (key_pressed(KEY_Z)) {
+            // Ctrl+Shift+Z redoes as well as Ctrl+Y
+            if (is_shift_down()) redo();
+            else undo();
+        }
+        if (key_pressed(KEY_Y)) {
+            redo();
+        }
+        if (key_pressed(KEY_D)) {
+            // List duplicate patterns (Ctrl+Shift+D: merge them)
+            pattern_dedupe(is_shift_down());
+        }
         if (key_pressed(KEY_E)) {
-            // Start binary export
-            start_export();
-            export_loop();
+            // Start binary export (Ctrl+Shift+E: per-channel stems)
+            export_song(is_shift_down());
             return;
         }
         
@@ -375,19 +541,13 @@ void player_tick(void) {
         return; 
     }
 
-    // 1. Scan for piano keys
-    for (int k = 0; k < 256; k++) {
-        if (key(k)) {
-            int8_t s = get_semitone(k);
-            if (s != -1) {
-                semitone = s;
-                target_note = (current_octave + 1) * 12 + semitone;
-                note_pressed_this_frame = true;
-                ch_arp[channel].active = false; // Keyboard input kills any background Arp
-                ch_vibrato[channel].active = false; // Keyboard input kills vibrato
-                break;
-            }
-        }
+    // 1. Piano key held?
+    if (piano_key) {
+        semitone = get_semitone(piano_key);
+        target_note = (current_octave + 1) * 12 + semitone;
+        note_pressed_this_frame = true;
+        ch_arp[channel].active = false; // Keyboard input kills any background Arp
+        ch_vibrato[channel].active = false; // Keyboard input kills vibrato
     }
 
 
@@ -401,6 +561,7 @@ void player_tick(void) {
             OPL_SetVolume(channel, live_volume << 1);
             OPL_NoteOn(channel, target_note);
             ch_peaks[channel] = live_volume; // Set peak for meter display
+            macro_note_on(channel, current_instrument, target_note, live_volume);
             active_midi_note = target_note;
 
             if (edit_mode) {
@@ -445,12 +606,13 @@ void player_tick(void) {
     if (key_pressed(KEY_F2)) { if (current_octave < 8) current_octave++; update_dashboard(); }
     
     // F7 / Shift-F7: BPM Control (60-240 BPM range)
-    if (key_pressed(KEY_F7)) {
+    if (key_repeat(KEY_F7)) {
         if (is_shift_down()) {
             // Shift-F7: Decrease BPM
             if (seq.bpm > 60) {
                 seq.bpm--;
                 seq.ticks_per_row_fp = bpm_to_ticks_fp(seq.bpm);
+                mark_song_dirty(DIRTY_META);
                 update_dashboard();
                 // draw_status_message("Tempo Changed");
             }
@@ -459,6 +621,7 @@ void player_tick(void) {
             if (seq.bpm < 240) {
                 seq.bpm++;
                 seq.ticks_per_row_fp = bpm_to_ticks_fp(seq.bpm);
+                mark_song_dirty(DIRTY_META);
                 update_dashboard();
                 // draw_status_message("Tempo Changed");
             }
@@ -475,21 +638,21 @@ void player_tick(void) {
     }
 
     // Volume / Effects: [ and ] (with Shift detection inside modify_volume_effects)
-    if (key_pressed(KEY_LEFTBRACE))  modify_volume_effects(-1);
-    if (key_pressed(KEY_RIGHTBRACE)) modify_volume_effects(1);
+    if (key_repeat(KEY_LEFTBRACE))  modify_volume_effects(-1);
+    if (key_repeat(KEY_RIGHTBRACE)) modify_volume_effects(1);
 
     // Low-Byte Effect Parameters
     // Using semicolon for Down and Apostrophe for Up (as they sit near each other)
-    if (key_pressed(KEY_SEMICOLON))      modify_effect_low_byte(-1);
-    if (key_pressed(KEY_APOSTROPHE))  modify_effect_low_byte(1);
+    if (key_repeat(KEY_SEMICOLON))      modify_effect_low_byte(-1);
+    if (key_repeat(KEY_APOSTROPHE))  modify_effect_low_byte(1);
     
     // Instrument: F3 and F4
-    if (key_pressed(KEY_F3)) modify_instrument(-1);
-    if (key_pressed(KEY_F4)) modify_instrument(1);
+    if (key_repeat(KEY_F3)) modify_instrument(-1);
+    if (key_repeat(KEY_F4)) modify_instrument(1);
 
     // Note Adjustment: - and =
-    if (key_pressed(KEY_MINUS)) modify_note(-1);
-    if (key_pressed(KEY_EQUAL)) modify_note(1);
+    if (key_repeat(KEY_MINUS)) modify_note(-1);
+    if (key_repeat(KEY_EQUAL)) modify_note(1);
 
     // F8: Toggle Song vs Pattern Mode
     if (key_pressed(KEY_F8)) {
@@ -498,8 +661,8 @@ void player_tick(void) {
     }
 
     // Pattern Change: F9 and F10
-    if (key_pressed(KEY_F9)) change_pattern(-1);
-    if (key_pressed(KEY_F10)) change_pattern(1);
+    if (key_repeat(KEY_F9)) change_pattern(-1);
+    if (key_repeat(KEY_F10)) change_pattern(1);
 
     if (key_pressed(KEY_SLASH)) {
         effect_view_mode = !effect_view_mode;
@@ -516,36 +679,12 @@ void player_tick(void) {
 void handle_navigation() {
     uint8_t move_row = 0;
     int8_t move_chan = 0;
-    uint8_t active_scancode = 0;
-
-    // Detect which key is being held
-    if (key(KEY_DOWN))       active_scancode = KEY_DOWN;
-    else if (key(KEY_UP))    active_scancode = KEY_UP;
-    else if (key(KEY_LEFT))  active_scancode = KEY_LEFT;
-    else if (key(KEY_RIGHT)) active_scancode = KEY_RIGHT;
-
-    if (active_scancode != 0) {
-        if (active_scancode != last_scancode) {
-            // First press: move immediately
-            repeat_timer = 0;
-            if (active_scancode == KEY_DOWN)  move_row = 1;
-            if (active_scancode == KEY_UP)    move_row = 2; // Signal for 'Up'
-            if (active_scancode == KEY_LEFT)  move_chan = -1;
-            if (active_scancode == KEY_RIGHT) move_chan = 1;
-        } else {
-            // Holding: wait for repeat delay
-            repeat_timer++;
-            if (repeat_timer >= KEY_REPEAT_DELAY) {
-                if ((repeat_timer - KEY_REPEAT_DELAY) % KEY_REPEAT_RATE == 0) {
-                    if (active_scancode == KEY_DOWN)  move_row = 1;
-                    if (active_scancode == KEY_UP)    move_row = 2;
-                    if (active_scancode == KEY_LEFT)  move_chan = -1;
-                    if (active_scancode == KEY_RIGHT) move_chan = 1;
-                }
-            }
-        }
-    }
-    last_scancode = active_scancode;
+
+    // Move on press, then keep moving while held (see key_repeat)
+    if (key_repeat(KEY_DOWN))       move_row = 1;
+    else if (key_repeat(KEY_UP))    move_row = 2; // Signal for 'Up'
+    if (key_repeat(KEY_LEFT))       move_chan = -1;
+    else if (key_repeat(KEY_RIGHT)) move_chan = 1;
 
     // Track state to determine if we need a UI update
     uint8_t old_row = cur_row;
@@ -578,6 +717,9 @@ void handle_navigation() {
 
 void sequencer_step(void) {
     if (!seq.is_playing) return;
+
+    // OPL calls made by this step are mirrored to MIDI out
+    midi_out_step = midi_out_enabled && !is_exporting;
     
     // Increment by 1.0 tick in 8.8 fixed-point (256 = 1.0)
     seq.tick_counter_fp += TICK_SCALE;
@@ -587,15 +729,18 @@ void sequencer_step(void) {
         // Subtract (preserving fractional remainder for smooth timing)
         seq.tick_counter_fp -= seq.ticks_per_row_fp;
 
+        uint16_t ahead = (rec_ahead_row == play_row) ? rec_ahead_mask : 0;
+        rec_ahead_mask = 0;
 
         // Replace / Overwrite mode: clear cells on the current playhead row
         if (edit_mode && record_overwrite) {
             PatternCell empty_cell = {0, 0, 0, 0};
             if (midi_polyphonic) {
                 for (uint8_t ch = 0; ch < 9; ch++) {
+                    if (ahead & (1 << ch)) continue;
                     write_cell(cur_pattern, play_row, ch, &empty_cell);
                 }
-            } else {
+            } else if (!(ahead & (1 << cur_channel))) {
                 write_cell(cur_pattern, play_row, cur_channel, &empty_cell);
             }
             render_row(play_row);
@@ -603,6 +748,7 @@ void sequencer_step(void) {
 
         for (uint8_t ch = 0; ch < 9; ch++) {
             if ((ch == cur_channel && active_midi_note != 0) || active_midi_notes[ch] != 0) continue;
+            if (ahead & (1 << ch)) continue;
 
             PatternCell cell;
             read_cell(cur_pattern, play_row, ch, &cell);
@@ -825,6 +971,7 @@ void sequencer_step(void) {
                     OPL_NoteOn_Detuned(ch, note, detune);
                     
                     ch_peaks[ch] = ch_finepitch[ch].vol;
+                    macro_note_on(ch, ch_finepitch[ch].inst, note, ch_finepitch[ch].vol);
 
                     // --- THE FIX: Mark this as handled! ---
                     fine_pitch_triggered = true; 
@@ -930,6 +1077,7 @@ void sequencer_step(void) {
                     OPL_SetVolume(ch, cell.vol << 1); 
                     OPL_NoteOn(ch, cell.note + start_offset);
                     ch_peaks[ch] = cell.vol;
+                    macro_note_on(ch, cell.inst, cell.note + start_offset, cell.vol);
                 }
             }
         }
@@ -955,21 +1103,32 @@ void sequencer_step(void) {
     // if (is_new_row) {
         if (play_row < 31) {
             play_row++;
+            // Page in the next order's pattern well before it starts
+            if (is_song_mode && play_row == PATTERN_PREFETCH_ROW) {
+                uint8_t next_order = cur_order_idx + 1;
+                if (next_order >= song_length) next_order = 0;
+                pattern_prefetch(read_order_xram(next_order));
+            }
         } else {
             play_row = 0;
             if (is_song_mode) {
                 cur_order_idx++;
                 if (cur_order_idx >= song_length) cur_order_idx = 0;
                 cur_pattern = read_order_xram(cur_order_idx);
-                render_grid();
-                update_dashboard();
+                // A scrolling grid already shows the new pattern below the
+                // playhead; the rows above are what just played
+                if (!is_grid_scrolling) queue_render_grid();
+                queue_update_dashboard();
             }
         }
     }
 
+    midi_out_step = false;
 }
 
 void handle_transport_controls() {
+    if (!key_press_count) return; // Only reacts to key presses
+
     // Enter: Play / Pause / Stop
 
     if (key_pressed(KEY_ENTER)) {
@@ -984,9 +1143,8 @@ void handle_transport_controls() {
                 OPL_NoteOff(i);
                 // ch_peaks[i] = 0; // Clear peak
             }
-            memset(active_midi_notes, 0, sizeof(active_midi_notes));
-            memset(active_midi_note_rows, 0, sizeof(active_midi_note_rows));
-            midi_held_count = 0;
+            midi_release_all();
+            rec_ahead_mask = 0;
             
             for (int i=0; i<9; i++) {
                 last_effect[i] = 0xFFFF;
@@ -1025,7 +1183,7 @@ void handle_transport_controls() {
                 if (is_song_mode) {
                     // Sync to the song structure only if we are in SONG mode
                     cur_pattern = read_order_xram(cur_order_idx);
-                    render_grid(); 
+                    queue_render_grid();
                 } 
                 // If is_song_mode is false, we don't touch cur_pattern.
                 // It stays on the pattern you were manually editing.
@@ -1050,8 +1208,41 @@ void handle_transport_controls() {
 
 }
 
+// ============================================================================
+// REMOTE TRANSPORT (MIDI sync)
+// ============================================================================
+
+// Plays from play_row; the row triggers on the next sequencer step
+void transport_play(void) {
+    seq.is_playing = true;
+    seq.tick_counter_fp = seq.ticks_per_row_fp;
+    if (is_song_mode) {
+        cur_pattern = read_order_xram(cur_order_idx);
+        queue_render_grid();
+    }
+    update_dashboard();
+}
+
+// Pauses and releases every sounding note, keeping the position
+void transport_stop(void) {
+    seq.is_playing = false;
+    for (uint8_t i = 0; i < 9; i++) OPL_NoteOff(i);
+    midi_release_all();
+    rec_ahead_mask = 0;
+    update_dashboard();
+}
+
+// Moves the playhead to a song position counted in rows
+void transport_locate(uint16_t rows) {
+    play_row = rows % 32;
+    if (is_song_mode && song_length) {
+        cur_order_idx = (uint8_t)((rows / 32) % song_length);
+    }
+    queue_update_dashboard();
+}
+
 void handle_editing(void) {
-    if (!edit_mode) return;
+    if (!edit_mode || !key_press_count) return;
 
     // Check for Backspace or Delete key
     if (key_pressed(KEY_BACKSPACE) || key_pressed(KEY_DELETE)) {
@@ -1253,6 +1444,7 @@ void modify_note(int8_t delta) {
         OPL_SetVolume(cur_channel, cell.vol << 1);
         OPL_NoteOn(cur_channel, cell.note);
         ch_peaks[cur_channel] = cell.vol; // Set peak
+        macro_note_on(cur_channel, cell.inst, cell.note, cell.vol);
     }
 }
 
@@ -1268,7 +1460,7 @@ void change_pattern(int8_t delta) {
 
     // 2. If the pattern actually changed, refresh the whole screen
     if (cur_pattern != old_pat) {
-        render_grid(); // Redraw all 32 rows for the new pattern
+        queue_render_grid(); // Redraw all 32 rows for the new pattern
         update_dashboard(); // Update the "PAT: XX" display
         
         // Ensure the cursor highlight is still drawn on the current row
@@ -1285,10 +1477,10 @@ void handle_song_order_input() {
     // 1. Shift + F11/F12: Change Pattern ID in CURRENT Order Slot
     if (is_shift_down()) {
         uint8_t p = read_order_xram(cur_order_idx);
-        if (key_pressed(KEY_F11)) {
+        if (key_repeat(KEY_F11)) {
             p = (p > 0) ? p - 1 : MAX_PATTERNS - 1;
             state_changed = true;
-        } else if (key_pressed(KEY_F12)) {
+        } else if (key_repeat(KEY_F12)) {
             p = (p < MAX_PATTERNS - 1) ? p + 1 : 0;
             state_changed = true;
         }
@@ -1297,13 +1489,15 @@ void handle_song_order_input() {
             write_order_xram(cur_order_idx, p);
             // SYNC: Immediately update the current editing pattern to match
             cur_pattern = p; 
-            render_grid();
+            queue_render_grid();
         }
     }
     
     // 2. Alt + F11/F12: Change total SONG LENGTH
     else if (is_alt_down()) {
-        if (key_pressed(KEY_F11)) {
+        uint16_t old_length = song_length;
+
+        if (key_repeat(KEY_F11)) {
             if (song_length > 1) {
                 song_length--;
                 // SAFETY: If we shortened the song and moved the end-line 
@@ -1314,7 +1508,7 @@ void handle_song_order_input() {
                 state_changed = true;
             }
         }
-        else if (key_pressed(KEY_F12)) {
+        else if (key_repeat(KEY_F12)) {
             if (song_length < MAX_ORDERS_USER) {
                 song_length++;
                 state_changed = true;
@@ -1322,20 +1516,23 @@ void handle_song_order_input() {
         }
         
         if (state_changed) {
+            undo_record(UNDO_LENGTH, 0, 0, (const uint8_t *)&old_length,
+                        (const uint8_t *)&song_length, sizeof(song_length));
+            mark_song_dirty(DIRTY_META);
             // SYNC: Ensure pattern matches the (potentially snapped) index
             cur_pattern = read_order_xram(cur_order_idx);
-            render_grid();
+            queue_render_grid();
         }
     }
     
     // 3. Just F11/F12: Navigate the Order List (Jump through the song)
     else {
-        if (key_pressed(KEY_F11)) {
+        if (key_repeat(KEY_F11)) {
             if (cur_order_idx > 0) cur_order_idx--;
             else cur_order_idx = (uint8_t)(song_length - 1);
             state_changed = true;
         }
-        else if (key_pressed(KEY_F12)) {
+        else if (key_repeat(KEY_F12)) {
             if (cur_order_idx < (uint8_t)(song_length - 1)) cur_order_idx++;
             else cur_order_idx = 0;
             state_changed = true;
@@ -1345,7 +1542,7 @@ void handle_song_order_input() {
             // CONSISTENCY: Always update cur_pattern when navigating sequence.
             // This removes the "confusing view" by ensuring the grid follows the sequence highlight.
             cur_pattern = read_order_xram(cur_order_idx);
-            render_grid();
+            queue_render_grid();
         }
     }
 
@@ -1373,6 +1570,8 @@ void pattern_copy(uint8_t pat_idx) {
 }
 
 void pattern_paste(uint8_t pat_idx) {
+    undo_record_pattern(pat_idx, pattern_clipboard);
+
     uint16_t start_addr = get_pattern_xram_addr(pat_idx, 0, 0);
 
     RIA.addr0 = start_addr;
@@ -1381,6 +1580,7 @@ void pattern_paste(uint8_t pat_idx) {
     for (uint16_t i = 0; i < PATTERN_SIZE; i++) {
         RIA.rw0 = pattern_clipboard[i];
     }
+    mark_pattern_dirty(pat_idx);
     
     // Force the current view to sync if we pasted into the active pattern
     if (pat_idx == cur_pattern) {
@@ -1439,7 +1639,44 @@ static void sync_opl_patch_reg(uint8_t op, uint8_t offset, uint8_t val) {
             }
         }
     }
+    // Successive knob moves on one patch merge into a single undo step
+    undo_record(UNDO_PATCH | UNDO_MERGE, current_instrument, 0,
+                (const uint8_t *)&user_bank[current_instrument],
+                (const uint8_t *)&active_patch, sizeof(OPL_Patch));
     user_bank[current_instrument] = active_patch;
+    mark_song_dirty(DIRTY_PATCHES);
+}
+
+// Row a live message is recorded on: the row it arrived in, or the next
+// one when it came in the second half of that row. *ahead is set when that
+// row has not been triggered yet.
+static uint8_t midi_record_row(bool *ahead) {
+    *ahead = false;
+    if (!seq.is_playing) return cur_row;
+
+    uint8_t row = midi_stamp.row;
+    // On the last tick play_row already names the row about to play
+    if (midi_stamp.tick_fp >= seq.ticks_per_row_fp - TICK_SCALE) {
+        *ahead = true;
+        return row;
+    }
+    if (midi_stamp.tick_fp < seq.ticks_per_row_fp / 2) return row;
+
+    if (row < 31) {
+        row++;
+    } else if (!is_song_mode) {
+        row = 0;
+    } else {
+        return row; // The next row belongs to the next order's pattern
+    }
+    *ahead = true;
+    return row;
+}
+
+static void mark_recorded_ahead(uint8_t row, uint8_t ch) {
+    if (rec_ahead_row != row) rec_ahead_mask = 0;
+    rec_ahead_row = row;
+    rec_ahead_mask |= 1 << ch;
 }
 
 void midi_process_note_on(uint8_t chan, uint8_t note, uint8_t velocity) {
@@ -1487,47 +1724,22 @@ void midi_process_note_on(uint8_t chan, uint8_t note, uint8_t velocity) {
 
         if (drum_inst != 0) {
             play_note = 48; // Always C3
-            patch_to_use = &gm_bank[drum_inst];
+            patch_to_use = gm_patch(drum_inst);
             inst_to_record = drum_inst;
             is_drum = true;
         }
     }
 
     if (midi_polyphonic) {
-        static uint8_t next_voice = 0;
-        int8_t matched_ch = -1;
-
-        // 1. Note-Matching: Check if this exact note is already playing on any channel
-        for (uint8_t i = 0; i < 9; i++) {
-            if (active_midi_notes[i] == note) {
-                matched_ch = i;
-                break;
-            }
-        }
-
-        if (matched_ch != -1) {
-            target_ch = matched_ch;
-            OPL_NoteOff(target_ch);
+        uint8_t v = note_voice[note];
+        if (v && active_midi_notes[v - 1] == note) {
+            // Note-Matching: this exact note is still held, retrigger it
+            target_ch = v - 1;
         } else {
-            // 2. Cyclical search: Find a free channel starting from next_voice
-            int8_t free_ch = -1;
-            for (uint8_t i = 0; i < 9; i++) {
-                uint8_t ch = (next_voice + i) % 9;
-                if (active_midi_notes[ch] == 0) {
-                    free_ch = ch;
-                    next_voice = (ch + 1) % 9;
-                    break;
-                }
-            }
-
-            // 3. Voice Stealing: If no channel is free, steal next_voice
-            if (free_ch == -1) {
-                free_ch = next_voice;
-                next_voice = (next_voice + 1) % 9;
-                OPL_NoteOff(free_ch);
-            }
-            target_ch = free_ch;
+            // Release-aware allocation (see voices.c)
+            target_ch = voice_alloc(note);
         }
+        OPL_NoteOff(target_ch);
     } else {
         // Channel-mapped mode (respects the active channel cursor when chan >= 9)
         if (chan < 9) {
@@ -1544,6 +1756,8 @@ void midi_process_note_on(uint8_t chan, uint8_t note, uint8_t velocity) {
     OPL_SetVolume(target_ch, live_vol << 1);
     OPL_NoteOn(target_ch, play_note);
     ch_peaks[target_ch] = live_vol;
+    if (is_drum) macro_stop(target_ch);
+    else macro_note_on(target_ch, current_instrument, play_note, live_vol);
     
     // Apply pitch bend if active (skip for drums to keep pitch pristine)
     if (!is_drum && current_pitch_bend != 8192) {
@@ -1561,20 +1775,15 @@ void midi_process_note_on(uint8_t chan, uint8_t note, uint8_t velocity) {
         ch_vibrato[target_ch].phase = 0;
     }
 
+    // Stealing a held voice swaps one held note for another
+    if (active_midi_notes[target_ch] == 0) midi_held_count++;
     active_midi_notes[target_ch] = note;
+    voice_assign(target_ch, note);
     
     // Save target row where the note starts for note-off recording alignment
-    uint8_t rec_row = seq.is_playing ? play_row : cur_row;
+    bool rec_ahead;
+    uint8_t rec_row = midi_record_row(&rec_ahead);
     active_midi_note_rows[target_ch] = rec_row;
-    
-    // Update midi_held_count based on actual active notes
-    {
-        uint8_t count = 0;
-        for (uint8_t i = 0; i < 9; i++) {
-            if (active_midi_notes[i] != 0) count++;
-        }
-        midi_held_count = count;
-    }
 
     // Record if edit mode is active
     if (edit_mode) {
@@ -1585,6 +1794,7 @@ void midi_process_note_on(uint8_t chan, uint8_t note, uint8_t velocity) {
         c.vol = live_vol;
         write_cell(cur_pattern, rec_row, target_ch, &c);
         render_row(rec_row);
+        if (rec_ahead) mark_recorded_ahead(rec_row, target_ch);
 
         // Monophonic mode advances immediately on key press (only when sequencer is stopped)
         if (!midi_polyphonic && !seq.is_playing) {
@@ -1597,48 +1807,61 @@ void midi_process_note_on(uint8_t chan, uint8_t note, uint8_t velocity) {
     }
 }
 
+// Forgets every held MIDI key, so the next chord counts from zero. Callers
+// silence the voices themselves.
+void midi_release_all(void) {
+    memset(active_midi_notes, 0, sizeof(active_midi_notes));
+    memset(active_midi_note_rows, 0, sizeof(active_midi_note_rows));
+    midi_held_count = 0;
+}
+
 void midi_process_note_off(uint8_t chan, uint8_t note) {
     (void)chan; // Suppress unused parameter warning
     bool found = false;
     uint8_t target_ch = 0;
     
-    // Search all channels to find which one is playing this note.
-    // This is robust against cursor movement and mode changes.
-    for (uint8_t ch = 0; ch < 9; ch++) {
-        if (active_midi_notes[ch] == note) {
-            target_ch = ch;
-            OPL_NoteOff(target_ch);
-            active_midi_notes[target_ch] = 0;
-            ch_vibrato[target_ch].active = false; // Turn off software vibrato
-            found = true;
-            break;
+    // The note map knows which channel last took this note, whatever the
+    // cursor or mode did since. In channel-mapped mode the same note can be
+    // held on several channels, so when that one has let go, search them all.
+    uint8_t v = note_voice[note];
+    if (v && active_midi_notes[v - 1] == note) {
+        target_ch = v - 1;
+        found = true;
+    } else {
+        for (uint8_t ch = 0; ch < 9; ch++) {
+            if (active_midi_notes[ch] == note) {
+                target_ch = ch;
+                found = true;
+                break;
+            }
         }
     }
-
     if (found) {
+        OPL_NoteOff(target_ch);
+        active_midi_notes[target_ch] = 0;
+        ch_vibrato[target_ch].active = false; // Turn off software vibrato
+
         // Record Note Off if edit mode and sequencer are active
         if (edit_mode && seq.is_playing) {
             uint8_t note_on_row = active_midi_note_rows[target_ch];
-            if (play_row != note_on_row) {
+            bool off_ahead;
+            uint8_t off_row = midi_record_row(&off_ahead);
+            if (off_row != note_on_row) {
                 PatternCell c;
-                read_cell(cur_pattern, play_row, target_ch, &c);
+                read_cell(cur_pattern, off_row, target_ch, &c);
                 if (c.note == 0) {
                     c.note = 255;
                     c.inst = current_instrument;
                     c.vol = 0;
                     c.effect = 0xF000; // Kill effect
-                    write_cell(cur_pattern, play_row, target_ch, &c);
-                    render_row(play_row);
+                    write_cell(cur_pattern, off_row, target_ch, &c);
+                    render_row(off_row);
+                    if (off_ahead) mark_recorded_ahead(off_row, target_ch);
                 }
             }
         }
 
-        // Update midi_held_count based on remaining active notes
-        uint8_t count = 0;
-        for (uint8_t i = 0; i < 9; i++) {
-            if (active_midi_notes[i] != 0) count++;
-        }
-        midi_held_count = count;
+        midi_held_count--;
 
         // Chords advance row when all keys are released (only when sequencer is stopped)
         if (midi_polyphonic && edit_mode && !seq.is_playing && midi_held_count == 0) {
@@ -1690,6 +1913,7 @@ void midi_process_cc(uint8_t chan, uint8_t cc_num, uint8_t cc_val) {
         case 76: // Knob 3 -> BPM (60-240)
             seq.bpm = 60 + ((uint16_t)cc_val * 180 / 127);
             seq.ticks_per_row_fp = bpm_to_ticks_fp(seq.bpm);
+            mark_song_dirty(DIRTY_META);
             update_lfo_scaler();
             update_dashboard();
             break;
@@ -1772,7 +1996,7 @@ void midi_process_cc(uint8_t chan, uint8_t cc_num, uint8_t cc_val) {
                     seq.tick_counter_fp = seq.ticks_per_row_fp;
                     if (is_song_mode) {
                         cur_pattern = read_order_xram(cur_order_idx);
-                        render_grid();
+                        queue_render_grid();
                     }
                 }
                 update_dashboard();
@@ -1785,9 +2009,7 @@ void midi_process_cc(uint8_t chan, uint8_t cc_num, uint8_t cc_val) {
                 for (uint8_t i = 0; i < 9; i++) {
                     OPL_NoteOff(i);
                 }
-                memset(active_midi_notes, 0, sizeof(active_midi_notes));
-                memset(active_midi_note_rows, 0, sizeof(active_midi_note_rows));
-                midi_held_count = 0;
+                midi_release_all();
                 for (int i = 0; i < 9; i++) {
                     last_effect[i] = 0xFFFF;
                     ch_arp[i].active = false;
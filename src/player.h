@@ -56,11 +56,17 @@ extern void pattern_copy(uint8_t pattern_id);
 extern void pattern_paste(uint8_t pattern_id);
 extern void update_lfo_scaler(void);
 extern void set_bpm(uint8_t bpm);
+extern void transport_play(void);
+extern void transport_stop(void);
+extern void transport_locate(uint16_t rows);
+extern void export_song(bool stems);
+extern void export_flush_stem(uint8_t s);
 
 extern uint16_t get_pattern_xram_addr(uint8_t pat, uint8_t row, uint8_t chan);
 extern uint8_t active_midi_note;
 extern bool midi_polyphonic;
 extern uint8_t active_midi_notes[9];
+extern void midi_release_all(void);
 extern OPL_Patch active_patch;
 
 extern void select_instrument(uint8_t inst_idx);
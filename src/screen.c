@@ -4,9 +4,14 @@
 #include <rp6502.h>
 #include "usb_hid_keys.h"
 #include <stdio.h>
+#include <string.h>
 #include "instruments.h"
+#include "jobs.h"
+#include "midiout.h"
 #include "player.h"
 #include "song.h"
+#include "sync.h"
+#include "undo.h"
 
 // Peak meter state (0-63)
 uint8_t ch_peaks[9] = {0,0,0,0,0,0,0,0,0};
@@ -21,12 +26,42 @@ bool edit_mode = false;     // Are we recording?
 bool record_overwrite = false; // Overwrite (Replace) mode?
 uint8_t last_p_row = 255; // < and > symbols 
 
+// ============================================================================
+// GRID CACHE
+// ============================================================================
+// grid_shadow holds the cell data each on-screen cell was last drawn from,
+// and the grid_hl_* state says which row and cell are lit. Redraws compare
+// against it and only touch the character cells that actually change:
+// - render_row() after an edit reads the row back (45 bytes) and draws only
+//   the cells that changed, whichever code path wrote them.
+// - render_grid() (pattern switch, follow mode) does the same for all rows.
+//   queue_render_grid() spreads that work over a few frames (see jobs.h).
+// - Cursor moves only rewrite background bytes.
+// grid_invalidate() marks every row for a full repaint, for when something
+// else drew over the grid (dialogs) or the layout changed.
+
+static uint8_t grid_shadow[32][9][5];   // note, inst, vol, effect lo, effect hi
+static uint32_t grid_stale = 0xFFFFFFFFUL; // Bit r = row r needs a full repaint
+static bool grid_shown_view = false;    // effect_view_mode the grid was drawn in
+static uint8_t grid_hl_row = 255;       // Row painted with the cursor bar
+static uint8_t grid_hl_ch = 255;        // Cell painted with the cursor colour
+static uint8_t grid_hl_bar = 0;
+static uint8_t grid_hl_cell = 0;
+static uint8_t grid_playhead_row = 255; // Row carrying the > < markers
+
+bool is_grid_scrolling = false;         // Follow-mode scrolling, see GRID SCROLL
+
 void write_cell(uint8_t pat, uint8_t row, uint8_t chan, PatternCell *cell) {
-    // 1. Point to the start of the 5-byte cell in XRAM
-    RIA.addr0 = get_pattern_xram_addr(pat, row, chan);
+    uint16_t addr = get_pattern_xram_addr(pat, row, chan);
+    uint8_t old_bytes[5];
+
+    // 1. Keep the old cell for the undo journal
+    RIA.addr0 = addr;
     RIA.step0 = 1;
+    for (uint8_t i = 0; i < 5; i++) old_bytes[i] = RIA.rw0;
 
     // 2. Write the three 8-bit fields
+    RIA.addr0 = addr;
     RIA.rw0 = cell->note;
     RIA.rw0 = cell->inst;
     RIA.rw0 = cell->vol;
@@ -35,6 +70,12 @@ void write_cell(uint8_t pat, uint8_t row, uint8_t chan, PatternCell *cell) {
     // We write Low Byte then High Byte (Standard 6502 Little-Endian)
     RIA.rw0 = (uint8_t)(cell->effect & 0x00FF);
     RIA.rw0 = (uint8_t)(cell->effect >> 8);
+
+    uint8_t new_bytes[5] = {cell->note, cell->inst, cell->vol,
+                            (uint8_t)(cell->effect & 0x00FF), (uint8_t)(cell->effect >> 8)};
+    undo_record(UNDO_PATTERN, pat, (uint16_t)row * 45U + chan * 5U, old_bytes, new_bytes, 5);
+
+    mark_pattern_dirty(pat);
 }
 
 void read_cell(uint8_t pat, uint8_t row, uint8_t chan, PatternCell *cell) {
@@ -135,79 +176,125 @@ void draw_decimal_byte_coloured(uint16_t vga_addr, uint8_t val, uint8_t fg, uint
     RIA.rw0 = bg;
 }
 
-// pattern_row_idx: The row index in the pattern data (0-31)
-void render_row(uint8_t row_idx) {
-    PatternCell row_data[9];
-    uint8_t bg;
+void grid_invalidate(void) {
+    grid_stale = 0xFFFFFFFFUL;
+}
 
-    // 1. BUFFER THE DATA: Read the row from XRAM into 6502 internal RAM
-    // This prevents read_cell from clobbering RIA.addr0 during drawing.
+static uint8_t row_base_bg(uint8_t row_idx) {
+    return (row_idx % 4 == 0) ? HUD_COL_BAR : HUD_COL_BG;
+}
+
+static uint8_t cell_bg(uint8_t row_idx, uint8_t ch) {
+    if (row_idx != grid_hl_row) return row_base_bg(row_idx);
+    return (ch == grid_hl_ch) ? grid_hl_cell : grid_hl_bar;
+}
+
+// Draws the 7 characters of one cell, RIA.addr0 already pointing at it
+static void draw_cell_chars(const uint8_t *c, uint8_t bg) {
+    uint8_t note = c[0];
+    uint16_t effect = c[3] | ((uint16_t)c[4] << 8);
+
+    // Note (3 chars)
+    if (note == 0 && effect == 0) {
+        // Empty cell: show all dots
+        for(int i=0; i<3; i++) { RIA.rw0 = '.'; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg; }
+        for(int i=0; i<2; i++) { RIA.rw0 = '.'; RIA.rw0 = HUD_COL_DPURPLE; RIA.rw0 = bg; }
+        for(int i=0; i<2; i++) { RIA.rw0 = '.'; RIA.rw0 = HUD_COL_SAGEGREEN; RIA.rw0 = bg; }
+        return;
+    }
+
+    // Cell has note or effect: show content
+    if (note == 0) {
+        // No note but has effect: show dots for note
+        for(int i=0; i<3; i++) { RIA.rw0 = '.'; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg; }
+    } else if (note == 255) {
+        // Note off
+        RIA.rw0 = '='; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
+        RIA.rw0 = '='; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
+        RIA.rw0 = '='; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
+    } else {
+        // Normal note
+        uint8_t n = note % 12;
+        uint8_t oct = (note / 12) - 1;
+        RIA.rw0 = note_names[n][0]; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
+        RIA.rw0 = note_names[n][1]; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
+        RIA.rw0 = '0' + oct;   RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
+    }
+
+    if (!effect_view_mode) {
+        // Instrument (2 chars: Magenta)
+        RIA.rw0 = hex_chars[c[1] >> 4];   RIA.rw0 = HUD_COL_DPURPLE; RIA.rw0 = bg;
+        RIA.rw0 = hex_chars[c[1] & 0x0F]; RIA.rw0 = HUD_COL_DPURPLE; RIA.rw0 = bg;
+
+        // Volume (2 chars: Green)
+        RIA.rw0 = hex_chars[c[2] >> 4];    RIA.rw0 = HUD_COL_SAGEGREEN;   RIA.rw0 = bg;
+        RIA.rw0 = hex_chars[c[2] & 0x0F];  RIA.rw0 = HUD_COL_SAGEGREEN;   RIA.rw0 = bg;
+    } else {
+        // Effect (4 chars: Yellow/Orange/Cyan/Cyan)
+        RIA.rw0 = hex_chars[(effect >> 12) & 0x0F]; RIA.rw0 = HUD_COL_YELLOW; RIA.rw0 = bg;
+        RIA.rw0 = hex_chars[(effect >> 8) & 0x0F];  RIA.rw0 = HUD_COL_ORANGE; RIA.rw0 = bg;
+        RIA.rw0 = hex_chars[(effect >> 4) & 0x0F];  RIA.rw0 = HUD_COL_CYAN; RIA.rw0 = bg;
+        RIA.rw0 = hex_chars[effect & 0x0F];         RIA.rw0 = HUD_COL_CYAN; RIA.rw0 = bg;
+    }
+}
+
+// Pattern shown on a grid row: while scrolling, the rows that wrapped round
+// below the playhead already show the next order's pattern
+static uint8_t grid_row_pattern(uint8_t row_idx) {
+    if (is_grid_scrolling && is_song_mode && row_idx < play_row &&
+        ((row_idx - play_row) & 31) < GRID_CENTER_LINE) {
+        uint8_t next_order = cur_order_idx + 1;
+        if (next_order >= song_length) next_order = 0;
+        return read_order_xram(next_order);
+    }
+    return cur_pattern;
+}
+
+// Reads one grid row's pattern data (the 9 cells are contiguous)
+static void fetch_row(uint8_t row_idx, uint8_t row_data[9][5]) {
+    RIA.addr0 = get_pattern_xram_addr(grid_row_pattern(row_idx), row_idx, 0);
+    RIA.step0 = 1;
     for (uint8_t ch = 0; ch < 9; ch++) {
-        read_cell(cur_pattern, row_idx, ch, &row_data[ch]);
+        for (uint8_t i = 0; i < 5; i++) row_data[ch][i] = RIA.rw0;
     }
+}
 
-    // 2. SETUP VGA DRAWING
+static void draw_cell(uint8_t row_idx, uint8_t ch, const uint8_t *c) {
     uint8_t screen_y = row_idx + GRID_SCREEN_OFFSET;
-    uint16_t vga_ptr = text_message_addr + (screen_y * 80 * 3);
-    
-    bg = (row_idx % 4 == 0) ? HUD_COL_BAR : HUD_COL_BG;
+    RIA.addr0 = text_message_addr + (screen_y * 80 + 4 + ch * 8) * 3;
+    RIA.step0 = 1;
+    draw_cell_chars(c, cell_bg(row_idx, ch));
+    memcpy(grid_shadow[row_idx][ch], c, 5);
+}
 
-    RIA.addr0 = vga_ptr;
+// Paints a whole row (header, cells, dividers) and refills its shadow
+static void paint_row(uint8_t row_idx) {
+    uint8_t row_data[9][5];
+    uint8_t bg = (row_idx == grid_hl_row) ? grid_hl_bar : row_base_bg(row_idx);
+
+    // 1. BUFFER THE DATA: Read the row from XRAM into 6502 internal RAM
+    // This prevents get_pattern_xram_addr from clobbering RIA.addr0 during drawing.
+    fetch_row(row_idx, row_data);
+
+    // 2. SETUP VGA DRAWING
+    uint8_t screen_y = row_idx + GRID_SCREEN_OFFSET;
+    RIA.addr0 = text_message_addr + (screen_y * 80 * 3);
     RIA.step0 = 1;
 
     // 3. DRAW ROW HEADER (4 chars: "00 |")
     RIA.rw0 = hex_chars[row_idx >> 4]; RIA.rw0 = HUD_COL_CYAN;  RIA.rw0 = bg;
     RIA.rw0 = hex_chars[row_idx & 0x0F]; RIA.rw0 = HUD_COL_CYAN;  RIA.rw0 = bg;
-    RIA.rw0 = ' ';                       RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
+    if (row_idx == grid_playhead_row) {
+        RIA.rw0 = '>';                   RIA.rw0 = HUD_COL_YELLOW; RIA.rw0 = bg;
+    } else {
+        RIA.rw0 = ' ';                   RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
+    }
     RIA.rw0 = '|';                       RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
 
     // 4. DRAW CHANNELS (9 channels * 8 chars/ch = 72 chars)
     for (uint8_t ch = 0; ch < 9; ch++) {
-        PatternCell *cell = &row_data[ch];
-
-        // Note (3 chars)
-        if (cell->note == 0 && cell->effect == 0) {
-            // Empty cell: show all dots
-            for(int i=0; i<3; i++) { RIA.rw0 = '.'; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg; }
-            for(int i=0; i<2; i++) { RIA.rw0 = '.'; RIA.rw0 = HUD_COL_DPURPLE; RIA.rw0 = bg; }
-            for(int i=0; i<2; i++) { RIA.rw0 = '.'; RIA.rw0 = HUD_COL_SAGEGREEN; RIA.rw0 = bg; }
-        } else {
-            // Cell has note or effect: show content
-            
-            // Note part (3 chars)
-            if (cell->note == 0) {
-                // No note but has effect: show dots for note
-                for(int i=0; i<3; i++) { RIA.rw0 = '.'; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg; }
-            } else if (cell->note == 255) {
-                // Note off
-                RIA.rw0 = '='; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
-                RIA.rw0 = '='; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
-                RIA.rw0 = '='; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
-            } else {
-                // Normal note
-                uint8_t n = cell->note % 12;
-                uint8_t oct = (cell->note / 12) - 1;
-                RIA.rw0 = note_names[n][0]; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
-                RIA.rw0 = note_names[n][1]; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
-                RIA.rw0 = '0' + oct;   RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
-            }
-
-            if (!effect_view_mode) {
-                // Instrument (2 chars: Magenta)
-                RIA.rw0 = hex_chars[cell->inst >> 4];   RIA.rw0 = HUD_COL_DPURPLE; RIA.rw0 = bg;
-                RIA.rw0 = hex_chars[cell->inst & 0x0F]; RIA.rw0 = HUD_COL_DPURPLE; RIA.rw0 = bg;
-
-                // Volume (2 chars: Green)
-                RIA.rw0 = hex_chars[cell->vol >> 4];    RIA.rw0 = HUD_COL_SAGEGREEN;   RIA.rw0 = bg;
-                RIA.rw0 = hex_chars[cell->vol & 0x0F];  RIA.rw0 = HUD_COL_SAGEGREEN;   RIA.rw0 = bg;
-            } else {
-                // Effect (4 chars: Yellow/Orange/Cyan/Cyan)
-                RIA.rw0 = hex_chars[(cell->effect >> 12) & 0x0F]; RIA.rw0 = HUD_COL_YELLOW; RIA.rw0 = bg;
-                RIA.rw0 = hex_chars[(cell->effect >> 8) & 0x0F];  RIA.rw0 = HUD_COL_ORANGE; RIA.rw0 = bg;
-                RIA.rw0 = hex_chars[(cell->effect >> 4) & 0x0F];  RIA.rw0 = HUD_COL_CYAN; RIA.rw0 = bg;
-                RIA.rw0 = hex_chars[cell->effect & 0x0F];         RIA.rw0 = HUD_COL_CYAN; RIA.rw0 = bg;
-            }
-        }
+        draw_cell_chars(row_data[ch], cell_bg(row_idx, ch));
+        memcpy(grid_shadow[row_idx][ch], row_data[ch], 5);
 
         // Divider (1 char)
         RIA.rw0 = '|'; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = bg;
@@ -215,16 +302,79 @@ void render_row(uint8_t row_idx) {
 
     // This wipes the "trailing" blue from the highlight bar.
     for (uint8_t i = 0; i < 4; i++) {
+        if (i == 1 && row_idx == grid_playhead_row) {
+            RIA.rw0 = '<'; RIA.rw0 = HUD_COL_YELLOW; RIA.rw0 = bg;
+            continue;
+        }
         RIA.rw0 = ' ';             // Space character
         RIA.rw0 = HUD_COL_WHITE;   // Foreground color doesn't matter for space
         RIA.rw0 = bg;              // Restore Black or Grey background
     }
+    grid_stale &= ~(1UL << row_idx);
+}
+
+// Rewrites only the background bytes of a row
+static void paint_row_bg(uint8_t row_idx) {
+    RIA.addr0 = text_message_addr + ((row_idx + GRID_SCREEN_OFFSET) * 80 * 3) + 2;
+    RIA.step0 = 3;
+    if (row_idx == grid_hl_row) {
+        for (uint8_t x = 0; x < 80; x++) {
+            uint8_t ch = (x >= 4) ? (uint8_t)((x - 4) / 8) : 255;
+            // The 7 characters of the cursor cell, not its divider
+            RIA.rw0 = (ch == grid_hl_ch && ((x - 4) % 8) < 7) ? grid_hl_cell : grid_hl_bar;
+        }
+    } else {
+        uint8_t bg = row_base_bg(row_idx);
+        for (uint8_t x = 0; x < 80; x++) RIA.rw0 = bg;
+    }
+}
+
+static void paint_cell_bg(uint8_t row_idx, uint8_t ch) {
+    RIA.addr0 = text_message_addr + ((row_idx + GRID_SCREEN_OFFSET) * 80 + 4 + ch * 8) * 3 + 2;
+    RIA.step0 = 3;
+    uint8_t bg = cell_bg(row_idx, ch);
+    for (uint8_t i = 0; i < 7; i++) RIA.rw0 = bg;
+}
+
+// Draws the cells of a row that differ from what is on screen
+static void update_row(uint8_t row_idx) {
+    uint8_t row_data[9][5];
+
+    fetch_row(row_idx, row_data);
+    for (uint8_t ch = 0; ch < 9; ch++) {
+        if (memcmp(row_data[ch], grid_shadow[row_idx][ch], 5) != 0) {
+            draw_cell(row_idx, ch, row_data[ch]);
+        }
+    }
+}
+
+void render_row(uint8_t row_idx) {
+    // A different column layout makes every row stale
+    if (grid_shown_view != effect_view_mode) {
+        grid_shown_view = effect_view_mode;
+        grid_invalidate();
+    }
+    if (grid_stale & (1UL << row_idx)) paint_row(row_idx);
+    else update_row(row_idx);
 }
 
 void render_grid(void) {
     // We are showing 32 rows (0x00 to 0x1F)
-    for (uint8_t i = 0; i < 32; i++) {
-        render_row(i); // 'i' becomes 'pattern_row_idx' inside the function
+    for (uint8_t row = 0; row < 32; row++) {
+        render_row(row);
+    }
+}
+
+static void grid_rows_job(uint8_t first, uint8_t count) {
+    for (uint8_t row = first; row < first + count; row++) {
+        render_row(row);
+    }
+}
+
+// render_grid() in four 8-row jobs, one per frame while the budget is tight
+void queue_render_grid(void) {
+    for (uint8_t first = 0; first < 32; first += 8) {
+        job_queue(grid_rows_job, first, 8, 8);
     }
 }
 
@@ -239,10 +389,11 @@ void set_row_color(uint8_t row_idx, uint8_t bg_color) {
     }
 }
 
+// The grid cache knows where the highlight is, so old_row / old_ch are only
+// used for the channel header; nothing is repainted that doesn't change.
 void update_cursor_visuals(uint8_t old_row, uint8_t new_row, uint8_t old_ch, uint8_t new_ch) {
-    uint8_t old_y = old_row + GRID_SCREEN_OFFSET;
-    uint8_t new_y = new_row + GRID_SCREEN_OFFSET;
-    
+    (void)old_row;
+
     // --- 1. DETERMINE COLORS BASED ON MODE ---
     uint8_t bar_color, cell_color;
     
@@ -254,37 +405,33 @@ void update_cursor_visuals(uint8_t old_row, uint8_t new_row, uint8_t old_ch, uin
         cell_color = HUD_COL_PLAY_CELL;
     }
 
-    // --- 2. CLEAN UP OLD ROW ---
-    render_row(old_row);
-
-    // --- 3. PAINT NEW ROW HIGHLIGHT ---
-    RIA.addr0 = text_message_addr + (new_y * 80 * 3) + 2; // Point to BG byte
-    RIA.step0 = 3; 
-    for (uint8_t i = 0; i < 80; i++) {
-        RIA.rw0 = bar_color;
+    // --- 2. MOVE / RECOLOUR THE ROW BAR ---
+    if (new_row != grid_hl_row || bar_color != grid_hl_bar || cell_color != grid_hl_cell) {
+        uint8_t prev_row = grid_hl_row;
+        grid_hl_row = new_row;
+        grid_hl_ch = new_ch;
+        grid_hl_bar = bar_color;
+        grid_hl_cell = cell_color;
+        if (prev_row < 32 && prev_row != new_row) paint_row_bg(prev_row);
+        paint_row_bg(new_row);
     }
-
-    // --- 4. PAINT ACTIVE CELL ---
-    // Only change background color, preserve text colors
-    uint8_t cell_x = 4 + (new_ch * 8);
-    uint16_t cell_addr = text_message_addr + (new_y * 80 + cell_x) * 3;
-    
-    // Point to first background byte (skip char + fg)
-    RIA.addr0 = cell_addr + 2;
-    RIA.step0 = 3; // Jump to next background byte
-    
-    // Change background for all 7 characters in the cell
-    for (uint8_t i = 0; i < 7; i++) {
-        RIA.rw0 = cell_color;  // Apply Red or Blue BG
+    // --- 3. MOVE THE ACTIVE CELL WITHIN THE ROW ---
+    else if (new_ch != grid_hl_ch) {
+        uint8_t prev_ch = grid_hl_ch;
+        grid_hl_ch = new_ch;
+        if (prev_ch < 9) paint_cell_bg(new_row, prev_ch);
+        paint_cell_bg(new_row, new_ch);
     }
 
-    // --- 5. HEADER SYNC (Row 27) ---
-    // Clear old
-    uint8_t old_hdr_x = 6 + (old_ch * 8);
-    uint16_t old_hdr_addr = text_message_addr + (27 * 80 + old_hdr_x) * 3 + 1;
-    RIA.addr0 = old_hdr_addr;
-    RIA.step0 = 3;
-    for(int i=0; i<4; i++) RIA.rw0 = HUD_COL_CYAN;
+    // --- 4. HEADER SYNC (Row 27) ---
+    if (old_ch != new_ch) {
+        // Clear old
+        uint8_t old_hdr_x = 6 + (old_ch * 8);
+        uint16_t old_hdr_addr = text_message_addr + (27 * 80 + old_hdr_x) * 3 + 1;
+        RIA.addr0 = old_hdr_addr;
+        RIA.step0 = 3;
+        for(int i=0; i<4; i++) RIA.rw0 = HUD_COL_CYAN;
+    }
 
     // Highlight new (Yellow on Black)
     uint8_t new_hdr_x = 6 + (new_ch * 8);
@@ -294,6 +441,45 @@ void update_cursor_visuals(uint8_t old_row, uint8_t new_row, uint8_t old_ch, uin
     for(int i=0; i<4; i++) RIA.rw0 = HUD_COL_YELLOW;
 }
 
+// ============================================================================
+// GRID SCROLL
+// ============================================================================
+// Rows 28-59 are shown through their own text plane with y_wrap (see
+// init_graphics), so the 32 grid rows form a ring and row r always holds
+// pattern row r. While following playback the plane's y_pos_px keeps the
+// playhead on GRID_CENTER_LINE: each row advance costs one register write
+// plus the row that scrolls into view at the bottom, which in song mode
+// may already belong to the next order's pattern.
+
+static uint8_t grid_top = 0;    // Ring row shown on the first grid line
+
+static void grid_set_top(uint8_t top) {
+    grid_top = top;
+    xram0_struct_set(GRID_CONFIG, vga_mode1_config_t, y_pos_px, -(int16_t)(top * 8));
+}
+
+void grid_scroll_task(void) {
+    bool want = is_follow_mode && seq.is_playing;
+
+    if (want != is_grid_scrolling) {
+        is_grid_scrolling = want;
+        grid_set_top(want ? (uint8_t)((play_row - GRID_CENTER_LINE) & 31) : 0);
+        queue_render_grid(); // Rows below the playhead may change pattern
+        return;
+    }
+    if (!is_grid_scrolling) return;
+
+    uint8_t top = (play_row - GRID_CENTER_LINE) & 31;
+    if (top == grid_top) return;
+    if (top == ((grid_top + 1) & 31)) {
+        grid_set_top(top);
+        render_row((top + 31) & 31); // The row that just came into view
+    } else {
+        grid_set_top(top);           // Jumped (Bxx/Dxx, restart): check every row
+        queue_render_grid();
+    }
+}
+
 void draw_string(uint8_t x, uint8_t y, const char* s, uint8_t fg, uint8_t bg) {
     uint16_t addr = text_message_addr + (y * 80 + x) * 3;
     RIA.addr0 = addr;
@@ -359,6 +545,60 @@ void update_cpu_speed_display(void) {
     RIA.rw0 = 'z';
 }
 
+// ============================================================================
+// DASHBOARD CACHE
+// ============================================================================
+// update_dashboard() runs after most keys and update_meters() every frame.
+// Both remember what is on screen and only write glyphs whose value changed.
+// draw_ui_dashboard() draws the labels and meter frames and forgets the
+// cache, so the next update fills in every value.
+
+enum {
+    HUD_MODE, HUD_OCTAVE, HUD_INST, HUD_VOLUME, HUD_BPM, HUD_REC, HUD_PATTERN,
+    HUD_LENGTH, HUD_PLAY, HUD_FOLLOW, HUD_POLY, HUD_REC_METHOD, HUD_SYNC, HUD_MIDI_OUT, HUD_FIELDS
+};
+
+static uint16_t hud_drawn[HUD_FIELDS];
+static OPL_Patch hud_patch;             // Operator values on screen
+static bool hud_valid = false;
+static uint8_t meter_drawn[9];          // Blocks lit per meter, 255 = not drawn
+
+static bool hud_changed(uint8_t field, uint16_t val) {
+    if (hud_valid && hud_drawn[field] == val) return false;
+    hud_drawn[field] = val;
+    return true;
+}
+
+static void hud_invalidate(void) {
+    hud_valid = false;
+    memset(meter_drawn, 255, sizeof(meter_drawn));
+    order_display_invalidate();
+}
+
+static void dashboard_job(uint8_t a, uint8_t b) {
+    (void)a; (void)b;
+    update_dashboard();
+}
+
+// update_dashboard() from the job queue, for changes made during playback
+void queue_update_dashboard(void) {
+    job_queue(dashboard_job, 0, 0, 1);
+}
+
+// Frame of meter ch: "CHx [..........]" (the blocks are drawn by update_meters)
+static void draw_meter_frame(uint8_t ch) {
+    uint8_t y = 10 + ch;
+
+    // Label: CHx
+    draw_string(57, y, "CH", HUD_COL_CYAN, HUD_COL_BG);
+    RIA.addr0 = text_message_addr + (y * 80 + 59) * 3;
+    RIA.step0 = 1;
+    RIA.rw0 = '0' + ch; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = HUD_COL_BG;
+
+    draw_string(61, y, "[", HUD_COL_CYAN, HUD_COL_BG);
+    draw_string(72, y, "]", HUD_COL_CYAN, HUD_COL_BG);
+}
+
 void draw_ui_dashboard(void) {
     const char* h_line = "+------------------------------------------------------------------------------+";
     const char* h_short = "+-------------------------+-------------------------+";
@@ -428,7 +668,7 @@ void draw_ui_dashboard(void) {
     draw_string(2, 8, "INS:    (                  )  VOL:     OCT:   ", HUD_COL_CYAN, HUD_COL_BG);
     
     // BPM Display (below INS:)
-    draw_string(2, 9, "BPM:      TKS: 06", HUD_COL_CYAN, HUD_COL_BG);
+    draw_string(2, 9, "BPM:      TKS: 06  SYNC:      MIDI OUT:", HUD_COL_CYAN, HUD_COL_BG);
 
     // 3. Operator Headers
     draw_string(2, 11, "[ MODULATOR / OP1 ]", HUD_COL_YELLOW, HUD_COL_BG);
@@ -484,7 +724,10 @@ void draw_ui_dashboard(void) {
         set_text_color(54, r, 8, HUD_COL_WHITE, HUD_COL_BG);
         set_text_color(76, r, 3, HUD_COL_WHITE, HUD_COL_BG);
     }
-    
+
+    // 5. Meter frames; the values are filled in by the next updates
+    for (uint8_t i = 0; i < 9; i++) draw_meter_frame(i);
+    hud_invalidate();
 }
 
 void update_dashboard(void) {
@@ -492,108 +735,121 @@ void update_dashboard(void) {
 
     // --- Row 3: Brush Info ---
     // Mode: PATTERN (Green) or SONG (Yellow)
-    draw_string(8, 3, is_song_mode ? "SONG   " : "PATTERN", is_song_mode ? HUD_COL_YELLOW : HUD_COL_GREEN, HUD_COL_BG);
+    if (hud_changed(HUD_MODE, is_song_mode))
+        draw_string(8, 3, is_song_mode ? "SONG   " : "PATTERN", is_song_mode ? HUD_COL_YELLOW : HUD_COL_GREEN, HUD_COL_BG);
     
     // Octave & Instrument ID
-    draw_hex_byte_coloured(text_message_addr + (8 * 80 + 46) * 3, current_octave, HUD_COL_WHITE, HUD_COL_BG);
-    draw_hex_byte_coloured(text_message_addr + (8 * 80 + 7) * 3, current_instrument, HUD_COL_WHITE, HUD_COL_BG);
-    
-    // Instrument Name (Clear 18 chars, then draw)
-    draw_string(11, 8, "                  ", HUD_COL_WHITE, HUD_COL_BG);
-    draw_string(11, 8, patch_names[current_instrument], HUD_COL_WHITE, HUD_COL_BG);
+    if (hud_changed(HUD_OCTAVE, current_octave))
+        draw_hex_byte_coloured(text_message_addr + (8 * 80 + 46) * 3, current_octave, HUD_COL_WHITE, HUD_COL_BG);
+    if (hud_changed(HUD_INST, current_instrument)) {
+        draw_hex_byte_coloured(text_message_addr + (8 * 80 + 7) * 3, current_instrument, HUD_COL_WHITE, HUD_COL_BG);
+
+        // Instrument Name (Clear 18 chars, then draw)
+        draw_string(11, 8, "                  ", HUD_COL_WHITE, HUD_COL_BG);
+        draw_string(11, 8, patch_name(current_instrument), HUD_COL_WHITE, HUD_COL_BG);
+    }
     
     // Global Brush Volume (00-3F)
-    draw_hex_byte_coloured(text_message_addr + (8 * 80 + 37) * 3, current_volume, HUD_COL_WHITE, HUD_COL_BG);
+    if (hud_changed(HUD_VOLUME, current_volume))
+        draw_hex_byte_coloured(text_message_addr + (8 * 80 + 37) * 3, current_volume, HUD_COL_WHITE, HUD_COL_BG);
     
     // BPM Value (row 9, col 7-9) - Display in DECIMAL
-    draw_decimal_byte_coloured(text_message_addr + (9 * 80 + 7) * 3, seq.bpm, HUD_COL_WHITE, HUD_COL_BG);
+    if (hud_changed(HUD_BPM, seq.bpm))
+        draw_decimal_byte_coloured(text_message_addr + (9 * 80 + 7) * 3, seq.bpm, HUD_COL_WHITE, HUD_COL_BG);
     
     // Record State: ON (Red) or OFF (Green)
-    draw_string(74, 3, edit_mode ? "ON " : "OFF", edit_mode ? HUD_COL_RED : HUD_COL_GREEN, HUD_COL_BG);
+    if (hud_changed(HUD_REC, edit_mode))
+        draw_string(74, 3, edit_mode ? "ON " : "OFF", edit_mode ? HUD_COL_RED : HUD_COL_GREEN, HUD_COL_BG);
 
     // --- Row 4: Pattern & Sequence ---
     // The pattern currently being edited (F9/F10)
-    draw_hex_byte_coloured(text_message_addr + (4 * 80 + 12) * 3, cur_pattern, HUD_COL_WHITE, HUD_COL_BG);
+    if (hud_changed(HUD_PATTERN, cur_pattern))
+        draw_hex_byte_coloured(text_message_addr + (4 * 80 + 12) * 3, cur_pattern, HUD_COL_WHITE, HUD_COL_BG);
     
     // The Playlist scrolling preview
     update_order_display(); 
     
     // Total Song Length and Sequencer Status
-    draw_hex_byte_coloured(text_message_addr + (5 * 80 + 74) * 3, (uint8_t)song_length, HUD_COL_WHITE, HUD_COL_BG);
-    draw_string(74, 4, seq.is_playing ? "PLAY" : "STOP", seq.is_playing ? HUD_COL_GREEN : HUD_COL_RED, HUD_COL_BG);
+    if (hud_changed(HUD_LENGTH, (uint8_t)song_length))
+        draw_hex_byte_coloured(text_message_addr + (5 * 80 + 74) * 3, (uint8_t)song_length, HUD_COL_WHITE, HUD_COL_BG);
+    if (hud_changed(HUD_PLAY, seq.is_playing))
+        draw_string(74, 4, seq.is_playing ? "PLAY" : "STOP", seq.is_playing ? HUD_COL_GREEN : HUD_COL_RED, HUD_COL_BG);
 
     // Follow Mode: ON (Green) or OFF (Red)
-    draw_string(74, 6, is_follow_mode ? "ON " : "OFF", is_follow_mode ? HUD_COL_GREEN : HUD_COL_RED, HUD_COL_BG);
+    if (hud_changed(HUD_FOLLOW, is_follow_mode))
+        draw_string(74, 6, is_follow_mode ? "ON " : "OFF", is_follow_mode ? HUD_COL_GREEN : HUD_COL_RED, HUD_COL_BG);
 
     // MIDI Polyphonic Mode: ON (Green) or OFF (Red) (Row 5, col 13)
-    draw_string(13, 5, midi_polyphonic ? "ON " : "OFF", midi_polyphonic ? HUD_COL_GREEN : HUD_COL_RED, HUD_COL_BG);
+    if (hud_changed(HUD_POLY, midi_polyphonic))
+        draw_string(13, 5, midi_polyphonic ? "ON " : "OFF", midi_polyphonic ? HUD_COL_GREEN : HUD_COL_RED, HUD_COL_BG);
 
     // Record Method: APP (Cyan) or OVR (Magenta) (Row 6, col 7)
-    draw_string(7, 6, record_overwrite ? "OVR" : "APP", record_overwrite ? HUD_COL_MAGENTA : HUD_COL_CYAN, HUD_COL_BG);
-
-    // --- Row 8-12: Operator 1 (Modulator) ---
-    draw_hex_byte(text_message_addr + (13 * 80 + 15) * 3, p->m_ave);
-    draw_hex_byte(text_message_addr + (14 * 80 + 15) * 3, p->m_ksl);
-    draw_hex_byte(text_message_addr + (15 * 80 + 15) * 3, p->m_atdec);
-    draw_hex_byte(text_message_addr + (16 * 80 + 15) * 3, p->m_susrel);
-    draw_hex_byte(text_message_addr + (17 * 80 + 15) * 3, p->m_wave);
-    
-    // --- Row 8-12: Operator 2 (Carrier) ---
-    draw_hex_byte(text_message_addr + (13 * 80 + 42) * 3, p->c_ave);
-    draw_hex_byte(text_message_addr + (14 * 80 + 42) * 3, p->c_ksl);
-    draw_hex_byte(text_message_addr + (15 * 80 + 42) * 3, p->c_atdec);
-    draw_hex_byte(text_message_addr + (16 * 80 + 42) * 3, p->c_susrel);
-    draw_hex_byte(text_message_addr + (17 * 80 + 42) * 3, p->c_wave);
-
-    // --- Row 13: Global FM Parameters ---
-    draw_hex_byte(text_message_addr + (18 * 80 + 15) * 3, p->feedback);
-    
-    // Connection type display (Bit 0 of Feedback register)
-    bool additive = (p->feedback & 0x01);
-    draw_string(18, 18, additive ? "(ADD)" : "(FM) ", 
-                HUD_COL_DPURPLE, HUD_COL_BG);
-}
-
-void draw_meter(uint8_t x, uint8_t y, uint8_t val) {
-    uint16_t addr = text_message_addr + (y * 80 + x) * 3;
-    RIA.addr0 = addr;
-    RIA.step0 = 1;
-    
-    uint8_t blocks = val / 6; // Map 0-63 volume to 0-10 blocks
-    
-    RIA.rw0 = '['; RIA.rw0 = HUD_COL_CYAN; RIA.rw0 = HUD_COL_BG;
-    for (uint8_t i = 0; i < 10; i++) {
-        RIA.rw0 = (i < blocks) ? '#' : '.';
-        RIA.rw0 = (i < blocks) ? HUD_COL_GREEN : HUD_COL_DARKGREY;
-        RIA.rw0 = HUD_COL_BG;
+    if (hud_changed(HUD_REC_METHOD, record_overwrite))
+        draw_string(7, 6, record_overwrite ? "OVR" : "APP", record_overwrite ? HUD_COL_MAGENTA : HUD_COL_CYAN, HUD_COL_BG);
+
+    // Clock Sync: INT (Green), EXT (Yellow) or OUT (Cyan) (Row 9, col 27)
+    if (hud_changed(HUD_SYNC, sync_mode))
+        draw_string(27, 9, sync_mode == SYNC_EXTERNAL ? "EXT" : sync_mode == SYNC_SEND ? "OUT" : "INT",
+                    sync_mode == SYNC_EXTERNAL ? HUD_COL_YELLOW : sync_mode == SYNC_SEND ? HUD_COL_CYAN : HUD_COL_GREEN, HUD_COL_BG);
+
+    // Playback mirrored to MIDI: ON (Green) or OFF (Red) (Row 9, col 42)
+    if (hud_changed(HUD_MIDI_OUT, midi_out_enabled))
+        draw_string(42, 9, midi_out_enabled ? "ON " : "OFF", midi_out_enabled ? HUD_COL_GREEN : HUD_COL_RED, HUD_COL_BG);
+
+    // --- Row 13-18: Operator 1 (Modulator), Operator 2 (Carrier), Feedback ---
+    // The patch fields are in screen order: 5 modulator, 5 carrier, feedback
+    const uint8_t *val = (const uint8_t *)p;
+    uint8_t *shown = (uint8_t *)&hud_patch;
+    for (uint8_t i = 0; i < sizeof(OPL_Patch); i++) {
+        if (hud_valid && shown[i] == val[i]) continue;
+        shown[i] = val[i];
+        uint8_t x = (i >= 5 && i < 10) ? 42 : 15;
+        uint8_t y = 13 + ((i < 5) ? i : (i < 10) ? i - 5 : 5);
+        draw_hex_byte(text_message_addr + (y * 80 + x) * 3, val[i]);
+
+        // Connection type display (Bit 0 of Feedback register)
+        if (i == 10) {
+            bool additive = (p->feedback & 0x01);
+            draw_string(18, 18, additive ? "(ADD)" : "(FM) ", 
+                        HUD_COL_DPURPLE, HUD_COL_BG);
+        }
     }
-    RIA.rw0 = ']'; RIA.rw0 = HUD_COL_CYAN; RIA.rw0 = HUD_COL_BG;
+
+    hud_valid = true;
 }
 
+// Meter Bar: [##########], only the blocks between the old and new level
 void update_meters(void) {
     for (uint8_t i = 0; i < 9; i++) {
         // Underflow protection: 1-frame decay
         if (ch_peaks[i] > 1) ch_peaks[i]-=2; 
-        
-        // Label: CHx
-        draw_string(57, 10 + i, "CH", HUD_COL_CYAN, HUD_COL_BG);
-        uint16_t num_ptr = text_message_addr + ((10 + i) * 80 + 59) * 3;
-        RIA.addr0 = num_ptr;
+
+        uint8_t blocks = ch_peaks[i] / 6; // Map 0-63 volume to 0-10 blocks
+        if (blocks > 10) blocks = 10;     // 60-63 would draw an 11th block
+        uint8_t drawn = meter_drawn[i];
+        if (blocks == drawn) continue;
+
+        uint8_t from = 0, to = 10;
+        if (drawn != 255) {
+            from = (blocks < drawn) ? blocks : drawn;
+            to = (blocks < drawn) ? drawn : blocks;
+        }
+        RIA.addr0 = text_message_addr + ((10 + i) * 80 + 62 + from) * 3;
         RIA.step0 = 1;
-        RIA.rw0 = '0' + i; RIA.rw0 = HUD_COL_WHITE; RIA.rw0 = HUD_COL_BG;
-        
-        // Meter Bar: [##########]
-        draw_meter(61, 10 + i, ch_peaks[i]);
+        for (uint8_t b = from; b < to; b++) {
+            RIA.rw0 = (b < blocks) ? '#' : '.';
+            RIA.rw0 = (b < blocks) ? HUD_COL_GREEN : HUD_COL_DARKGREY;
+            RIA.rw0 = HUD_COL_BG;
+        }
+        meter_drawn[i] = blocks;
     }
 }
 
 
 void mark_playhead(uint8_t row_to_draw) {
-    static uint8_t last_drawn_row = 255;
-    
     // 1. Clear previous markers if they moved
-    if (last_drawn_row != 255 && last_drawn_row != row_to_draw) {
-        uint8_t old_y = last_drawn_row + GRID_SCREEN_OFFSET;
+    if (grid_playhead_row != 255 && grid_playhead_row != row_to_draw) {
+        uint8_t old_y = grid_playhead_row + GRID_SCREEN_OFFSET;
         
         RIA.addr0 = text_message_addr + (old_y * 80 + 2) * 3;
         RIA.step0 = 3; // Skip FG/BG
@@ -620,10 +876,11 @@ void mark_playhead(uint8_t row_to_draw) {
     RIA.rw0 = '<';
     RIA.rw0 = HUD_COL_YELLOW;
 
-    last_drawn_row = row_to_draw;
+    grid_playhead_row = row_to_draw;
 }
 
 void refresh_all_ui(void) {
+    grid_invalidate();   // Dialogs may have drawn over the grid
     clear_top_ui();      // Wipes rows 0-27 in XRAM
     draw_ui_dashboard(); // Redraws the boxes, headers, and labels
     update_dashboard();  // Redraws all current hex values and names
@@ -11,6 +11,7 @@ extern uint8_t ch_peaks[9]; // Peak meter state
 #define PATTERN_XRAM_BASE 0x0000
 
 #define GRID_SCREEN_OFFSET 28 // The grid starts at Screen Row 28
+#define GRID_CENTER_LINE 16   // Grid line the playhead stays on while scrolling
 
 typedef struct {
     uint8_t note;       // MIDI Note (0=None, 255=Off)
@@ -25,14 +26,19 @@ extern uint8_t cur_row;
 extern uint8_t cur_pattern;
 extern uint8_t cur_channel;
 extern uint8_t last_p_row;
+extern bool is_grid_scrolling;
 
 extern void write_cell(uint8_t pat, uint8_t row, uint8_t chan, PatternCell *cell);
 extern void render_grid(void);
+extern void grid_invalidate(void);
+extern void queue_render_grid(void);
+extern void grid_scroll_task(void);
 extern void update_cursor_visuals(uint8_t old_row, uint8_t new_row, uint8_t old_ch, uint8_t new_ch);
 extern void draw_headers(void);
 extern void draw_ui_dashboard(void);
 extern void clear_top_ui(void);
 extern void update_dashboard(void);
+extern void queue_update_dashboard(void);
 extern void render_row(uint8_t pattern_row_idx);
 extern void read_cell(uint8_t pat, uint8_t row, uint8_t chan, PatternCell *cell);
 extern void draw_string(uint8_t x, uint8_t y, const char* s, uint8_t fg, uint8_t bg);
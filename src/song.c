@@ -9,6 +9,11 @@
 #include "song.h"
 #include "player.h"
 #include "input.h"
+#include "library.h"
+#include "macros.h"
+#include "opl.h"
+#include "patterns.h"
+#include "undo.h"
 #include <string.h>
 #include "usb_hid_keys.h"
 
@@ -22,30 +27,94 @@ uint8_t dialog_pos = 0; // Current cursor position in the string
 bool is_saving = false;
 bool is_dialog_active = false;
 
-void write_order_xram(uint8_t index, uint8_t pattern_id) {
-    // 1. Point the RIA to the Order List + the specific slot
-    RIA.addr0 = ORDER_LIST_XRAM + index;
-    RIA.step0 = 1;
-    
-    // 2. Write the Pattern ID into that slot
-    RIA.rw0 = pattern_id;
+#define RPT4_PATTERNS 32 // Patterns in the fixed RPT4 layout
+
+// Dirty tracking (bit n of the bitmap = pattern n). Ctrl+S and autosave keep
+// separate sets so that saving one file doesn't hide changes from the other.
+static uint8_t save_dirty_pats[MAX_PATTERNS / 8];
+static uint8_t save_dirty_flags = 0;
+static uint8_t autosave_dirty_pats[MAX_PATTERNS / 8];
+static uint8_t autosave_dirty_flags = 0;
+static bool autosave_pending = false;
+static uint16_t autosave_timer = 0;
+
+// Patterns at or above this index are all empty
+static uint16_t pattern_extent = 0;
+
+// The active file is RPT4 on disk and matches memory apart from the save
+// dirty set, so Ctrl+S can patch it in place
+static bool active_is_rpt4 = false;
+
+void mark_pattern_dirty(uint8_t pat) {
+    uint8_t bit = (uint8_t)(1 << (pat & 7));
+    save_dirty_pats[pat >> 3] |= bit;
+    autosave_dirty_pats[pat >> 3] |= bit;
+    autosave_pending = true;
+    pattern_cache_mark_dirty(pat);
+
+    if (pat >= pattern_extent) {
+        // AUTOSAVE.RPT extension patterns must not leave holes in the file
+        for (uint16_t p = (pattern_extent > RPT4_PATTERNS) ? pattern_extent : RPT4_PATTERNS; p < pat; p++) {
+            autosave_dirty_pats[p >> 3] |= (uint8_t)(1 << (p & 7));
+        }
+        pattern_extent = (uint16_t)pat + 1;
+    }
 }
 
-uint8_t read_order_xram(uint8_t index) {
-    // 1. Point the RIA to the Order List + the specific slot
-    RIA.addr0 = ORDER_LIST_XRAM + index;
-    RIA.step0 = 1;
-    
-    // 2. Read the Pattern ID from that slot and return it
-    return RIA.rw0;
+void mark_song_dirty(uint8_t flags) {
+    save_dirty_flags |= flags;
+    autosave_dirty_flags |= flags;
+    autosave_pending = true;
+}
+
+// ============================================================================
+// ORDER LIST DISPLAY
+// ============================================================================
+// The dashboard shows the first ORDER_VIEW_SLOTS orders. order_view mirrors
+// them in RAM (write_order_xram() keeps it current) and order_shown_* record
+// what each slot was drawn as, so a cursor move or an edit redraws one or two
+// slots. order_display_invalidate() rereads the list and redraws every slot,
+// for loads and anything else that writes the order list directly.
+
+#define ORDER_VIEW_SLOTS 64
+
+enum { SLOT_NOT_DRAWN, SLOT_UNUSED, SLOT_PLAIN, SLOT_CURSOR_PLAY, SLOT_CURSOR_EDIT };
+
+static uint8_t order_view[ORDER_VIEW_SLOTS];
+static uint8_t order_shown_pat[ORDER_VIEW_SLOTS];
+static uint8_t order_shown_look[ORDER_VIEW_SLOTS];
+static bool order_view_valid = false;
+
+void order_display_invalidate(void) {
+    order_view_valid = false;
 }
 
 void update_order_display() {
     const uint8_t start_x = 21; // Sequence start column
     const uint8_t start_y = 3;  // Sequence start row (using rows 3, 4, 5, 6)
+
+    if (!order_view_valid) {
+        RIA.addr0 = ORDER_LIST_XRAM;
+        RIA.step0 = 1;
+        for (uint8_t i = 0; i < ORDER_VIEW_SLOTS; i++) order_view[i] = RIA.rw0;
+        memset(order_shown_look, SLOT_NOT_DRAWN, sizeof(order_shown_look));
+        order_view_valid = true;
+    }
     
     // Total 64 slots (4 rows of 16)
-    for (uint8_t i = 0; i < 64; i++) {
+    for (uint8_t i = 0; i < ORDER_VIEW_SLOTS; i++) {
+        uint8_t look;
+        if (i >= song_length) look = SLOT_UNUSED;
+        else if (i != cur_order_idx) look = SLOT_PLAIN;
+        else look = edit_mode ? SLOT_CURSOR_EDIT : SLOT_CURSOR_PLAY;
+
+        uint8_t p_id = order_view[i];
+        if (look == order_shown_look[i] && (look == SLOT_UNUSED || p_id == order_shown_pat[i])) {
+            continue;
+        }
+        order_shown_look[i] = look;
+        order_shown_pat[i] = p_id;
+
         // --- THE MATH FIX ---
         // row = i / 16 (0, 1, 2, 3)
         // col = i % 16 (0, 1, 2 ... 15)
@@ -56,20 +125,16 @@ void update_order_display() {
         uint8_t y = start_y + row;
         uint16_t vga_ptr = text_message_addr + (y * 80 + x) * 3;
 
-        if (i >= song_length) {
+        if (look == SLOT_UNUSED) {
             // Unused slots show as grey dots
             draw_string(x, y, ".. ", HUD_COL_DARKGREY, HUD_COL_BG);
         } else {
-            uint8_t p_id = read_order_xram(i);
-            
             // Current editing slot gets Yellow highlight
-            uint8_t fg = (i == cur_order_idx) ? HUD_COL_YELLOW : HUD_COL_WHITE;
+            uint8_t fg = (look == SLOT_PLAIN) ? HUD_COL_WHITE : HUD_COL_YELLOW;
             uint8_t bg;
-            if (i == cur_order_idx) {
-                bg = edit_mode ? HUD_COL_EDIT_CELL : HUD_COL_PLAY_CELL;
-            } else {
-                bg = HUD_COL_BG;
-            }
+            if (look == SLOT_CURSOR_EDIT) bg = HUD_COL_EDIT_CELL;
+            else if (look == SLOT_CURSOR_PLAY) bg = HUD_COL_PLAY_CELL;
+            else bg = HUD_COL_BG;
             
             // 1. Draw the Pattern ID (2-digit hex)
             draw_hex_byte_coloured(vga_ptr, p_id, fg, bg);
@@ -80,13 +145,28 @@ void update_order_display() {
     }
 }
 
-static void read_xram_loop(uint16_t xram_addr, uint16_t count, int fd) {
-    uint16_t total = 0;
-    while (total < count) {
-        int n = read_xram(xram_addr + total, count - total, fd);
-        if (n <= 0) break;
-        total += (uint16_t)n;
-    }
+void write_order_xram(uint8_t index, uint8_t pattern_id) {
+    uint8_t old_id = read_order_xram(index);
+    undo_record(UNDO_ORDER, 0, index, &old_id, &pattern_id, 1);
+
+    // 1. Point the RIA to the Order List + the specific slot
+    RIA.addr0 = ORDER_LIST_XRAM + index;
+    RIA.step0 = 1;
+    
+    // 2. Write the Pattern ID into that slot
+    RIA.rw0 = pattern_id;
+    if (index < ORDER_VIEW_SLOTS) order_view[index] = pattern_id;
+
+    mark_song_dirty(DIRTY_META);
+}
+
+uint8_t read_order_xram(uint8_t index) {
+    // 1. Point the RIA to the Order List + the specific slot
+    RIA.addr0 = ORDER_LIST_XRAM + index;
+    RIA.step0 = 1;
+    
+    // 2. Read the Pattern ID from that slot and return it
+    return RIA.rw0;
 }
 
 static void write_xram_loop(uint16_t xram_addr, uint16_t count, int fd) {
@@ -98,31 +178,374 @@ static void write_xram_loop(uint16_t xram_addr, uint16_t count, int fd) {
     }
 }
 
+// ============================================================================
+// RPT5 / RPT6 SPARSE FORMAT
+// ============================================================================
+// "RPT5", Octave (1B), Volume (1B), Song Length (2B), BPM (2B)
+// Patch count (2B), then per patch: Index (1B) + OPL_Patch (11B)
+//     Only user_bank entries that differ from the standard bank are stored.
+// Order list (Song Length bytes)
+// Pattern bitmap (4B, bit n = pattern n stored, LSB first)
+//     RPT6 is identical but with a 32-byte bitmap for patterns 0-255; it is
+//     only written when a pattern above 31 is in use.
+// Per stored pattern, the 288 cells (row-major, 5 bytes each) as RLE tokens:
+//     0x80 | (n-1)  ->  n empty cells (all five bytes zero), n = 1..128
+//     n-1           ->  n literal cells follow (n * 5 bytes), n = 1..128
+// Patterns not in the bitmap load as empty.
+// Instrument macros, only when the song has any (older files just end):
+//     Count (1B), then per sequence: Instrument, Type, Length, Loop, Release
+//     (1B each) and Length signed steps (see macros.h)
+
+#define CELL_SIZE       5
+#define PATTERN_CELLS   (PATTERN_SIZE / CELL_SIZE)
+#define RLE_MAX_RUN     128
+
+// Small RAM staging buffer so tokens don't cost one OS call per byte
+static uint8_t io_buf[64];
+static uint8_t io_len = 0;
+static uint8_t io_pos = 0;
+static int io_fd = -1;
+
+static void io_flush(void) {
+    if (io_len) write(io_fd, io_buf, io_len);
+    io_len = 0;
+}
+
+static void io_put(uint8_t b) {
+    io_buf[io_len++] = b;
+    if (io_len == sizeof(io_buf)) io_flush();
+}
+
+static uint8_t io_get(void) {
+    if (io_pos == io_len) {
+        int n = read(io_fd, io_buf, sizeof(io_buf));
+        io_len = (n > 0) ? (uint8_t)n : 0;
+        io_pos = 0;
+        if (io_len == 0) return 0; // Truncated file reads as empty data
+    }
+    return io_buf[io_pos++];
+}
+
+static bool cell_is_empty(uint16_t addr) {
+    RIA.addr0 = addr;
+    RIA.step0 = 1;
+    return (RIA.rw0 | RIA.rw0 | RIA.rw0 | RIA.rw0 | RIA.rw0) == 0;
+}
+
+static bool pattern_is_empty(uint8_t pat) {
+    if (!pattern_is_stored(pat)) return true;
+
+    RIA.addr0 = pattern_slot_addr(pat);
+    RIA.step0 = 1;
+    for (uint16_t i = 0; i < PATTERN_SIZE; i++) {
+        if (RIA.rw0) return false;
+    }
+    return true;
+}
+
+static void save_pattern_rle(uint8_t pat) {
+    uint16_t base = pattern_slot_addr(pat);
+    uint16_t cell = 0;
+
+    while (cell < PATTERN_CELLS) {
+        bool empty = cell_is_empty(base + cell * CELL_SIZE);
+        uint16_t run = 1;
+        while (cell + run < PATTERN_CELLS && run < RLE_MAX_RUN &&
+               cell_is_empty(base + (cell + run) * CELL_SIZE) == empty) {
+            run++;
+        }
+
+        if (empty) {
+            io_put(0x80 | (uint8_t)(run - 1));
+        } else {
+            io_put((uint8_t)(run - 1));
+            RIA.addr0 = base + cell * CELL_SIZE;
+            RIA.step0 = 1;
+            for (uint16_t i = 0; i < run * CELL_SIZE; i++) {
+                io_put(RIA.rw0);
+            }
+        }
+        cell += run;
+    }
+}
+
+static void load_pattern_rle(uint8_t pat) {
+    uint16_t cell = 0;
+
+    RIA.addr0 = pattern_slot_addr(pat);
+    RIA.step0 = 1;
+
+    while (cell < PATTERN_CELLS) {
+        uint8_t tok = io_get();
+        uint16_t run = (tok & 0x7F) + 1;
+        if (cell + run > PATTERN_CELLS) run = PATTERN_CELLS - cell;
+
+        // io_get() only touches 6502 RAM, so addr0 keeps streaming
+        for (uint16_t i = 0; i < run * CELL_SIZE; i++) {
+            RIA.rw0 = (tok & 0x80) ? 0 : io_get();
+        }
+        cell += run;
+    }
+    pattern_cache_mark_dirty(pat); // Not in the swap file yet
+}
+
+static void save_macros(void) {
+    io_put(macro_count);
+    for (uint8_t i = 0; i < macro_count; i++) {
+        const MacroSeq *m = &macro_seqs[i];
+        io_put(m->inst);
+        io_put(m->type);
+        io_put(m->length);
+        io_put(m->loop);
+        io_put(m->release);
+        for (uint8_t n = 0; n < m->length; n++) io_put((uint8_t)m->value[n]);
+    }
+}
+
+static void load_macros(void) {
+    uint8_t count = io_get(); // 0 at the end of the file
+
+    macro_clear();
+    for (uint8_t i = 0; i < count; i++) {
+        MacroSeq *m = &macro_seqs[(i < MACRO_MAX_SEQS) ? i : MACRO_MAX_SEQS - 1];
+        m->inst = io_get();
+        m->type = io_get();
+        uint8_t length = io_get();
+        m->loop = io_get();
+        m->release = io_get();
+        m->length = (length > MACRO_LEN) ? MACRO_LEN : length;
+        for (uint8_t n = 0; n < length; n++) {
+            uint8_t v = io_get();
+            if (n < MACRO_LEN) m->value[n] = (int8_t)v;
+        }
+    }
+    macro_count = count;
+    macro_index();
+}
+
+static void clear_xram(uint16_t addr, uint16_t count) {
+    RIA.addr0 = addr;
+    RIA.step0 = 1;
+    for (uint16_t i = 0; i < count; i++) {
+        RIA.rw0 = 0;
+    }
+}
+
+// ============================================================================
+// RPT4 FIXED LAYOUT (incremental save and autosave)
+// ============================================================================
+// Every region of an RPT4 file sits at a fixed offset, so changed regions can
+// be rewritten in place with lseek() instead of writing the whole 49 KB.
+// AUTOSAVE.RPT may continue past the order list with patterns 32 and up,
+// and then with the song's macros in the RPT5 macro block. The block is
+// always shorter than a pattern, so the file size still gives the count of
+// extension patterns.
+
+#define RPT4_BANK_OFFSET    10L
+#define RPT4_PATTERN_OFFSET (RPT4_BANK_OFFSET + (long)sizeof(user_bank))
+#define RPT4_ORDER_OFFSET   (RPT4_PATTERN_OFFSET + (long)RPT4_PATTERNS * PATTERN_SIZE)
+#define RPT4_EXT_OFFSET     (RPT4_ORDER_OFFSET + MAX_ORDERS)
+
+static long rpt4_pattern_offset(uint8_t pat) {
+    if (pat < RPT4_PATTERNS) return RPT4_PATTERN_OFFSET + (long)pat * PATTERN_SIZE;
+    return RPT4_EXT_OFFSET + (long)(pat - RPT4_PATTERNS) * PATTERN_SIZE;
+}
+
+static void rpt4_write_header(int fd) {
+    uint16_t save_bpm = seq.bpm;
+
+    lseek(fd, 0, SEEK_SET);
+    write(fd, "RPT4", 4);
+    write(fd, &current_octave, 1);
+    write(fd, &current_volume, 1);
+    write(fd, &song_length, 2);
+    write(fd, &save_bpm, 2);
+}
+
+static void rpt4_write_bank(int fd) {
+    lseek(fd, RPT4_BANK_OFFSET, SEEK_SET);
+    write(fd, user_bank, sizeof(user_bank));
+}
+
+static void rpt4_write_pattern(int fd, uint8_t pat) {
+    lseek(fd, rpt4_pattern_offset(pat), SEEK_SET);
+    write_xram_loop(pattern_slot_addr(pat), PATTERN_SIZE, fd);
+}
+
+static void rpt4_write_order(int fd) {
+    lseek(fd, RPT4_ORDER_OFFSET, SEEK_SET);
+    write_xram_loop(ORDER_LIST_XRAM, MAX_ORDERS, fd);
+}
+
+// Just past the extension patterns (pat_limit is at least RPT4_PATTERNS).
+// Written even with no macros, so an old block never outlives them.
+static void rpt4_write_macros(int fd, uint16_t pat_limit) {
+    lseek(fd, RPT4_EXT_OFFSET + (long)(pat_limit - RPT4_PATTERNS) * PATTERN_SIZE, SEEK_SET);
+    io_fd = fd;
+    io_len = 0;
+    save_macros();
+    io_flush();
+}
+
+// Patch the active RPT4 file with only what changed since it was loaded
+static bool save_song_incremental(const char* filename) {
+    int fd = open(filename, O_WRONLY);
+    if (fd < 0) return false;
+
+    uint8_t count = 0;
+    rpt4_write_header(fd); // 10 bytes, cheaper than tracking octave/volume
+    if (save_dirty_flags & DIRTY_PATCHES) rpt4_write_bank(fd);
+    for (uint16_t pat = 0; pat < RPT4_PATTERNS; pat++) {
+        if (save_dirty_pats[pat >> 3] & (1 << (pat & 7))) {
+            rpt4_write_pattern(fd, (uint8_t)pat);
+            count++;
+        }
+    }
+    if (save_dirty_flags & DIRTY_META) rpt4_write_order(fd);
+    close(fd);
+
+    memset(save_dirty_pats, 0, sizeof(save_dirty_pats));
+    save_dirty_flags = 0;
+    printf("Saved: %s (%u changed patterns)\n", filename, count);
+    return true;
+}
+
 void save_song(const char* filename) {
+    // RPT5 offsets depend on the data, so only RPT4 files update in place.
+    // Plain RPT4 has no room for macros.
+    if (active_is_rpt4 && pattern_extent <= RPT4_PATTERNS && macro_count == 0 &&
+        strcmp(filename, active_filename) == 0) {
+        if (save_song_incremental(filename)) return;
+    }
+
     int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC);
     if (fd < 0) return;
 
     uint16_t save_bpm = seq.bpm;
+    bool wide = pattern_extent > RPT4_PATTERNS;
 
-    write(fd, "RPT4", 4); // RPT4 Version Identifier (with custom patch overrides)
+    write(fd, wide ? "RPT6" : "RPT5", 4); // Sparse formats, RPT6 for > 32 patterns
     write(fd, &current_octave, 1);
     write(fd, &current_volume, 1);
     write(fd, &song_length, 2);
     write(fd, &save_bpm, 2);
 
-    // Save custom patch bank (256 x 11 bytes = 2816 bytes)
-    write(fd, user_bank, sizeof(user_bank));
+    io_fd = fd;
+    io_len = 0;
 
-    // Save all 32 patterns ($B400 bytes)
-    write_xram_loop(0x0000, 0xB400, fd); 
+    // Only the patches the user has changed
+    uint8_t edited[32];
+    uint16_t patch_count = patch_edited_map(edited);
+    io_put((uint8_t)patch_count);
+    io_put((uint8_t)(patch_count >> 8));
+    for (uint16_t i = 0; i < 256; i++) {
+        if (!(edited[i >> 3] & (1 << (i & 7)))) continue;
+        const uint8_t *p = (const uint8_t *)&user_bank[i];
+        io_put((uint8_t)i);
+        for (uint8_t b = 0; b < sizeof(OPL_Patch); b++) io_put(p[b]);
+    }
+
+    // Used part of the Sequence Order
+    RIA.addr0 = ORDER_LIST_XRAM;
+    RIA.step0 = 1;
+    for (uint16_t i = 0; i < song_length; i++) {
+        io_put(RIA.rw0);
+    }
 
-    // Save the 256-step Sequence Order (at $B400)
-    write_xram_loop(0xB400, 0x0100, fd);
+    // Pattern presence bitmap, then the non-empty patterns
+    uint8_t bitmap[MAX_PATTERNS / 8] = {0};
+    for (uint16_t pat = 0; pat < pattern_extent; pat++) {
+        if (!pattern_is_empty((uint8_t)pat)) bitmap[pat >> 3] |= (uint8_t)(1 << (pat & 7));
+    }
+    uint8_t bitmap_bytes = wide ? sizeof(bitmap) : RPT4_PATTERNS / 8;
+    for (uint8_t i = 0; i < bitmap_bytes; i++) io_put(bitmap[i]);
+
+    for (uint16_t pat = 0; pat < pattern_extent; pat++) {
+        if (bitmap[pat >> 3] & (1 << (pat & 7))) save_pattern_rle((uint8_t)pat);
+    }
+    if (macro_count) save_macros();
 
+    io_flush();
     close(fd);
+
+    // The saved file is now the baseline for dirty tracking
+    memset(save_dirty_pats, 0, sizeof(save_dirty_pats));
+    save_dirty_flags = 0;
+    active_is_rpt4 = false;
+    strncpy(active_filename, filename, 63);
+    active_filename[63] = '\0';
+    printf("Saved: %s\n", active_filename);
 }
 
-void load_song(const char* filename) {
+// ============================================================================
+// CHUNKED LOADING
+// ============================================================================
+// load_song_begin() reads the header (and for RPT5/6 the patches and order list),
+// then load_task() brings in the pattern data one chunk per frame while a
+// progress bar is shown. The sequencer is stopped for the duration, but MIDI
+// keeps playing the OPL so the machine never looks hung on a slow USB stick.
+
+#define LOAD_CHUNK      1024    // Bytes of RPT1-4 bulk data per frame
+#define LOAD_BULK_SIZE  (ORDER_LIST_XRAM + MAX_ORDERS) // Patterns + order list
+
+bool is_loading = false;
+
+static int ld_fd = -1;
+static char ld_version = 0;
+static uint16_t ld_bpm = 150;
+static uint16_t ld_pos = 0;     // Bytes (RPT1-4) or patterns (RPT5/6) done
+static uint16_t ld_total = 0;
+static uint16_t ld_ext_pat = 0; // Next RPT4 extension pattern
+static uint16_t ld_ext_end = 0;
+static uint8_t ld_bitmap[MAX_PATTERNS / 8];
+static char ld_filename[64];
+
+static void load_rpt5_tables(void) {
+    io_fd = ld_fd;
+    io_len = 0;
+    io_pos = 0;
+
+    gm_bank_copy(user_bank);
+    uint16_t patch_count = io_get();
+    patch_count |= (uint16_t)io_get() << 8;
+    for (uint16_t n = 0; n < patch_count; n++) {
+        uint8_t *p = (uint8_t *)&user_bank[io_get()];
+        for (uint8_t b = 0; b < sizeof(OPL_Patch); b++) p[b] = io_get();
+    }
+
+    if (song_length > MAX_ORDERS) song_length = MAX_ORDERS;
+    clear_xram(ORDER_LIST_XRAM, MAX_ORDERS);
+    RIA.addr0 = ORDER_LIST_XRAM;
+    RIA.step0 = 1;
+    for (uint16_t i = 0; i < song_length; i++) {
+        RIA.rw0 = io_get();
+    }
+
+    memset(ld_bitmap, 0, sizeof(ld_bitmap));
+    uint8_t bitmap_bytes = (ld_version == '6') ? sizeof(ld_bitmap) : RPT4_PATTERNS / 8;
+    for (uint8_t i = 0; i < bitmap_bytes; i++) ld_bitmap[i] = io_get();
+}
+
+static void draw_load_progress(void) {
+    const uint8_t box_x = 20, box_y = 10;
+    const uint8_t bar_len = 32;
+    char bar[33];
+
+    uint8_t filled = (uint8_t)(((uint32_t)ld_pos * bar_len) / ld_total);
+    for (uint8_t i = 0; i < bar_len; i++) bar[i] = (i < filled) ? '#' : '.';
+    bar[bar_len] = '\0';
+
+    if (ld_pos == 0) {
+        draw_string(box_x, box_y,     "+----------------------------------+", HUD_COL_WHITE, HUD_COL_BLUE);
+        draw_string(box_x, box_y + 1, "| LOADING:                         |", HUD_COL_WHITE, HUD_COL_BLUE);
+        draw_string(box_x, box_y + 2, "|                                  |", HUD_COL_WHITE, HUD_COL_BLUE);
+        draw_string(box_x, box_y + 3, "+----------------------------------+", HUD_COL_WHITE, HUD_COL_BLUE);
+        draw_string(box_x + 11, box_y + 1, ld_filename, HUD_COL_YELLOW, HUD_COL_BLUE);
+    }
+    draw_string(box_x + 2, box_y + 2, bar, HUD_COL_GREEN, HUD_COL_BG);
+}
+
+bool load_song_begin(const char* filename) {
     int fd = open(filename, O_RDONLY);
     if (fd < 0 && strncmp(filename, "0:", 2) != 0) {
         char drive_path[64];
@@ -131,63 +554,358 @@ void load_song(const char* filename) {
     }
     if (fd < 0) {
         printf("Error: File not found: %s\n", filename);
-        return;
+        return false;
     }
 
     char head[4];
     if (read(fd, head, 4) != 4 || head[0] != 'R') {
         printf("Error: Invalid file format\n");
         close(fd);
-        return;
+        return false;
+    }
+
+    // Patterns are about to be overwritten under the sequencer
+    if (seq.is_playing) {
+        seq.is_playing = false;
+        OPL_SilenceAll();
     }
+    edit_mode = false; // MIDI preview must not record into a half-loaded song
 
-    uint16_t loaded_bpm = 150;
+    ld_fd = fd;
+    ld_version = head[3];
+    macro_clear(); // Only RPT5/6 and AUTOSAVE.RPT files carry macros
+    ld_bpm = 150;
+    ld_pos = 0;
+    ld_ext_pat = ld_ext_end = 0;
+    strncpy(ld_filename, filename, 63);
+    ld_filename[63] = '\0';
 
     // 1. Read Metadata into 6502 RAM based on version
-    if (head[3] == '4') {
-        // RPT4 format: Octave (1B), Volume (1B), Song Length (2B), BPM (2B), Custom Bank (2816B)
-        read(fd, &current_octave, 1);
-        read(fd, &current_volume, 1);
-        read(fd, &song_length, 2);
-        read(fd, &loaded_bpm, 2);
-        read(fd, user_bank, sizeof(user_bank));
-    } else if (head[3] == '3') {
-        // RPT3 format: Octave (1B), Volume (1B), Song Length (2B), BPM (2B)
+    if (ld_version == '5' || ld_version == '6') {
+        // RPT5/6 format: same 6-byte header as RPT4, then sparse data (see above)
         read(fd, &current_octave, 1);
         read(fd, &current_volume, 1);
         read(fd, &song_length, 2);
-        read(fd, &loaded_bpm, 2);
-        memcpy(user_bank, gm_bank, sizeof(user_bank));
+        read(fd, &ld_bpm, 2);
+        load_rpt5_tables();
+        pattern_cache_reset(false); // Everything not in the bitmap is empty
+        pattern_extent = 0;
+        ld_total = (ld_version == '6') ? MAX_PATTERNS : RPT4_PATTERNS;
     } else {
-        // RPT2 / RPT1 format: Octave (1B), Volume (1B), Song Length (2B), default BPM = 150
-        read(fd, &current_octave, 1);
-        read(fd, &current_volume, 1);
-        read(fd, &song_length, 2);
-        loaded_bpm = 150;
-        memcpy(user_bank, gm_bank, sizeof(user_bank));
+        if (ld_version == '4') {
+            // RPT4 format: Octave (1B), Volume (1B), Song Length (2B), BPM (2B), Custom Bank (2816B)
+            read(fd, &current_octave, 1);
+            read(fd, &current_volume, 1);
+            read(fd, &song_length, 2);
+            read(fd, &ld_bpm, 2);
+            read(fd, user_bank, sizeof(user_bank));
+        } else if (ld_version == '3') {
+            // RPT3 format: Octave (1B), Volume (1B), Song Length (2B), BPM (2B)
+            read(fd, &current_octave, 1);
+            read(fd, &current_volume, 1);
+            read(fd, &song_length, 2);
+            read(fd, &ld_bpm, 2);
+            gm_bank_copy(user_bank);
+        } else {
+            // RPT2 / RPT1 format: Octave (1B), Volume (1B), Song Length (2B), default BPM = 150
+            read(fd, &current_octave, 1);
+            read(fd, &current_volume, 1);
+            read(fd, &song_length, 2);
+            gm_bank_copy(user_bank);
+        }
+        // Patterns ($0000) and Sequence List ($B400) are one contiguous block,
+        // read straight into pattern slots 0-31
+        pattern_cache_reset(true);
+        pattern_extent = RPT4_PATTERNS;
+        ld_total = LOAD_BULK_SIZE;
     }
 
-    // 2. Load bulk data directly into XRAM
-    read_xram_loop(0x0000, 0xB400, fd); // Patterns
-    read_xram_loop(0xB400, 0x0100, fd); // Sequence List
+    is_loading = true;
+    draw_load_progress();
+    return true;
+}
 
-    close(fd); // Close file immediately after reading
+static void load_song_finish(void) {
+    close(ld_fd); // Close file immediately after reading
+    ld_fd = -1;
+    is_loading = false;
 
     // 3. UPDATE LOGICAL STATE BEFORE UI REFRESH
     cur_order_idx = 0;
     cur_pattern = read_order_xram(0); 
     cur_row = 0;
-    set_bpm((uint8_t)loaded_bpm);
+    set_bpm((uint8_t)ld_bpm);
     select_instrument(current_instrument);
 
     // 4. SYNC GLOBALS
-    strncpy(active_filename, filename, 63);
-    active_filename[63] = '\0';
+    strcpy(active_filename, ld_filename);
+
+    // Memory now matches the file; AUTOSAVE.RPT no longer matches memory
+    memset(save_dirty_pats, 0, sizeof(save_dirty_pats));
+    save_dirty_flags = 0;
+    active_is_rpt4 = (ld_version == '4');
+    autosave_reset();
+    undo_reset(); // Old edits point into the previous song
 
-    // 5. SINGLE UI REFRESH (Clears dialog and draws new data in one burst)
+    // 5. SINGLE UI REFRESH (Clears progress box and draws new data in one burst)
     refresh_all_ui(); 
     
-    printf("Loaded: %s (BPM: %d)\n", active_filename, loaded_bpm);
+    printf("Loaded: %s (BPM: %d)\n", active_filename, ld_bpm);
+}
+
+// Reads the macro block that follows the last extension pattern. Files
+// without one end there, and read as no macros.
+static void load_rpt4_macros(void) {
+    io_fd = ld_fd;
+    io_len = 0;
+    io_pos = 0;
+    load_macros();
+}
+
+void load_task(void) {
+    if (!is_loading) return;
+
+    // 2. Load bulk data directly into XRAM, one chunk per frame
+    if (ld_version == '5' || ld_version == '6') {
+        // One stored pattern per frame (absent ones are skipped for free)
+        while (ld_pos < ld_total && !(ld_bitmap[ld_pos >> 3] & (1 << (ld_pos & 7)))) {
+            ld_pos++;
+        }
+        if (ld_pos < ld_total) {
+            load_pattern_rle((uint8_t)ld_pos);
+            pattern_extent = ld_pos + 1;
+            ld_pos++;
+        }
+    } else if (ld_ext_pat < ld_ext_end) {
+        // AUTOSAVE.RPT extension: patterns 32+ follow the order list
+        uint16_t addr = pattern_slot_addr((uint8_t)ld_ext_pat);
+        uint16_t got = 0;
+        while (got < PATTERN_SIZE) {
+            int n = read_xram(addr + got, PATTERN_SIZE - got, ld_fd);
+            if (n <= 0) break;
+            got += (uint16_t)n;
+        }
+        pattern_cache_mark_dirty((uint8_t)ld_ext_pat);
+        pattern_extent = ++ld_ext_pat;
+        if (ld_ext_pat >= ld_ext_end) {
+            load_rpt4_macros();
+            load_song_finish();
+        }
+        return;
+    } else {
+        uint16_t n = ld_total - ld_pos;
+        if (n > LOAD_CHUNK) n = LOAD_CHUNK;
+        int got = read_xram(ld_pos, n, ld_fd);
+        // A short file leaves the rest of XRAM as it was
+        ld_pos = (got > 0) ? ld_pos + (uint16_t)got : ld_total;
+
+        // Only RPT4 (autosave) files carry extension patterns and macros
+        if (ld_pos >= ld_total && got > 0 && ld_version == '4') {
+            long end = lseek(ld_fd, 0, SEEK_END);
+            lseek(ld_fd, RPT4_EXT_OFFSET, SEEK_SET);
+            if (end >= RPT4_EXT_OFFSET + (long)PATTERN_SIZE) {
+                long count = (end - RPT4_EXT_OFFSET) / PATTERN_SIZE;
+                if (count > MAX_PATTERNS - RPT4_PATTERNS) count = MAX_PATTERNS - RPT4_PATTERNS;
+                ld_ext_pat = RPT4_PATTERNS;
+                ld_ext_end = RPT4_PATTERNS + (uint16_t)count;
+                return;
+            }
+            load_rpt4_macros();
+        }
+    }
+
+    if (ld_pos >= ld_total) {
+        if (ld_version == '5' || ld_version == '6') load_macros();
+        load_song_finish();
+    } else {
+        draw_load_progress();
+    }
+}
+
+// Blocking load, for the command line and the host tools
+void load_song(const char* filename) {
+    if (!load_song_begin(filename)) return;
+    while (is_loading) {
+        load_task();
+    }
+}
+
+// ============================================================================
+// SONG INFO
+// ============================================================================
+// Reads just the header and order list of a song file, for the browser.
+// "Patterns used" counts the distinct patterns the order list plays.
+
+bool read_song_info(const char* filename, SongInfo* info) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+
+    char head[4];
+    uint8_t meta[6]; // Octave, Volume, Song Length (2B), BPM (2B)
+    if (read(fd, head, 4) != 4 || head[0] != 'R' || read(fd, meta, 6) < 4) {
+        close(fd);
+        return false;
+    }
+
+    info->length = meta[2] | ((uint16_t)meta[3] << 8);
+    info->bpm = (head[3] >= '3') ? (meta[4] | ((uint16_t)meta[5] << 8)) : 150;
+    if (info->length > MAX_ORDERS) info->length = MAX_ORDERS;
+
+    // Find the order list
+    long order_offset;
+    if (head[3] == '5' || head[3] == '6') {
+        uint8_t count[2];
+        read(fd, count, 2);
+        order_offset = 12 + (long)(count[0] | ((uint16_t)count[1] << 8)) * (1 + sizeof(OPL_Patch));
+    } else if (head[3] == '4') {
+        order_offset = RPT4_ORDER_OFFSET;
+    } else if (head[3] == '3') {
+        order_offset = 10 + (long)ORDER_LIST_XRAM;
+    } else {
+        order_offset = 8 + (long)ORDER_LIST_XRAM;
+    }
+    lseek(fd, order_offset, SEEK_SET);
+
+    uint8_t seen[MAX_PATTERNS / 8] = {0};
+    uint8_t buf[32];
+    info->used = 0;
+    for (uint16_t i = 0; i < info->length; i += sizeof(buf)) {
+        uint16_t n = info->length - i;
+        if (n > sizeof(buf)) n = sizeof(buf);
+        if (read(fd, buf, n) != n) break;
+        for (uint8_t j = 0; j < n; j++) {
+            uint8_t bit = (uint8_t)(1 << (buf[j] & 7));
+            if (!(seen[buf[j] >> 3] & bit)) {
+                seen[buf[j] >> 3] |= bit;
+                info->used++;
+            }
+        }
+    }
+
+    close(fd);
+    return true;
+}
+
+// ============================================================================
+// AUTOSAVE
+// ============================================================================
+// Once something is dirty, AUTOSAVE_FRAMES later the changed regions are
+// written to AUTOSAVE.RPT (RPT4 layout), one region per frame and only while
+// the sequencer is stopped, so the UI never stalls on a full save. The first
+// pass of a session (or after a load) writes the whole file. The macro block
+// is small and goes at the end of every pass, behind however many patterns
+// the file holds by then.
+
+enum {
+    AS_IDLE,
+    AS_BANK,
+    AS_PATTERNS,
+    AS_ORDER,
+    AS_MACROS
+};
+
+static uint8_t as_state = AS_IDLE;
+static int as_fd = -1;
+static bool as_file_valid = false;  // AUTOSAVE.RPT holds a complete song
+static uint8_t as_pats[MAX_PATTERNS / 8];
+static uint8_t as_flags = 0;
+static uint16_t as_next_pat = 0;
+static uint16_t as_pat_limit = 0;   // RPT4's 32 patterns, or up to the extent
+
+void autosave_reset(void) {
+    if (as_fd >= 0) close(as_fd);
+    as_fd = -1;
+    as_state = AS_IDLE;
+    as_file_valid = false;
+    memset(autosave_dirty_pats, 0, sizeof(autosave_dirty_pats));
+    autosave_dirty_flags = 0;
+    autosave_pending = false;
+    autosave_timer = 0;
+}
+
+static void autosave_begin(void) {
+    // Take this pass's work; edits from now on mark the next pass
+    memcpy(as_pats, autosave_dirty_pats, sizeof(as_pats));
+    as_flags = autosave_dirty_flags;
+    memset(autosave_dirty_pats, 0, sizeof(autosave_dirty_pats));
+    autosave_dirty_flags = 0;
+    autosave_pending = false;
+
+    // A stale or missing file gets everything
+    if (!as_file_valid) {
+        memset(as_pats, 0xFF, sizeof(as_pats));
+        as_flags = DIRTY_ALL;
+    }
+    as_pat_limit = (pattern_extent > RPT4_PATTERNS) ? pattern_extent : RPT4_PATTERNS;
+
+    if (as_file_valid) {
+        as_fd = open(AUTOSAVE_FILENAME, O_WRONLY);
+    } else {
+        as_fd = open(AUTOSAVE_FILENAME, O_WRONLY | O_CREAT | O_TRUNC);
+    }
+    if (as_fd < 0) {
+        // Try again next interval, rewriting everything
+        autosave_reset();
+        autosave_pending = true;
+        return;
+    }
+
+    as_file_valid = false; // Until this pass completes
+    rpt4_write_header(as_fd);
+    as_next_pat = 0;
+    as_state = AS_BANK;
+}
+
+void autosave_task(void) {
+    if (as_state == AS_IDLE) {
+        if (!autosave_pending) return;
+        if (autosave_timer < AUTOSAVE_FRAMES) {
+            autosave_timer++;
+            return;
+        }
+    }
+
+    // Disk writes only happen on idle frames
+    if (seq.is_playing || is_dialog_active) return;
+
+    switch (as_state) {
+        case AS_IDLE:
+            autosave_begin();
+            break;
+
+        case AS_BANK:
+            if (as_flags & DIRTY_PATCHES) rpt4_write_bank(as_fd);
+            as_state = AS_PATTERNS;
+            break;
+
+        case AS_PATTERNS:
+            // One pattern (1440 bytes) per frame
+            while (as_next_pat < as_pat_limit &&
+                   !(as_pats[as_next_pat >> 3] & (1 << (as_next_pat & 7)))) {
+                as_next_pat++;
+            }
+            if (as_next_pat < as_pat_limit) {
+                rpt4_write_pattern(as_fd, (uint8_t)as_next_pat++);
+            } else {
+                as_state = AS_ORDER;
+            }
+            break;
+
+        case AS_ORDER:
+            if (as_flags & DIRTY_META) rpt4_write_order(as_fd);
+            as_state = AS_MACROS;
+            break;
+
+        case AS_MACROS:
+            rpt4_write_macros(as_fd, as_pat_limit);
+            close(as_fd);
+            as_fd = -1;
+            as_file_valid = true;
+            as_state = AS_IDLE;
+            autosave_timer = 0;
+            printf("Autosaved: %s\n", AUTOSAVE_FILENAME);
+            break;
+    }
 }
 
 void handle_filename_input() {
@@ -204,9 +922,10 @@ void handle_filename_input() {
     draw_string(box_x + 2, box_y + 2, dialog_buffer, HUD_COL_YELLOW, HUD_COL_BG);
 
     // 2. Handle Keyboard Edges
-    // We scan all keys to see if a new character was pressed
-    for (uint16_t k = 0; k < 256; k++) {
-        if (key_pressed(k)) {
+    // Every key that went down this frame, in the order handle_input found them
+    for (uint8_t e = 0; e < key_event_count; e++) {
+        uint8_t k = key_events[e].code;
+        if (key_events[e].down) {
             // Check for Characters
             char c = scancode_to_ascii(k);
             if (c != 0 && dialog_pos < 12) { // 12 chars max for 8.3 + safety
@@ -229,11 +948,19 @@ void handle_filename_input() {
 
             // Check for Confirm
             if (k == KEY_ENTER) {
-                if (is_saving) save_song(dialog_buffer);
-                else load_song(dialog_buffer);
-                
                 is_dialog_active = false;
                 refresh_all_ui(); // Clear the box and restore the dashboard
+
+                // Loading continues in load_task() over the next frames
+                if (is_library_dialog) {
+                    if (is_saving) library_save(dialog_buffer);
+                    else library_open(dialog_buffer);
+                } else if (is_saving) {
+                    save_song(dialog_buffer);
+                } else {
+                    load_song_begin(dialog_buffer);
+                }
+                
                 //draw_ui_dashboard();
                 return;
             }
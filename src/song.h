@@ -1,7 +1,7 @@
 #ifndef SONG_H
 #define SONG_H
 
-#define ORDER_LIST_XRAM 0xB400  // 32 patterns × 1440 bytes = 0xB400
+#define ORDER_LIST_XRAM 0xB400  // 32 pattern slots × 1440 bytes = 0xB400
 #define MAX_ORDERS 256 // Note, the user is limited to 64 in the UI, so we could grow in the future.
 #define MAX_ORDERS_USER 64
 
@@ -15,13 +15,38 @@ extern char active_filename[64]; // Current loaded filename
 extern uint8_t dialog_pos;
 
 extern void update_order_display();
+extern void order_display_invalidate(void);
 extern uint8_t read_order_xram(uint8_t index);
 extern void write_order_xram(uint8_t index, uint8_t pattern_id);
 extern void handle_filename_input();
 extern char scancode_to_ascii(uint8_t scancode);
+extern bool is_loading;
 extern void load_song(const char* filename);
+extern bool load_song_begin(const char* filename);
+extern void load_task(void);
 extern void save_song(const char* filename);
 
+typedef struct {
+    uint16_t bpm;
+    uint16_t length;    // Orders
+    uint16_t used;      // Distinct patterns in the order list
+} SongInfo;
+
+extern bool read_song_info(const char* filename, SongInfo* info);
+
+// Dirty tracking for incremental save and autosave
+#define DIRTY_META      0x01  // Order list, song length, BPM
+#define DIRTY_PATCHES   0x02  // user_bank
+#define DIRTY_ALL       (DIRTY_META | DIRTY_PATCHES)
+
+#define AUTOSAVE_FILENAME "AUTOSAVE.RPT"
+#define AUTOSAVE_FRAMES   (60 * 60)  // ~1 minute after the first unsaved change
+
+extern void mark_pattern_dirty(uint8_t pat);
+extern void mark_song_dirty(uint8_t flags);
+extern void autosave_task(void);
+extern void autosave_reset(void);
+
 // Picocomputer OS Call Registers (Device 0, Channel 0)
 #define TRK_READ_XRAM  0x31
 #define TRK_WRITE_XRAM 0x32
@@ -0,0 +1,204 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "constants.h"
+#include "midi.h"
+#include "midiout.h"
+#include "player.h"
+#include "screen.h"
+#include "song.h"
+#include "sync.h"
+
+uint8_t sync_mode = SYNC_INTERNAL;
+
+static uint16_t sync_frame = 0;     // Counts frames; clock arrivals are timed in frames
+
+// ============================================================================
+// CLOCK IN
+// ============================================================================
+// Tempo comes from the frames between row boundaries four rows (one beat)
+// apart, smoothed so a clock landing a frame early or late moves it only a
+// little. Each row boundary also nudges the sequencer's tick counter halfway
+// toward the clock, so the song cannot drift however long it runs.
+
+static uint8_t clock_count = 0;     // Clocks since the last row boundary
+static uint16_t row_frames[4];      // Frame of each of the last four row boundaries
+static uint8_t row_slot = 0;
+static uint8_t rows_seen = 0;
+static uint16_t beat_fp = 0;        // Smoothed frames per beat, 8.8 (0 = not measured)
+static bool start_pending = false;  // Start/Continue begins on the next clock
+
+static void measure_row(void) {
+    uint16_t beat = sync_frame - row_frames[row_slot]; // Four rows ago
+    row_frames[row_slot] = sync_frame;
+    row_slot = (row_slot + 1) & 3;
+
+    if (rows_seen < 4) {
+        rows_seen++;
+        return;
+    }
+    if (beat < 15 || beat > 60) {
+        // Outside 60-240 BPM: a gap in the clock, start measuring again
+        rows_seen = 1;
+        return;
+    }
+
+    uint16_t sample = beat << 8;
+    if (beat_fp == 0) {
+        beat_fp = sample;
+    } else {
+        beat_fp += ((int16_t)sample - (int16_t)beat_fp) / (1 << SYNC_SMOOTH);
+    }
+
+    seq.ticks_per_row_fp = beat_fp / 4;
+    update_lfo_scaler();
+    uint8_t bpm = (uint8_t)(921600L / beat_fp); // 3600 frames/min * 256
+    if (bpm != seq.bpm) {
+        seq.bpm = bpm;
+        queue_update_dashboard();
+    }
+}
+
+// The row should trigger on this frame's sequencer step. The counter never
+// crosses the last-tick threshold, where play_row has already moved on.
+static void lock_phase(void) {
+    int16_t ticks = (int16_t)seq.ticks_per_row_fp;
+    int16_t edge = ticks - TICK_SCALE;
+    int16_t c = (int16_t)seq.tick_counter_fp;
+    int16_t err = c + TICK_SCALE - ticks;   // > 0: ahead of the clock
+    if (err < -ticks / 2) err += ticks;
+
+    int16_t fixed = c - err / 2;
+    if (c < edge && fixed >= edge) fixed = edge - 1;
+    if (fixed < 0) fixed = 0;
+    seq.tick_counter_fp = (uint16_t)fixed;
+}
+
+void sync_clock_in(void) {
+    if (sync_mode != SYNC_EXTERNAL) return;
+
+    if (start_pending) {
+        start_pending = false;
+        clock_count = 0;
+        measure_row();
+        transport_play();
+        return;
+    }
+    if (++clock_count < CLOCKS_PER_ROW) return;
+    clock_count = 0;
+    measure_row();
+    if (seq.is_playing) lock_phase();
+}
+
+void sync_start_in(void) {
+    if (sync_mode != SYNC_EXTERNAL) return;
+    transport_locate(0);
+    start_pending = true;
+}
+
+void sync_continue_in(void) {
+    if (sync_mode != SYNC_EXTERNAL) return;
+    start_pending = true;
+}
+
+void sync_stop_in(void) {
+    if (sync_mode != SYNC_EXTERNAL) return;
+    start_pending = false;
+    if (seq.is_playing) transport_stop();
+}
+
+// Song Position Pointer counts 16th notes, which are rows here
+void sync_song_position_in(uint16_t pos) {
+    if (sync_mode != SYNC_EXTERNAL || seq.is_playing) return;
+    transport_locate(pos);
+}
+
+// ============================================================================
+// CLOCK OUT
+// ============================================================================
+// Clocks are derived from the sequencer's own tick counter, so they stay
+// locked to the rows through tempo changes. Sent only while playing, and
+// queued with the playback messages so it all leaves in one write.
+
+static bool sent_playing = false;
+static uint8_t clocks_in_row = 0;   // Clocks sent since the current row began
+static uint16_t last_counter = 0;
+
+static void send_clock_out(void) {
+    if (seq.is_playing != sent_playing) {
+        sent_playing = seq.is_playing;
+        if (!sent_playing) {
+            midi_out_realtime(0xFC);
+        } else {
+            uint16_t rows = play_row;
+            if (is_song_mode) rows += (uint16_t)cur_order_idx * 32;
+            if (rows == 0) {
+                midi_out_realtime(0xFA);
+            } else {
+                midi_out_song_position(rows);
+                midi_out_realtime(0xFB);
+            }
+            clocks_in_row = 0;
+            last_counter = seq.tick_counter_fp;
+        }
+    }
+
+    if (sent_playing) {
+        uint16_t c = seq.tick_counter_fp;
+        if (c < last_counter) {
+            // A row triggered on this step: finish the one before it
+            while (clocks_in_row < CLOCKS_PER_ROW) {
+                midi_out_realtime(0xF8);
+                clocks_in_row++;
+            }
+            clocks_in_row = 0;
+        }
+        last_counter = c;
+
+        uint8_t due = 1 + (uint8_t)(((uint32_t)c * CLOCKS_PER_ROW) / seq.ticks_per_row_fp);
+        if (due > CLOCKS_PER_ROW) due = CLOCKS_PER_ROW;
+        while (clocks_in_row < due) {
+            midi_out_realtime(0xF8);
+            clocks_in_row++;
+        }
+    }
+}
+
+void sync_task(void) {
+    sync_frame++;
+    if (sync_mode == SYNC_SEND) send_clock_out();
+}
+
+// ============================================================================
+// MODE
+// ============================================================================
+
+void sync_cycle_mode(void) {
+    // Leaving a mode
+    if (sync_mode == SYNC_SEND) {
+        if (sent_playing) midi_out_realtime(0xFC);
+        midi_out_close();
+    } else if (sync_mode == SYNC_EXTERNAL) {
+        start_pending = false;
+        set_bpm(seq.bpm); // Back to a whole-BPM tempo of our own
+    }
+
+    sync_mode = (sync_mode + 1) % SYNC_MODES;
+
+    if (sync_mode == SYNC_EXTERNAL) {
+        rows_seen = 0;
+        clock_count = 0;
+        beat_fp = 0;
+        printf("Sync: MIDI clock in\n");
+    } else if (sync_mode == SYNC_SEND) {
+        if (!midi_out_open(MIDI_DEVICE)) {
+            sync_mode = SYNC_INTERNAL;
+        } else {
+            sent_playing = false;
+            printf("Sync: MIDI clock out\n");
+        }
+    }
+    if (sync_mode == SYNC_INTERNAL) printf("Sync: internal\n");
+    update_dashboard();
+}
@@ -0,0 +1,31 @@
+#ifndef SYNC_H
+#define SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// MIDI clock sync. A row is a 16th note, so 24 PPQN clock gives six clocks
+// per row and Song Position Pointer counts rows directly.
+#define SYNC_INTERNAL  0   // Own tempo (F7), MIDI clock ignored
+#define SYNC_EXTERNAL  1   // Follow incoming clock, Start, Stop and Continue
+#define SYNC_SEND      2   // Own tempo, sent out as clock and transport
+#define SYNC_MODES     3
+
+#define CLOCKS_PER_ROW 6
+#define SYNC_SMOOTH    3   // Tempo follows 1/(1 << SYNC_SMOOTH) of each new measurement
+
+extern uint8_t sync_mode;
+
+extern void sync_cycle_mode(void);
+
+// Real-time messages from midi.c
+extern void sync_clock_in(void);
+extern void sync_start_in(void);
+extern void sync_continue_in(void);
+extern void sync_stop_in(void);
+extern void sync_song_position_in(uint16_t pos);
+
+// Once per frame, after the sequencer step
+extern void sync_task(void);
+
+#endif // SYNC_H
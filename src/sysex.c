@@ -0,0 +1,309 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "constants.h"
+#include "instruments.h"
+#include "midi.h"
+#include "midiout.h"
+#include "patterns.h"
+#include "player.h"
+#include "screen.h"
+#include "song.h"
+#include "sysex.h"
+#include "undo.h"
+
+#define SYSEX_HEADER_SIZE 8  // ID (3), command, first (2), count (2)
+#define SYSEX_UNDO_CHUNK  60 // Pattern bytes per undo record
+
+// ============================================================================
+// RECEIVE
+// ============================================================================
+// Patches are staged and only reach user_bank when the whole message is in
+// and its checksum is right, as one undo record. Patterns are too big to
+// stage: each decoded byte is written where it belongs, keeping the old
+// bytes of the current 60-byte chunk for undo.
+//
+// Every byte after the header is held back one byte, so the checksum before
+// F7 never reaches the unpacker.
+
+enum { SX_HEADER, SX_DATA, SX_IGNORE };
+
+static uint8_t sx_state = SX_IGNORE;
+static uint8_t sx_head[SYSEX_HEADER_SIZE];
+static uint8_t sx_have = 0;         // Header bytes received
+static uint8_t sx_pack_pos = 0;     // 0 = next byte holds the high bits
+static uint8_t sx_pack_msb = 0;
+static uint8_t sx_sum = 0;          // Command byte onwards, checksum included
+static uint8_t sx_held = 0;         // Last byte, data unless F7 follows
+static bool sx_holding = false;
+
+static uint8_t sx_cmd = 0;
+static uint16_t sx_first = 0;
+static uint16_t sx_count = 0;
+static uint16_t sx_items = 0;       // Items stored
+static uint16_t sx_offset = 0;      // Byte within the current item
+
+static OPL_Patch sx_patches[SYSEX_PATCH_MAX];
+static uint8_t sx_old_chunk[SYSEX_UNDO_CHUNK];
+
+// Records the chunk of the current pattern that ends at sx_offset
+static void sx_close_chunk(void) {
+    uint8_t pat = (uint8_t)(sx_first + sx_items);
+    uint16_t start = (sx_offset - 1) - (sx_offset - 1) % SYSEX_UNDO_CHUNK;
+    uint8_t len = (uint8_t)(sx_offset - start);
+    uint8_t new_chunk[SYSEX_UNDO_CHUNK];
+
+    RIA.addr0 = pattern_slot_addr(pat) + start;
+    RIA.step0 = 1;
+    for (uint8_t i = 0; i < len; i++) new_chunk[i] = RIA.rw0;
+    undo_record(UNDO_PATTERN, pat, start, sx_old_chunk, new_chunk, len);
+    mark_pattern_dirty(pat);
+}
+
+static void sx_store(uint8_t b) {
+    if (sx_items >= sx_count) return; // Past the announced count
+
+    if (sx_cmd == SYSEX_PATCH_DUMP) {
+        ((uint8_t *)&sx_patches[sx_items])[sx_offset] = b;
+        if (++sx_offset == sizeof(OPL_Patch)) {
+            sx_offset = 0;
+            sx_items++;
+        }
+    } else {
+        // Readdressed every byte: real-time messages can be dispatched, and
+        // the pattern paged, between any two of them
+        uint16_t addr = pattern_slot_addr((uint8_t)(sx_first + sx_items)) + sx_offset;
+        RIA.addr0 = addr;
+        RIA.step0 = 1;
+        sx_old_chunk[sx_offset % SYSEX_UNDO_CHUNK] = RIA.rw0;
+        RIA.addr0 = addr;
+        RIA.rw0 = b;
+        if (++sx_offset % SYSEX_UNDO_CHUNK == 0) sx_close_chunk();
+        if (sx_offset == PATTERN_SIZE) {
+            sx_offset = 0;
+            sx_items++;
+        }
+    }
+}
+
+static bool sx_start_dump(void) {
+    uint16_t limit = (sx_cmd == SYSEX_PATTERN_DUMP) ? MAX_PATTERNS : 256;
+    if (sx_first >= limit) return false;
+    if (sx_cmd == SYSEX_PATCH_DUMP) {
+        // All or nothing: a dump that would not fit is not taken at all
+        if (sx_count > SYSEX_PATCH_MAX || sx_count > limit - sx_first) {
+            printf("SysEx: patch dump of %u from %02X refused\n", sx_count, sx_first);
+            return false;
+        }
+        return true;
+    }
+    if (sx_count > limit - sx_first) sx_count = limit - sx_first;
+    undo_group_begin();
+    return true;
+}
+
+// Copies the staged patches into user_bank, as one undo record
+static void sx_apply_patches(void) {
+    uint8_t len = (uint8_t)(sx_items * sizeof(OPL_Patch));
+    undo_record(UNDO_PATCH, (uint8_t)sx_first, 0, (const uint8_t *)&user_bank[sx_first],
+                (const uint8_t *)sx_patches, len);
+    memcpy(&user_bank[sx_first], sx_patches, len);
+    mark_song_dirty(DIRTY_PATCHES);
+    if ((uint16_t)(current_instrument - sx_first) < sx_items) {
+        select_instrument(current_instrument);
+        OPL_SetPatch(cur_channel, &active_patch);
+    }
+}
+
+void sysex_begin(void) {
+    sx_state = SX_HEADER;
+    sx_have = 0;
+    sx_pack_pos = 0;
+    sx_sum = 0;
+    sx_holding = false;
+    sx_items = 0;
+    sx_offset = 0;
+}
+
+static void sx_data(uint8_t b) {
+    // Unpack 7-in-8
+    if (sx_pack_pos == 0) {
+        sx_pack_msb = b;
+        sx_pack_pos = 1;
+        return;
+    }
+    b |= (uint8_t)(((sx_pack_msb >> (sx_pack_pos - 1)) & 1) << 7);
+    sx_pack_pos = (sx_pack_pos + 1) & 7;
+    if (sx_cmd == SYSEX_PATCH_DUMP || sx_cmd == SYSEX_PATTERN_DUMP) sx_store(b);
+}
+
+void sysex_byte(uint8_t b) {
+    if (sx_state == SX_HEADER) {
+        if (sx_have >= 3) sx_sum += b;
+        sx_head[sx_have++] = b;
+        if (sx_have == 3 && (sx_head[0] != SYSEX_ID || sx_head[1] != SYSEX_ID_R || sx_head[2] != SYSEX_ID_T)) {
+            sx_state = SX_IGNORE; // Someone else's SysEx
+        } else if (sx_have == SYSEX_HEADER_SIZE) {
+            sx_cmd = sx_head[3];
+            sx_first = sx_head[4] | ((uint16_t)sx_head[5] << 7);
+            sx_count = sx_head[6] | ((uint16_t)sx_head[7] << 7);
+            if (sx_cmd == SYSEX_PATCH_DUMP || sx_cmd == SYSEX_PATTERN_DUMP) {
+                sx_state = sx_start_dump() ? SX_DATA : SX_IGNORE;
+            } else {
+                sx_state = SX_DATA; // Requests carry no data; served at F7
+            }
+        }
+        return;
+    }
+    if (sx_state != SX_DATA) return;
+
+    sx_sum += b;
+    if (sx_holding) sx_data(sx_held);
+    sx_held = b;
+    sx_holding = true;
+}
+
+// ============================================================================
+// SEND
+// ============================================================================
+// Replies go out through midiout in small pieces, packed as they are read.
+
+static uint8_t tx_buf[64];
+static uint8_t tx_len = 0;
+static uint8_t tx_group[7];         // Data bytes waiting for their high-bit byte
+static uint8_t tx_group_len = 0;
+static uint8_t tx_sum = 0;
+
+static void tx_put(uint8_t b) {
+    if (tx_len == sizeof(tx_buf)) {
+        midi_out_sysex(tx_buf, tx_len);
+        tx_len = 0;
+    }
+    tx_buf[tx_len++] = b;
+    tx_sum += b;
+}
+
+static void tx_flush_group(void) {
+    uint8_t msb = 0;
+    for (uint8_t i = 0; i < tx_group_len; i++) msb |= (uint8_t)((tx_group[i] >> 7) << i);
+    tx_put(msb);
+    for (uint8_t i = 0; i < tx_group_len; i++) tx_put(tx_group[i] & 0x7F);
+    tx_group_len = 0;
+}
+
+static void tx_data(uint8_t b) {
+    tx_group[tx_group_len++] = b;
+    if (tx_group_len == sizeof(tx_group)) tx_flush_group();
+}
+
+static void tx_begin(uint8_t cmd, uint16_t first, uint16_t count) {
+    tx_len = 0;
+    tx_group_len = 0;
+    tx_put(0xF0);
+    tx_put(SYSEX_ID);
+    tx_put(SYSEX_ID_R);
+    tx_put(SYSEX_ID_T);
+    tx_sum = 0;
+    tx_put(cmd);
+    tx_put(first & 0x7F);
+    tx_put((first >> 7) & 0x7F);
+    tx_put(count & 0x7F);
+    tx_put((count >> 7) & 0x7F);
+}
+
+static void tx_end(void) {
+    if (tx_group_len) tx_flush_group();
+    tx_put((uint8_t)(-tx_sum) & 0x7F);
+    tx_put(0xF7);
+    midi_out_sysex(tx_buf, tx_len);
+}
+
+static void sx_send_ack(uint8_t cmd, uint16_t count) {
+    if (!midi_out_open(MIDI_DEVICE)) return;
+    tx_begin(SYSEX_ACK, cmd, count);
+    tx_end();
+    midi_out_close();
+}
+
+static void sx_send_dump(bool patterns) {
+    uint16_t limit = patterns ? MAX_PATTERNS : 256;
+    if (sx_first >= limit) return;
+    if (sx_count > limit - sx_first) sx_count = limit - sx_first;
+    if (!midi_out_open(MIDI_DEVICE)) return;
+
+    tx_begin(patterns ? SYSEX_PATTERN_DUMP : SYSEX_PATCH_DUMP, sx_first, sx_count);
+    for (uint16_t n = 0; n < sx_count; n++) {
+        if (patterns) {
+            uint8_t pat = (uint8_t)(sx_first + n);
+            uint16_t addr = pattern_slot_addr(pat);
+            for (uint16_t i = 0; i < PATTERN_SIZE; i++) {
+                RIA.addr0 = addr + i; // Not stepped: sending may touch XRAM
+                tx_data(RIA.rw0);
+            }
+        } else {
+            const uint8_t *p = (const uint8_t *)&user_bank[sx_first + n];
+            for (uint8_t i = 0; i < sizeof(OPL_Patch); i++) tx_data(p[i]);
+        }
+    }
+    tx_end();
+    midi_out_close();
+    printf("SysEx: sent %u %s from %02X\n", sx_count, patterns ? "patterns" : "patches", sx_first);
+}
+
+// ============================================================================
+// MESSAGE END
+// ============================================================================
+
+void sysex_end(bool complete) {
+    uint8_t state = sx_state;
+    sx_state = SX_IGNORE;
+    if (state == SX_IGNORE) return;
+    if (state == SX_HEADER) {
+        if (sx_have >= 3) printf("SysEx: message cut short\n");
+        return;
+    }
+
+    bool sum_ok = complete && sx_holding && (sx_sum & 0x7F) == 0;
+    bool whole = sum_ok && sx_items == sx_count && !sx_offset;
+
+    switch (sx_cmd) {
+        case SYSEX_PATCH_DUMP:
+            if (whole) {
+                sx_apply_patches();
+                printf("SysEx: %u patches from %02X\n", sx_items, sx_first);
+            } else {
+                sx_items = 0;
+                printf("SysEx: patch dump %s, nothing stored\n", (complete && !sum_ok) ? "corrupt" : "cut short");
+            }
+            sx_send_ack(sx_cmd, sx_items);
+            refresh_all_ui();
+            break;
+        case SYSEX_PATTERN_DUMP:
+            if (sx_offset % SYSEX_UNDO_CHUNK) sx_close_chunk();
+            if (complete && !sum_ok) {
+                // Arrived whole but damaged: take it back rather than keep it
+                bool undone = undo_group_abort();
+                printf("SysEx: pattern dump corrupt, %s\n",
+                       undone ? "nothing stored" : "too large to take back");
+                sx_items = 0;
+            } else {
+                undo_group_end();
+                if (whole) {
+                    printf("SysEx: %u patterns from %02X\n", sx_items, sx_first);
+                } else {
+                    printf("SysEx: pattern dump cut short, %u of %u stored\n", sx_items, sx_count);
+                }
+            }
+            sx_send_ack(sx_cmd, sx_items);
+            refresh_all_ui();
+            break;
+        case SYSEX_PATCH_REQUEST:
+            if (sum_ok) sx_send_dump(false);
+            break;
+        case SYSEX_PATTERN_REQUEST:
+            if (sum_ok) sx_send_dump(true);
+            break;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef SYSEX_H
+#define SYSEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// SysEx bulk transfer of user_bank patches and patterns over MIDI0:
+//
+//   F0 7D 52 54 cmd first_lo first_hi count_lo count_hi [data] sum F7
+//
+// 7D is the non-commercial manufacturer ID and 52 54 is "RT". first and
+// count are 14-bit, low 7 bits first. Dump data is count items back to back
+// (11-byte OPL_Patch or PATTERN_SIZE pattern), packed 7-in-8: a byte of high
+// bits (bit n for data byte n), then up to 7 bytes of low bits. sum makes
+// the bytes from cmd to sum add up to 0 in their low 7 bits.
+//
+// A patch dump carries at most SYSEX_PATCH_MAX patches. It is stored only
+// when the whole message has arrived with a good sum, as one undo step;
+// anything less leaves user_bank alone. Pattern dumps are stored as they
+// arrive, straight into the pattern's XRAM slot. A pattern dump that arrives
+// whole with a bad sum is taken back; one cut short keeps what arrived. Either
+// way the message is one undo step, if it fits in the undo ring (a dense
+// pattern does not): a larger one cannot be undone or taken back. Every dump
+// is answered with an ACK whose count is the items stored and good (0 for a
+// bad sum); requests with a good sum are answered with a dump.
+// tools/sysex.py speaks the same protocol from a PC.
+#define SYSEX_ID              0x7D
+#define SYSEX_ID_R            0x52
+#define SYSEX_ID_T            0x54
+
+#define SYSEX_PATCH_DUMP      0x01
+#define SYSEX_PATTERN_DUMP    0x02
+#define SYSEX_PATCH_REQUEST   0x11
+#define SYSEX_PATTERN_REQUEST 0x12
+#define SYSEX_ACK             0x7E  // first = command acknowledged
+
+#define SYSEX_PATCH_MAX       8     // Patches per dump: staged, and one undo record
+
+// Called by the MIDI parser: after F0, for each data byte, and when any
+// other status byte ends the message (complete = it was F7)
+extern void sysex_begin(void);
+extern void sysex_byte(uint8_t b);
+extern void sysex_end(bool complete);
+
+#endif // SYSEX_H
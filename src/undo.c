@@ -0,0 +1,355 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "constants.h"
+#include "instruments.h"
+#include "patterns.h"
+#include "player.h"
+#include "screen.h"
+#include "song.h"
+#include "undo.h"
+
+// ============================================================================
+// UNDO RING
+// ============================================================================
+// Record: Len (1B), Kind (1B), Idx (1B), Offset (2B), Group (1B),
+//         Old bytes (Len), New bytes (Len), Record size (1B)
+// The trailing size lets undo walk backwards from the cursor. Records from
+// tail to cursor can be undone, records from cursor to head redone. A new
+// edit drops the redo records; when the ring is full the oldest groups go,
+// always whole. A group that would have to push out its own start is
+// thrown away instead, with the rest of the history, so an undo never
+// restores half of an edit.
+
+#define UNDO_HEADER_SIZE 6
+#define UNDO_MAX_RUN     120    // Keeps a record under 256 bytes
+#define UNDO_GAP         4      // Equal bytes shorter than this join two runs
+
+#define RECORD_SIZE(len) (UNDO_HEADER_SIZE + 2 * (uint16_t)(len) + 1)
+
+static uint16_t undo_tail = 0;
+static uint16_t undo_cursor = 0;
+static uint16_t undo_head = 0;
+static uint8_t undo_group = 0;       // Group id of the next record
+static uint8_t undo_group_depth = 0;
+static uint16_t undo_group_start = 0; // First record of the open group
+static bool undo_overflow = false;   // Open group dropped: record nothing more
+static bool undo_applying = false;   // Replays must not record themselves
+
+typedef struct {
+    uint8_t len;
+    uint8_t kind;
+    uint8_t idx;
+    uint16_t offset;
+    uint8_t group;
+} UndoHeader;
+
+static uint16_t ring_add(uint16_t pos, uint16_t n) {
+    pos += n;
+    return (pos >= UNDO_RING_SIZE) ? pos - UNDO_RING_SIZE : pos;
+}
+
+static uint16_t ring_sub(uint16_t pos, uint16_t n) {
+    return (pos >= n) ? pos - n : pos + UNDO_RING_SIZE - n;
+}
+
+static uint16_t ring_used(void) {
+    return ring_sub(undo_cursor, undo_tail);
+}
+
+static void ring_write(uint16_t pos, const uint8_t *buf, uint8_t len) {
+    RIA.addr0 = UNDO_RING_XRAM + pos;
+    RIA.step0 = 1;
+    for (uint8_t i = 0; i < len; i++) {
+        if (pos == UNDO_RING_SIZE) {
+            pos = 0;
+            RIA.addr0 = UNDO_RING_XRAM;
+        }
+        RIA.rw0 = buf[i];
+        pos++;
+    }
+}
+
+static void ring_read(uint16_t pos, uint8_t *buf, uint8_t len) {
+    RIA.addr0 = UNDO_RING_XRAM + pos;
+    RIA.step0 = 1;
+    for (uint8_t i = 0; i < len; i++) {
+        if (pos == UNDO_RING_SIZE) {
+            pos = 0;
+            RIA.addr0 = UNDO_RING_XRAM;
+        }
+        buf[i] = RIA.rw0;
+        pos++;
+    }
+}
+
+static void read_header(uint16_t pos, UndoHeader *h) {
+    uint8_t b[UNDO_HEADER_SIZE];
+    ring_read(pos, b, UNDO_HEADER_SIZE);
+    h->len = b[0];
+    h->kind = b[1];
+    h->idx = b[2];
+    h->offset = b[3] | ((uint16_t)b[4] << 8);
+    h->group = b[5];
+}
+
+// Start of the record that ends at pos
+static uint16_t record_before(uint16_t pos) {
+    uint8_t size;
+    ring_read(ring_sub(pos, 1), &size, 1);
+    return ring_sub(pos, size);
+}
+
+// Drops the records of the oldest group
+static void drop_oldest_group(void) {
+    UndoHeader h;
+    read_header(undo_tail, &h);
+    uint8_t group = h.group;
+    do {
+        undo_tail = ring_add(undo_tail, RECORD_SIZE(h.len));
+        if (undo_tail == undo_cursor) break;
+        read_header(undo_tail, &h);
+    } while (h.group == group);
+}
+
+static void push_record(uint8_t kind, uint8_t idx, uint16_t offset,
+                        const uint8_t *old_bytes, const uint8_t *new_bytes, uint8_t len) {
+    uint8_t size = (uint8_t)RECORD_SIZE(len);
+    UndoHeader h;
+
+    if (undo_overflow) return;
+
+    // Fold into the previous record when it is the same target
+    if ((kind & UNDO_MERGE) && undo_cursor == undo_head && undo_cursor != undo_tail) {
+        uint16_t last = record_before(undo_cursor);
+        read_header(last, &h);
+        if (h.kind == (kind & ~UNDO_MERGE) && h.idx == idx && h.offset == offset && h.len == len) {
+            ring_write(ring_add(last, UNDO_HEADER_SIZE + len), new_bytes, len);
+            return;
+        }
+    }
+    kind &= ~UNDO_MERGE;
+
+    // A new edit ends the redo chain; make room by dropping the oldest
+    undo_head = undo_cursor;
+    while (UNDO_RING_SIZE - ring_used() <= size) {
+        if (undo_group_depth && undo_tail == undo_group_start) {
+            // Only the open group is left and it still does not fit
+            undo_tail = undo_cursor = undo_head = 0;
+            undo_overflow = true;
+            return;
+        }
+        drop_oldest_group();
+    }
+
+    uint8_t b[UNDO_HEADER_SIZE] = {
+        len, kind, idx, (uint8_t)(offset & 0xFF), (uint8_t)(offset >> 8), undo_group
+    };
+    uint16_t pos = undo_cursor;
+    ring_write(pos, b, UNDO_HEADER_SIZE);
+    pos = ring_add(pos, UNDO_HEADER_SIZE);
+    ring_write(pos, old_bytes, len);
+    pos = ring_add(pos, len);
+    ring_write(pos, new_bytes, len);
+    pos = ring_add(pos, len);
+    ring_write(pos, &size, 1);
+
+    undo_cursor = undo_head = ring_add(pos, 1);
+    if (!undo_group_depth) undo_group++;
+}
+
+// Stores the bytes that differ between old_bytes and new_bytes. Patches are
+// stored whole so that merged knob tweaks always line up.
+void undo_record(uint8_t kind, uint8_t idx, uint16_t offset,
+                 const uint8_t *old_bytes, const uint8_t *new_bytes, uint16_t len) {
+    if (undo_applying) return;
+
+    if ((kind & ~UNDO_MERGE) == UNDO_PATCH) {
+        if (memcmp(old_bytes, new_bytes, len) != 0) {
+            push_record(kind, idx, offset, old_bytes, new_bytes, (uint8_t)len);
+        }
+        return;
+    }
+
+    uint16_t i = 0;
+    while (i < len) {
+        if (old_bytes[i] == new_bytes[i]) {
+            i++;
+            continue;
+        }
+        // A run of changes, allowing short gaps of equal bytes inside it
+        uint16_t start = i;
+        uint16_t end = i + 1;
+        uint16_t j = end;
+        while (j < len && j - start < UNDO_MAX_RUN) {
+            if (old_bytes[j] != new_bytes[j]) {
+                end = j + 1;
+            } else if (j - end >= UNDO_GAP - 1) {
+                break;
+            }
+            j++;
+        }
+        push_record(kind, idx, offset + start, old_bytes + start, new_bytes + start,
+                    (uint8_t)(end - start));
+        i = end;
+    }
+}
+
+// Records a whole-pattern write (new_bytes NULL = clear) before it happens
+void undo_record_pattern(uint8_t pat, const uint8_t *new_bytes) {
+    uint8_t old_chunk[60];
+    uint8_t zero_chunk[60];
+
+    if (undo_applying) return;
+    memset(zero_chunk, 0, sizeof(zero_chunk));
+
+    undo_group_begin();
+    for (uint16_t off = 0; off < PATTERN_SIZE; off += sizeof(old_chunk)) {
+        RIA.addr0 = pattern_slot_addr(pat) + off;
+        RIA.step0 = 1;
+        for (uint8_t i = 0; i < sizeof(old_chunk); i++) old_chunk[i] = RIA.rw0;
+        undo_record(UNDO_PATTERN, pat, off, old_chunk,
+                    new_bytes ? new_bytes + off : zero_chunk, sizeof(old_chunk));
+    }
+    undo_group_end();
+}
+
+void undo_group_begin(void) {
+    if (undo_group_depth++ == 0) {
+        undo_group_start = undo_cursor;
+        undo_overflow = false;
+    }
+}
+
+bool undo_group_end(void) {
+    if (!undo_group_depth || --undo_group_depth) return true;
+    undo_group++;
+    if (undo_overflow) {
+        undo_overflow = false;
+        printf("Edit too large to undo: undo history cleared\n");
+        return false;
+    }
+    return true;
+}
+
+void undo_reset(void) {
+    undo_tail = undo_cursor = undo_head = 0;
+    undo_group_depth = 0;
+    undo_overflow = false;
+}
+
+// ============================================================================
+// UNDO / REDO
+// ============================================================================
+
+static void apply_record(uint16_t pos, bool use_new) {
+    UndoHeader h;
+    uint8_t buf[UNDO_MAX_RUN];
+
+    read_header(pos, &h);
+    ring_read(ring_add(pos, UNDO_HEADER_SIZE + (use_new ? h.len : 0)), buf, h.len);
+
+    switch (h.kind) {
+        case UNDO_PATTERN:
+            RIA.addr0 = pattern_slot_addr(h.idx) + h.offset;
+            RIA.step0 = 1;
+            for (uint8_t i = 0; i < h.len; i++) RIA.rw0 = buf[i];
+            mark_pattern_dirty(h.idx);
+            cur_pattern = h.idx; // Show where the change happened
+            break;
+        case UNDO_ORDER:
+            for (uint8_t i = 0; i < h.len; i++) {
+                write_order_xram((uint8_t)(h.offset + i), buf[i]);
+            }
+            break;
+        case UNDO_PATCH:
+            memcpy((uint8_t *)&user_bank[h.idx] + h.offset, buf, h.len);
+            mark_song_dirty(DIRTY_PATCHES);
+            if ((uint8_t)(current_instrument - h.idx) <= (h.offset + h.len - 1) / sizeof(OPL_Patch)) {
+                select_instrument(current_instrument);
+            }
+            break;
+        case UNDO_LENGTH:
+            song_length = buf[0] | ((uint16_t)buf[1] << 8);
+            if (cur_order_idx >= song_length) cur_order_idx = (uint8_t)(song_length - 1);
+            mark_song_dirty(DIRTY_META);
+            break;
+    }
+}
+
+bool undo_group_abort(void) {
+    bool undoable = !undo_overflow;
+    uint8_t pat = cur_pattern;
+
+    if (undoable) {
+        undo_applying = true;
+        while (undo_cursor != undo_group_start) {
+            uint16_t pos = record_before(undo_cursor);
+            apply_record(pos, false);
+            undo_cursor = pos;
+        }
+        undo_head = undo_cursor;
+        undo_applying = false;
+        cur_pattern = pat;
+    }
+    undo_overflow = false;
+    undo_group_depth = 0;
+    undo_group++;
+    return undoable;
+}
+
+void undo(void) {
+    UndoHeader h;
+    uint8_t group;
+    uint8_t steps = 0;
+
+    if (undo_cursor == undo_tail) {
+        printf("Nothing to undo\n");
+        return;
+    }
+
+    undo_applying = true;
+    uint16_t pos = record_before(undo_cursor);
+    read_header(pos, &h);
+    group = h.group;
+    do {
+        apply_record(pos, false);
+        undo_cursor = pos;
+        steps++;
+        if (undo_cursor == undo_tail) break;
+        pos = record_before(undo_cursor);
+        read_header(pos, &h);
+    } while (h.group == group);
+    undo_applying = false;
+
+    refresh_all_ui();
+    printf("Undo (%u changes)\n", steps);
+}
+
+void redo(void) {
+    UndoHeader h;
+    uint8_t group;
+    uint8_t steps = 0;
+
+    if (undo_cursor == undo_head) {
+        printf("Nothing to redo\n");
+        return;
+    }
+
+    undo_applying = true;
+    read_header(undo_cursor, &h);
+    group = h.group;
+    do {
+        apply_record(undo_cursor, true);
+        undo_cursor = ring_add(undo_cursor, RECORD_SIZE(h.len));
+        steps++;
+        if (undo_cursor == undo_head) break;
+        read_header(undo_cursor, &h);
+    } while (h.group == group);
+    undo_applying = false;
+
+    refresh_all_ui();
+    printf("Redo (%u changes)\n", steps);
+}
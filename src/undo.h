@@ -0,0 +1,40 @@
+#ifndef UNDO_H
+#define UNDO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Undo journal: every edit is stored as old/new bytes for the range it
+// changed, in a ring in XRAM (UNDO_RING_XRAM). Undo and redo cost the size
+// of the edit, and the oldest edits fall off when the ring is full.
+
+// What a record points at
+#define UNDO_PATTERN  0   // idx = logical pattern, offset = byte in pattern
+#define UNDO_ORDER    1   // offset = order list position
+#define UNDO_PATCH    2   // idx = user_bank slot, offset = byte from its start (may run on
+                          // into the next slots)
+#define UNDO_LENGTH   3   // song_length (2 bytes)
+
+// Or'd into the kind: fold into the previous record if it has the same
+// target, so a knob sweep is one undo step instead of hundreds
+#define UNDO_MERGE    0x80
+
+extern void undo_record(uint8_t kind, uint8_t idx, uint16_t offset,
+                        const uint8_t *old_bytes, const uint8_t *new_bytes, uint16_t len);
+extern void undo_record_pattern(uint8_t pat, const uint8_t *new_bytes);
+
+// Everything recorded between begin and end is undone in one step. Groups
+// nest; only the outermost counts. If the group does not fit in the ring
+// it cannot be undone at all: the outermost end returns false, after the
+// status bar says so, and the history before it is gone too.
+extern void undo_group_begin(void);
+extern bool undo_group_end(void);
+// Closes the outermost group by putting back everything recorded in it, and
+// leaves nothing to redo. False if it outgrew the ring: its changes stay.
+extern bool undo_group_abort(void);
+
+extern void undo(void);
+extern void redo(void);
+extern void undo_reset(void);
+
+#endif // UNDO_H
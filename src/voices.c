@@ -0,0 +1,69 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "screen.h"
+#include "voices.h"
+
+// ============================================================================
+// VOICE ALLOCATOR
+// ============================================================================
+// Ages are kept as a count of key events rather than frames; only their
+// order matters. Nine voices make every decision a fixed-size scan.
+
+uint8_t note_voice[128];
+
+static uint8_t voice_note[9];       // Live note last given to each voice, 0 = none
+static uint16_t voice_keyed = 0;    // Bit per channel: key is down
+static uint16_t voice_clock = 0;    // Counts key events
+static uint16_t voice_on_at[9];     // voice_clock at the last key-on
+static uint16_t voice_off_at[9];    // voice_clock at the last key-off
+
+void voice_key_on(uint8_t ch) {
+    if (voice_keyed & (1 << ch)) return;
+    voice_keyed |= 1 << ch;
+    voice_on_at[ch] = ++voice_clock;
+}
+
+void voice_key_off(uint8_t ch) {
+    if (!(voice_keyed & (1 << ch))) return;
+    voice_keyed &= ~(1 << ch);
+    voice_off_at[ch] = ++voice_clock;
+}
+
+uint8_t voice_alloc(uint8_t note) {
+    uint8_t best = note_voice[note];
+    uint16_t best_age = 0;
+
+    // Struck again during its release tail: retrigger the same voice
+    if (best && !(voice_keyed & (1 << (best - 1)))) return best - 1;
+
+    best = 0xFF;
+
+    for (uint8_t ch = 0; ch < 9; ch++) {
+        if (voice_keyed & (1 << ch)) continue;
+        uint16_t age = voice_clock - voice_off_at[ch];
+        if (best == 0xFF || age > best_age) {
+            best = ch;
+            best_age = age;
+        }
+    }
+    if (best != 0xFF) return best;
+
+    // Everything is keyed: steal the quietest
+    uint8_t best_level = 0xFF;
+    for (uint8_t ch = 0; ch < 9; ch++) {
+        uint16_t age = voice_clock - voice_on_at[ch];
+        if (ch_peaks[ch] < best_level || (ch_peaks[ch] == best_level && age > best_age)) {
+            best = ch;
+            best_level = ch_peaks[ch];
+            best_age = age;
+        }
+    }
+    return best;
+}
+
+void voice_assign(uint8_t ch, uint8_t note) {
+    uint8_t old = voice_note[ch];
+    if (old && note_voice[old] == ch + 1) note_voice[old] = 0;
+    voice_note[ch] = note;
+    note_voice[note] = ch + 1;
+}
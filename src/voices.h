@@ -0,0 +1,26 @@
+#ifndef VOICES_H
+#define VOICES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Voice allocation for live MIDI notes. Every key-on and key-off written
+// by opl.c is reported here, so the allocator sees the sequencer's notes
+// and effects as well as the keyboard's.
+
+// Live note -> OPL channel + 1 (0 = none). A released note keeps its voice
+// until the voice is given to another note, so striking it again reuses it.
+extern uint8_t note_voice[128];
+
+extern void voice_key_on(uint8_t ch);
+extern void voice_key_off(uint8_t ch);
+
+// Channel for a new live note: the voice that last played it if that one
+// is in release, else the voice longest in release, else the quietest one
+// sounding (the oldest on a tie)
+extern uint8_t voice_alloc(uint8_t note);
+
+// Points note at ch, dropping whatever live note ch had before
+extern void voice_assign(uint8_t ch, uint8_t note);
+
+#endif // VOICES_H
@@ -0,0 +1,487 @@
+#!/usr/bin/env python3
+"""
+RPTracker MIDI File Importer
+Converts Standard MIDI Files (.mid, format 0 or 1) into RPTracker songs
+(RPT5, or RPT6 past 32 patterns) that load with Ctrl+O.
+
+  import_midi.py [-r ROWS_PER_BEAT] [-t SEMITONES] [-c CHANNELS] in.mid [out.rpt]
+
+Events are quantised to the nearest row. Every MIDI channel shares the 9 OPL
+channels through the same allocation as the tracker's MIDI poly mode
+(src/voices.c): a note struck again in its release tail keeps its voice,
+otherwise the voice longest in release is taken, and only when all nine
+are held is the quietest one stolen.
+
+Program changes (with CC 0 bank select) pick gm_bank patches the way a live
+keyboard does; channel 10 drums map onto the percussion bank. Note velocity,
+channel volume (CC 7) and expression (CC 11) set the cell volume.
+
+Tracks are read straight from the file and merged as they go, so only one
+pattern and the tracker state are in memory however large the file is.
+"""
+
+import argparse
+import hashlib
+import heapq
+import os
+import struct
+import sys
+import tempfile
+
+ROWS = 32
+CHANS = 9
+CELL_SIZE = 5
+PATTERN_SIZE = ROWS * CHANS * CELL_SIZE
+MAX_PATTERNS = 256
+MAX_ORDERS = 256
+RLE_MAX_RUN = 128
+
+NOTE_OFF = 255
+KILL_EFFECT = 0xF000
+NOTE_MIN, NOTE_MAX = 12, 107    # OPL blocks 0-7
+DRUM_NOTE = 48                  # Pad kit pitch (C3)
+
+TRACKER_ROWS_PER_BEAT = 4       # bpm_to_ticks_fp() assumes 4 rows per beat
+BPM_MIN, BPM_MAX = 60, 240      # set_bpm() limits
+
+READ_CHUNK = 65536
+
+
+# --- Reading ----------------------------------------------------------------
+
+class TrackReader:
+    """Reads one MTrk chunk from a shared file descriptor, a chunk at a time"""
+
+    def __init__(self, fd, start, length):
+        self.fd = fd
+        self.pos = start
+        self.end = start + length
+        self.buf = b""
+        self.idx = 0
+
+    def byte(self):
+        if self.idx == len(self.buf):
+            if self.pos >= self.end:
+                raise EOFError
+            self.buf = os.pread(self.fd, min(READ_CHUNK, self.end - self.pos), self.pos)
+            self.pos += len(self.buf)
+            self.idx = 0
+            if not self.buf:
+                raise EOFError
+        b = self.buf[self.idx]
+        self.idx += 1
+        return b
+
+    def bytes(self, n):
+        return bytes(self.byte() for _ in range(n))
+
+    def varlen(self):
+        value = 0
+        while True:
+            b = self.byte()
+            value = (value << 7) | (b & 0x7F)
+            if not b & 0x80:
+                return value
+
+
+def track_events(reader, track):
+    """Yields (tick, track, seq, status, data) in file order"""
+    tick = 0
+    running = 0
+    seq = 0
+    try:
+        while True:
+            tick += reader.varlen()
+            b = reader.byte()
+            if b == 0xFF:
+                kind = reader.byte()
+                data = reader.bytes(reader.varlen())
+                if kind == 0x2F:
+                    return
+                if kind == 0x51:
+                    yield tick, track, seq, 0xFF, data
+                    seq += 1
+                continue
+            if b in (0xF0, 0xF7):
+                reader.bytes(reader.varlen()) # SysEx
+                continue
+            if b & 0x80:
+                running = b
+                d0 = reader.byte()
+            else:
+                d0 = b                          # Running status
+            if running < 0x80:
+                continue                        # Data with no status: corrupt, skip
+            kind = running & 0xF0
+            d1 = reader.byte() if kind not in (0xC0, 0xD0) else 0
+            yield tick, track, seq, running, bytes([d0, d1])
+            seq += 1
+    except EOFError:
+        return
+
+
+def open_midi(path):
+    """Returns (fd, division, [TrackReader]) after reading only chunk headers"""
+    fd = os.open(path, os.O_RDONLY)
+    size = os.fstat(fd).st_size
+    head = os.pread(fd, 14, 0)
+    if head[:4] != b"MThd":
+        sys.exit(f"Error: {path} is not a Standard MIDI File")
+    hlen, fmt, ntracks, division = struct.unpack(">IHHH", head[4:14])
+    if fmt > 1:
+        sys.exit(f"Error: format {fmt} MIDI files are not supported")
+    if division & 0x8000:
+        sys.exit("Error: SMPTE time division is not supported")
+
+    readers = []
+    pos = 8 + hlen
+    while pos + 8 <= size and len(readers) < ntracks:
+        cid, clen = struct.unpack(">4sI", os.pread(fd, 8, pos))
+        if cid == b"MTrk":
+            readers.append(TrackReader(fd, pos + 8, min(clen, size - pos - 8)))
+        pos += 8 + clen
+    return fd, division, readers
+
+
+# --- Drums and programs -----------------------------------------------------
+
+def drum_patch(key):
+    """GM percussion key -> gm_bank percussion patch (169-210), or None"""
+    if 35 <= key <= 53:
+        return 169 + key - 35
+    if key == 54:
+        return 210                      # Tambourine sits at the end of the bank
+    if 55 <= key <= 70:
+        return 188 + key - 55
+    if 75 <= key <= 78:
+        return 204 + key - 75
+    if 80 <= key <= 81:
+        return 208 + key - 80
+    return None
+
+
+def fold_note(note):
+    while note < NOTE_MIN:
+        note += 12
+    while note > NOTE_MAX:
+        note -= 12
+    return note
+
+
+# --- Voice allocation (src/voices.c) ----------------------------------------
+
+class Voices:
+    def __init__(self, channels):
+        self.channels = channels
+        self.keyed = [False] * CHANS
+        self.clock = 0
+        self.on_at = [0] * CHANS
+        self.off_at = [0] * CHANS
+        self.level = [0] * CHANS        # Volume of the held note (stands in for ch_peaks)
+        self.voice_key = [None] * CHANS # (MIDI channel, note) last given to each voice
+        self.note_voice = {}            # (MIDI channel, note) -> voice
+
+    def key_on(self, ch, level):
+        self.keyed[ch] = True
+        self.clock += 1
+        self.on_at[ch] = self.clock
+        self.level[ch] = level
+
+    def key_off(self, ch):
+        if self.keyed[ch]:
+            self.keyed[ch] = False
+            self.clock += 1
+            self.off_at[ch] = self.clock
+
+    def alloc(self, key, busy):
+        """busy: voices that already start a note on this row"""
+        v = self.note_voice.get(key)
+        if v is not None and not self.keyed[v] and v not in busy:
+            return v                    # Struck again during its release tail
+
+        free = [ch for ch in self.channels if not self.keyed[ch] and ch not in busy]
+        if free:
+            return max(free, key=lambda ch: self.clock - self.off_at[ch])
+
+        held = [ch for ch in self.channels if ch not in busy]
+        if not held:
+            return None
+        return min(held, key=lambda ch: (self.level[ch], -(self.clock - self.on_at[ch])))
+
+    def assign(self, ch, key):
+        old = self.voice_key[ch]
+        if old is not None and self.note_voice.get(old) == ch:
+            del self.note_voice[old]
+        self.voice_key[ch] = key
+        self.note_voice[key] = ch
+
+
+# --- Writing ----------------------------------------------------------------
+
+def rle_pattern(pat):
+    """The RPT5/6 token stream for one pattern (see song.c)"""
+    out = bytearray()
+    cells = [pat[i:i + CELL_SIZE] for i in range(0, PATTERN_SIZE, CELL_SIZE)]
+    n = 0
+    while n < len(cells):
+        empty = not any(cells[n])
+        run = 1
+        while n + run < len(cells) and run < RLE_MAX_RUN and (not any(cells[n + run])) == empty:
+            run += 1
+        if empty:
+            out.append(0x80 | (run - 1))
+        else:
+            out.append(run - 1)
+            for c in cells[n:n + run]:
+                out.extend(c)
+        n += run
+    return bytes(out)
+
+
+class SongWriter:
+    """Takes finished patterns in song order. Identical patterns share one
+    slot; pattern data is spooled to a temp file until the order list is known."""
+
+    def __init__(self):
+        self.spool = tempfile.TemporaryFile()
+        self.slots = {}                 # Digest -> pattern index
+        self.stored = []                # Indices with data in the spool
+        self.orders = bytearray()
+        self.empty = bytes(PATTERN_SIZE)
+
+    def full(self):
+        return len(self.orders) >= MAX_ORDERS
+
+    def add(self, pat):
+        digest = hashlib.blake2b(pat, digest_size=16).digest()
+        idx = self.slots.get(digest)
+        if idx is None:
+            if len(self.slots) == MAX_PATTERNS:
+                return False
+            idx = len(self.slots)
+            self.slots[digest] = idx
+            if pat != self.empty:
+                self.stored.append(idx)
+                self.spool.write(rle_pattern(pat))
+        self.orders.append(idx)
+        return True
+
+    def write(self, path, bpm):
+        wide = len(self.slots) > 32
+        bitmap = bytearray(MAX_PATTERNS // 8 if wide else 4)
+        for idx in self.stored:
+            bitmap[idx >> 3] |= 1 << (idx & 7)
+
+        with open(path, "wb") as f:
+            f.write(b"RPT6" if wide else b"RPT5")
+            f.write(struct.pack("<BBHH", 3, 63, len(self.orders), bpm))
+            f.write(struct.pack("<H", 0))   # No patches differ from gm_bank
+            f.write(self.orders)
+            f.write(bitmap)
+            self.spool.seek(0)
+            while True:
+                chunk = self.spool.read(READ_CHUNK)
+                if not chunk:
+                    break
+                f.write(chunk)
+
+
+# --- Conversion -------------------------------------------------------------
+
+class Importer:
+    def __init__(self, channels, transpose):
+        self.voices = Voices(channels)
+        self.transpose = transpose
+        self.song = SongWriter()
+        self.pattern = bytearray(PATTERN_SIZE)
+        self.pattern_no = 0
+        self.program = [0] * 16
+        self.bank = [0] * 16
+        self.volume = [127] * 16
+        self.expression = [127] * 16
+        self.sounding = {}              # (MIDI channel, note) -> (voice, row started)
+        self.voice_owner = [None] * CHANS
+        self.voice_inst = [0] * CHANS   # Instrument of each voice's last note
+        self.deferred_offs = []         # Note offs held back a row so short notes sound
+        self.dropped = 0
+        self.truncated = False
+
+    def cell(self, row, ch):
+        return ((row % ROWS) * CHANS + ch) * CELL_SIZE
+
+    def advance_to(self, row):
+        """Finishes every pattern before the one holding row"""
+        while row // ROWS > self.pattern_no and not self.truncated:
+            if self.song.full() or not self.song.add(bytes(self.pattern)):
+                self.truncated = True
+                return
+            self.pattern = bytearray(PATTERN_SIZE)
+            self.pattern_no += 1
+
+    def note_off(self, key, row):
+        entry = self.sounding.pop(key, None)
+        if entry is None:
+            return
+        ch, _ = entry
+        self.voices.key_off(ch)
+        self.voice_owner[ch] = None
+        i = self.cell(row, ch)
+        if self.pattern[i] == 0:
+            # Same cell live recording writes for a release
+            self.pattern[i:i + CELL_SIZE] = bytes([NOTE_OFF, self.voice_inst[ch], 0]) + struct.pack("<H", KILL_EFFECT)
+
+    def note_on(self, chan, note, velocity, row, busy):
+        key = (chan, note)
+        if key in self.sounding:
+            self.note_off(key, row)     # Retrigger
+
+        if chan == 9:
+            inst = drum_patch(note)
+            if inst is None:
+                return
+            play = DRUM_NOTE
+        else:
+            inst = min(self.bank[chan] * 128 + self.program[chan], 255)
+            play = fold_note(note + self.transpose)
+
+        vol = (velocity * self.volume[chan] * self.expression[chan]) // (127 * 127) >> 1
+        vol = max(vol, 1)
+
+        ch = self.voices.alloc(key, busy)
+        if ch is None:
+            self.dropped += 1
+            return
+        owner = self.voice_owner[ch]
+        if owner is not None:
+            self.sounding.pop(owner, None) # Stolen
+            self.voices.key_off(ch)
+        busy.add(ch)
+        self.voices.key_on(ch, vol)
+        self.voices.assign(ch, key)
+        self.voice_owner[ch] = key
+        self.sounding[key] = (ch, row)
+        self.voice_inst[ch] = inst
+
+        i = self.cell(row, ch)
+        self.pattern[i:i + CELL_SIZE] = bytes([play, inst, vol, 0, 0])
+
+    def process_row(self, row, events):
+        self.advance_to(row)
+        if self.truncated:
+            return
+
+        # Offs held back from the previous row go first
+        for key in self.deferred_offs:
+            self.note_off(key, row)
+        self.deferred_offs = []
+
+        busy = set()
+        started = set()
+        for status, data in events:
+            kind, chan = status & 0xF0, status & 0x0F
+            if kind == 0x90 and data[1]:
+                self.note_on(chan, data[0], data[1], row, busy)
+                started.add((chan, data[0]))
+            elif kind in (0x80, 0x90):
+                key = (chan, data[0])
+                if key in started:
+                    self.deferred_offs.append(key) # Give it at least one row
+                else:
+                    self.note_off(key, row)
+            elif kind == 0xC0:
+                self.program[chan] = data[0]
+            elif kind == 0xB0:
+                if data[0] == 0 or data[0] == 32:
+                    self.bank[chan] = 1 if data[1] else 0
+                elif data[0] == 7:
+                    self.volume[chan] = data[1]
+                elif data[0] == 11:
+                    self.expression[chan] = data[1]
+                elif data[0] in (120, 123):
+                    for key in [k for k in self.sounding if k[0] == chan]:
+                        self.note_off(key, row)
+
+    def finish(self, row):
+        if self.deferred_offs:
+            self.process_row(row + 1, [])
+        if any(self.pattern) and not self.truncated:
+            if self.song.full() or not self.song.add(bytes(self.pattern)):
+                self.truncated = True
+        if not self.song.orders:
+            self.song.add(bytes(self.pattern))
+
+
+def convert(in_path, out_path, rows_per_beat, transpose, channels):
+    fd, division, readers = open_midi(in_path)
+    importer = Importer(channels, transpose)
+    tempo = None
+    tempo_changes = 0
+
+    # Tracks are each in tick order; merge them by (tick, track, seq)
+    streams = [track_events(r, n) for n, r in enumerate(readers)]
+    row_events = []
+    cur_row = 0
+    for tick, _, _, status, data in heapq.merge(*streams):
+        if status == 0xFF:
+            us = (data[0] << 16) | (data[1] << 8) | data[2] if len(data) >= 3 else 500000
+            if tempo is None:
+                tempo = us
+            elif us != tempo:
+                tempo_changes += 1
+            continue
+        row = (tick * rows_per_beat + division // 2) // division
+        if row != cur_row:
+            if row_events:
+                importer.process_row(cur_row, row_events)
+                row_events = []
+            cur_row = row
+            if importer.truncated:
+                break
+        row_events.append((status, data))
+    if row_events:
+        importer.process_row(cur_row, row_events)
+    importer.finish(cur_row)
+    os.close(fd)
+
+    bpm = 60000000 / (tempo or 500000) * rows_per_beat / TRACKER_ROWS_PER_BEAT
+    song_bpm = int(round(min(max(bpm, BPM_MIN), BPM_MAX)))
+    importer.song.write(out_path, song_bpm)
+
+    song = importer.song
+    print(f"{in_path}: {len(readers)} tracks -> {out_path}")
+    print(f"  {len(song.orders)} orders, {len(song.slots)} unique patterns, BPM {song_bpm}")
+    if round(bpm) != song_bpm:
+        print(f"  Warning: tempo needs BPM {bpm:.0f}; try another -r")
+    if tempo_changes:
+        print(f"  Warning: {tempo_changes} tempo changes ignored, the first tempo is used")
+    if importer.dropped:
+        print(f"  Warning: {importer.dropped} notes dropped (more than 9 starting on one row)")
+    if importer.truncated:
+        print(f"  Warning: song cut at {MAX_ORDERS} orders / {MAX_PATTERNS} patterns")
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Convert a Standard MIDI File to an RPTracker song")
+    ap.add_argument("input", help=".mid file")
+    ap.add_argument("output", nargs="?", help="song to write (default: input name with .RPT)")
+    ap.add_argument("-r", "--rows-per-beat", type=int, default=4,
+                    help="quantisation: rows per quarter note (default 4 = 16th notes)")
+    ap.add_argument("-t", "--transpose", type=int, default=0, help="semitones added to every melodic note")
+    ap.add_argument("-c", "--channels", default="0-8",
+                    help="OPL channels to allocate, e.g. 0-5 or 0,2,4 (default 0-8)")
+    args = ap.parse_args()
+
+    channels = set()
+    for part in args.channels.split(","):
+        lo, _, hi = part.partition("-")
+        channels.update(range(int(lo), int(hi or lo) + 1))
+    channels = sorted(ch for ch in channels if 0 <= ch < CHANS)
+    if not channels or args.rows_per_beat < 1:
+        ap.error("need at least one channel and one row per beat")
+
+    out = args.output or os.path.splitext(os.path.basename(args.input))[0][:8].upper() + ".RPT"
+    convert(args.input, out, args.rows_per_beat, args.transpose, channels)
+
+
+if __name__ == "__main__":
+    main()
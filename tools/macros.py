@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""
+RPTracker Instrument Macro Tool
+Lists and edits the instrument macros stored at the end of an RPT5/RPT6 song
+(see src/macros.h). Save the song with Ctrl+S first if it is an older format.
+
+  macros.py SONG list
+  macros.py SONG set INST TYPE STEPS
+  macros.py SONG clear INST [TYPE]
+  macros.py SONG load MACROS.TXT
+
+INST is the instrument (hex, 00-FF). TYPE is vol, arp, pitch or wave.
+STEPS are values separated by spaces, one per frame (60 Hz):
+
+  vol    0-15, scales the volume the note was played at
+  arp    semitones added to the note
+  pitch  added to a running fine pitch each frame (8 is about a semitone)
+  wave   bits 0-1 carrier wave, 2-3 modulator wave, 4-6 feedback
+
+"|" before a step makes it the loop start. "/" after a step makes it the
+release point: the step (or the loop, if that starts earlier) holds until
+the key goes up, then the steps after "/" play. For example
+
+  macros.py SONG.RPT set 2A vol "15 13 11 | 10 9 10 / 6 3 1 0"
+
+MACROS.TXT holds one "INST TYPE STEPS" per line, # starts a comment.
+"""
+
+import struct
+import sys
+
+CELL_SIZE = 5
+PATTERN_CELLS = 32 * 9
+PATCH_SIZE = 11
+
+TYPES = ["vol", "arp", "pitch", "wave"]
+MAX_SEQS = 32
+MAX_LEN = 32
+NONE = 0xFF
+
+
+# --- Song file ---------------------------------------------------------------
+
+def macro_offset(data):
+    """Offset of the macro block: the end of the last stored pattern"""
+    if data[:4] not in (b"RPT5", b"RPT6"):
+        sys.exit("Error: not an RPT5/RPT6 song; load it and save with Ctrl+S first")
+    song_length = struct.unpack_from("<H", data, 6)[0]
+    patch_count = struct.unpack_from("<H", data, 10)[0]
+    pos = 12 + patch_count * (1 + PATCH_SIZE) + song_length
+    bitmap_len = 32 if data[3:4] == b"6" else 4
+    bitmap = data[pos:pos + bitmap_len]
+    pos += bitmap_len
+    for pat in range(bitmap_len * 8):
+        if not bitmap[pat >> 3] & (1 << (pat & 7)):
+            continue
+        cells = 0
+        while cells < PATTERN_CELLS:
+            if pos >= len(data):
+                sys.exit("Error: song is truncated")
+            tok = data[pos]
+            run = min((tok & 0x7F) + 1, PATTERN_CELLS - cells)
+            pos += 1 if tok & 0x80 else 1 + run * CELL_SIZE
+            cells += run
+    return pos
+
+
+def read_macros(data, pos):
+    seqs = []
+    if pos >= len(data):
+        return seqs
+    for _ in range(data[pos]):
+        inst, typ, length, loop, release = data[pos + 1:pos + 6]
+        values = list(struct.unpack_from(f"{length}b", data, pos + 6))
+        seqs.append((inst, typ, values, loop, release))
+        pos += 5 + length
+    return seqs
+
+
+def write_macros(seqs):
+    if not seqs:
+        return b""
+    out = bytearray([len(seqs)])
+    for inst, typ, values, loop, release in sorted(seqs):
+        out += bytes([inst, typ, len(values), loop, release])
+        out += struct.pack(f"{len(values)}b", *values)
+    return bytes(out)
+
+
+# --- Step text ----------------------------------------------------------------
+
+def parse_steps(text):
+    values, loop, release = [], NONE, NONE
+    for tok in text.replace("|", " | ").replace("/", " / ").split():
+        if tok == "|":
+            loop = len(values)
+        elif tok == "/":
+            if not values:
+                sys.exit("Error: '/' must follow a step")
+            release = len(values) - 1
+        else:
+            values.append(int(tok, 0))
+    if not values or len(values) > MAX_LEN:
+        sys.exit(f"Error: a macro needs 1 to {MAX_LEN} steps")
+    if any(not -128 <= v <= 127 for v in values):
+        sys.exit("Error: steps must be -128 to 127")
+    if loop >= len(values):
+        loop = NONE
+    return values, loop, release
+
+
+def format_steps(values, loop, release):
+    parts = []
+    for n, v in enumerate(values):
+        if n == loop:
+            parts.append("|")
+        parts.append(str(v))
+        if n == release:
+            parts.append("/")
+    return " ".join(parts)
+
+
+def parse_type(name):
+    if name.lower() not in TYPES:
+        sys.exit(f"Error: type must be one of {', '.join(TYPES)}")
+    return TYPES.index(name.lower())
+
+
+def parse_inst(text):
+    inst = int(text, 16)
+    if not 0 <= inst <= 0xFF:
+        sys.exit("Error: instrument must be 00-FF")
+    return inst
+
+
+# --- Commands -----------------------------------------------------------------
+
+def set_seq(seqs, inst, typ, steps):
+    seqs = [s for s in seqs if (s[0], s[1]) != (inst, typ)]
+    values, loop, release = parse_steps(steps)
+    seqs.append((inst, typ, values, loop, release))
+    return seqs
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.exit(__doc__)
+    path, cmd, args = argv[0], argv[1], argv[2:]
+    data = open(path, "rb").read()
+    pos = macro_offset(data)
+    seqs = read_macros(data, pos)
+
+    if cmd == "list" and not args:
+        if not seqs:
+            print("No macros")
+        for inst, typ, values, loop, release in sorted(seqs):
+            name = TYPES[typ] if typ < len(TYPES) else str(typ)
+            print(f"{inst:02X} {name:<5} {format_steps(values, loop, release)}")
+        return
+    elif cmd == "set" and len(args) == 3:
+        seqs = set_seq(seqs, parse_inst(args[0]), parse_type(args[1]), args[2])
+    elif cmd == "clear" and len(args) in (1, 2):
+        inst = parse_inst(args[0])
+        typ = parse_type(args[1]) if len(args) == 2 else None
+        seqs = [s for s in seqs if s[0] != inst or (typ is not None and s[1] != typ)]
+    elif cmd == "load" and len(args) == 1:
+        for line_no, line in enumerate(open(args[0]), 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split(None, 2)
+            if len(fields) != 3:
+                sys.exit(f"{args[0]}:{line_no}: expected INST TYPE STEPS")
+            seqs = set_seq(seqs, parse_inst(fields[0]), parse_type(fields[1]), fields[2])
+    else:
+        sys.exit(__doc__)
+
+    if len(seqs) > MAX_SEQS:
+        sys.exit(f"Error: a song holds at most {MAX_SEQS} macros")
+    with open(path, "wb") as f:
+        f.write(data[:pos] + write_macros(seqs))
+    print(f"{path}: {len(seqs)} macros")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""
+RPTracker GM Bank Builder
+Turns src/gm_bank.txt into the GMBANK asset the tracker reads from ROM:
+
+  256 x 11-byte OPL_Patch (slot order), then 256 x 16-byte names
+  (NUL padded, not terminated when all 16 characters are used)
+
+  make_gmbank.py gm_bank.txt GMBANK
+"""
+
+import sys
+
+PATCHES = 256
+PATCH_SIZE = 11
+NAME_LEN = 16
+
+
+def build(src_path, out_path):
+    patches = [None] * PATCHES
+    names = [None] * PATCHES
+
+    with open(src_path) as f:
+        for line_no, line in enumerate(f, 1):
+            line = line.rstrip("\n")
+            if not line.strip() or line.startswith("#"):
+                continue
+            fields = line.split(None, PATCH_SIZE + 1)
+            try:
+                slot = int(fields[0], 10)
+                values = bytes(int(v, 16) for v in fields[1:PATCH_SIZE + 1])
+            except (ValueError, IndexError):
+                sys.exit(f"{src_path}:{line_no}: expected slot, 11 hex bytes and a name")
+            name = fields[PATCH_SIZE + 1] if len(fields) > PATCH_SIZE + 1 else ""
+            if not 0 <= slot < PATCHES or len(values) != PATCH_SIZE:
+                sys.exit(f"{src_path}:{line_no}: bad slot or patch")
+            if patches[slot] is not None:
+                sys.exit(f"{src_path}:{line_no}: slot {slot} defined twice")
+            if len(name) > NAME_LEN:
+                sys.exit(f"{src_path}:{line_no}: name longer than {NAME_LEN} characters")
+            patches[slot] = values
+            names[slot] = name.encode("ascii")
+
+    missing = [n for n in range(PATCHES) if patches[n] is None]
+    if missing:
+        sys.exit(f"{src_path}: slots missing: {missing}")
+
+    with open(out_path, "wb") as f:
+        f.write(b"".join(patches))
+        f.write(b"".join(n.ljust(NAME_LEN, b"\0") for n in names))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    build(sys.argv[1], sys.argv[2])
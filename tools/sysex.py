@@ -0,0 +1,328 @@
+#!/usr/bin/env python3
+"""
+RPTracker SysEx tool
+Sends user_bank patches and patterns to the tracker over MIDI, and reads them
+back, using the protocol in src/sysex.h.
+
+  sysex.py [-p PORT | -o OUT.syx] send-patches BANK [FIRST]
+  sysex.py [-p PORT | -o OUT.syx] send-patterns SONG [FIRST]
+  sysex.py -p PORT get-patches FIRST COUNT OUT.bin
+  sysex.py -p PORT get-patterns FIRST COUNT OUT.bin
+  sysex.py decode IN.syx
+  sysex.py [-p PORT | -x RPSX] loopback
+
+PORT is a raw MIDI device (e.g. /dev/snd/midiC1D0) wired to the tracker's
+MIDI0:. -o writes the messages to a .syx file instead.
+
+BANK is a .RPI instrument library, an RPT4 song (its user_bank) or raw
+11-byte patches. SONG is an RPT4 song (patterns 0-31) or raw 1440-byte
+patterns. Both can also be a .syx file saved by get-*.
+
+loopback pushes patches and patterns, checks the ACKs, requests them back and
+compares. It also sends a patch dump cut short, and a patch dump and a pattern
+dump with bad checksums; all three must be refused, leaving what was sent
+before them. Without -p it runs against build-host/rpsx, the tracker's own
+MIDI code built for Linux (cmake -S host -B build-host).
+"""
+
+import os
+import random
+import select
+import subprocess
+import sys
+import tempfile
+
+SYSEX_ID = bytes([0x7D, 0x52, 0x54])
+
+PATCH_DUMP = 0x01
+PATTERN_DUMP = 0x02
+PATCH_REQUEST = 0x11
+PATTERN_REQUEST = 0x12
+ACK = 0x7E
+
+PATCH_MAX = 8  # Patches per dump message
+
+PATCH_SIZE = 11
+PATTERN_SIZE = 32 * 9 * 5
+
+RPT4_BANK_OFFSET = 10
+RPT4_PATTERN_OFFSET = RPT4_BANK_OFFSET + 256 * PATCH_SIZE
+RPT4_PATTERNS = 32
+
+REPLY_TIMEOUT = 5.0  # Seconds to wait for the tracker
+
+
+# --- 7-in-8 packing ---------------------------------------------------------
+
+def pack(data):
+    out = bytearray()
+    for i in range(0, len(data), 7):
+        group = data[i:i + 7]
+        msb = 0
+        for n, b in enumerate(group):
+            msb |= (b >> 7) << n
+        out.append(msb)
+        out.extend(b & 0x7F for b in group)
+    return bytes(out)
+
+
+def unpack(data):
+    out = bytearray()
+    for i in range(0, len(data), 8):
+        msb = data[i]
+        for n, b in enumerate(data[i + 1:i + 8]):
+            out.append(b | (((msb >> n) & 1) << 7))
+    return bytes(out)
+
+
+# --- Messages ---------------------------------------------------------------
+
+def checksum(body):
+    """The byte that makes body plus itself sum to 0 in the low 7 bits"""
+    return -sum(body) & 0x7F
+
+
+def message(cmd, first, count, data=b""):
+    body = bytes([cmd, first & 0x7F, (first >> 7) & 0x7F,
+                  count & 0x7F, (count >> 7) & 0x7F]) + pack(data)
+    return bytes([0xF0]) + SYSEX_ID + body + bytes([checksum(body), 0xF7])
+
+
+def patch_dump(first, patches):
+    """One message per PATCH_MAX patches"""
+    step = PATCH_MAX * PATCH_SIZE
+    return b"".join(message(PATCH_DUMP, first + i // PATCH_SIZE, len(chunk) // PATCH_SIZE, chunk)
+                    for i in range(0, len(patches), step)
+                    for chunk in [patches[i:i + step]])
+
+
+def pattern_dump(first, patterns):
+    return message(PATTERN_DUMP, first, len(patterns) // PATTERN_SIZE, patterns)
+
+
+def split_messages(stream):
+    """Yields (cmd, first, count, data) for each RPTracker message in stream
+    that has a good checksum"""
+    pos = 0
+    while True:
+        start = stream.find(0xF0, pos)
+        if start < 0:
+            return
+        end = stream.find(0xF7, start)
+        if end < 0:
+            return
+        body = bytes(b for b in stream[start + 1:end] if b < 0xF8)  # Real-time may interleave
+        pos = end + 1
+        if len(body) < 9 or body[:3] != SYSEX_ID or sum(body[3:]) & 0x7F:
+            continue
+        first = body[4] | (body[5] << 7)
+        count = body[6] | (body[7] << 7)
+        yield body[3], first, count, unpack(body[8:-1])
+
+
+# --- Files ------------------------------------------------------------------
+
+def read_bank(path):
+    data = open(path, "rb").read()
+    if data[:4] == b"RPI1":
+        count = data[4] | (data[5] << 8)
+        start = 6 + count * 12
+        return data[start:start + count * PATCH_SIZE]
+    if data[:4] == b"RPT4":
+        return data[RPT4_BANK_OFFSET:RPT4_PATTERN_OFFSET]
+    if data[:1] == b"\xF0":
+        return b"".join(d for cmd, _, _, d in split_messages(data) if cmd == PATCH_DUMP)
+    return data[:len(data) - len(data) % PATCH_SIZE]
+
+
+def read_patterns(path):
+    data = open(path, "rb").read()
+    if data[:4] == b"RPT4":
+        return data[RPT4_PATTERN_OFFSET:RPT4_PATTERN_OFFSET + RPT4_PATTERNS * PATTERN_SIZE]
+    if data[:4] in (b"RPT5", b"RPT6"):
+        sys.exit(f"Error: {path} is a sparse song; save it as RPT4 or send raw patterns")
+    if data[:1] == b"\xF0":
+        return b"".join(d for cmd, _, _, d in split_messages(data) if cmd == PATTERN_DUMP)
+    return data[:len(data) - len(data) % PATTERN_SIZE]
+
+
+# --- Ports ------------------------------------------------------------------
+
+class RawPort:
+    """A raw MIDI device file, e.g. /dev/snd/midiC1D0"""
+
+    def __init__(self, path):
+        self.fd = os.open(path, os.O_RDWR)
+        self.pending = bytearray()
+
+    def send(self, data):
+        os.write(self.fd, data)
+
+    def receive(self, cmd, timeout=REPLY_TIMEOUT):
+        """Waits for the next RPTracker message with this command"""
+        while True:
+            for msg in split_messages(self.pending):
+                end = self.pending.index(0xF7) + 1
+                del self.pending[:end]
+                if msg[0] == cmd:
+                    return msg
+                break
+            else:
+                ready, _, _ = select.select([self.fd], [], [], timeout)
+                if not ready:
+                    sys.exit("Error: no reply from the tracker")
+                self.pending.extend(os.read(self.fd, 4096))
+
+
+class FilePort:
+    """Collects everything sent into a .syx file; there are no replies"""
+
+    def __init__(self, path):
+        self.f = open(path, "wb")
+
+    def send(self, data):
+        self.f.write(data)
+
+    def receive(self, cmd, timeout=REPLY_TIMEOUT):
+        sys.exit("Error: replies need a MIDI port (-p)")
+
+
+def expect_ack(port, cmd, count):
+    _, acked, stored, _ = port.receive(ACK)
+    if acked != cmd or stored != count:
+        sys.exit(f"Error: tracker stored {stored} of {count}")
+
+
+# --- Commands ---------------------------------------------------------------
+
+def send_items(port, cmd, first, data, size, what):
+    count = len(data) // size
+    if count == 0:
+        sys.exit(f"Error: no {what} to send")
+    # Patches go PATCH_MAX to a message, each one ACKed before the next
+    per_message = PATCH_MAX if cmd == PATCH_DUMP else count
+    for n in range(0, count, per_message):
+        chunk = data[n * size:(n + per_message) * size]
+        port.send(message(cmd, first + n, len(chunk) // size, chunk))
+        if isinstance(port, RawPort):
+            expect_ack(port, cmd, len(chunk) // size)
+    print(f"Sent {count} {what} from {first:02X}")
+
+
+def get_items(port, request, dump, first, count, out_path, what):
+    port.send(message(request, first, count))
+    _, got_first, got_count, data = port.receive(dump)
+    with open(out_path, "wb") as f:
+        f.write(data)
+    print(f"Received {got_count} {what} from {got_first:02X} -> {out_path}")
+
+
+def decode(path):
+    names = {PATCH_DUMP: "patch dump", PATTERN_DUMP: "pattern dump",
+             PATCH_REQUEST: "patch request", PATTERN_REQUEST: "pattern request", ACK: "ack"}
+    for cmd, first, count, data in split_messages(open(path, "rb").read()):
+        name = names.get(cmd, f"command {cmd:02X}")
+        if cmd == ACK:
+            print(f"{name}: {count} stored for {names.get(first, first)}")
+        else:
+            print(f"{name}: first {first:02X}, count {count}, {len(data)} data bytes")
+
+
+def loopback(port, rpsx):
+    rng = random.Random(6502)
+    patches = bytes(rng.randrange(256) for _ in range(16 * PATCH_SIZE))
+    patterns = bytes(rng.randrange(256) for _ in range(2 * PATTERN_SIZE))
+    requests = message(PATCH_REQUEST, 0x40, 16) + message(PATTERN_REQUEST, 3, 2)
+
+    # Neither of these may change a patch: one is cut off by the next
+    # message's F0, the other has its checksum off by one
+    junk = bytes(rng.randrange(256) for _ in range(PATCH_MAX * PATCH_SIZE))
+    cut = message(PATCH_DUMP, 0x40, PATCH_MAX, junk)[:-10]
+    bad = bytearray(message(PATCH_DUMP, 0x48, PATCH_MAX, junk))
+    bad[-2] ^= 1
+    refused = cut + bytes(bad)
+
+    # A few bytes off pattern 3, small enough for the tracker to take back
+    damaged = bytearray(patterns[:PATTERN_SIZE])
+    for i in range(0, PATTERN_SIZE, 400):
+        damaged[i] ^= 0x55
+    bad_pattern = bytearray(pattern_dump(3, bytes(damaged)))
+    bad_pattern[-2] ^= 1
+    bad_pattern = bytes(bad_pattern)
+
+    if port:
+        port.send(patch_dump(0x40, patches))
+        expect_ack(port, PATCH_DUMP, PATCH_MAX)
+        expect_ack(port, PATCH_DUMP, PATCH_MAX)
+        port.send(refused)
+        expect_ack(port, PATCH_DUMP, 0)
+        expect_ack(port, PATCH_DUMP, 0)
+        port.send(pattern_dump(3, patterns))
+        expect_ack(port, PATTERN_DUMP, 2)
+        port.send(bad_pattern)
+        expect_ack(port, PATTERN_DUMP, 0)
+        port.send(requests)
+        replies = [port.receive(PATCH_DUMP), port.receive(PATTERN_DUMP)]
+    else:
+        with tempfile.TemporaryDirectory() as tmp:
+            in_path = os.path.join(tmp, "in.syx")
+            out_path = os.path.join(tmp, "out.syx")
+            with open(in_path, "wb") as f:
+                f.write(patch_dump(0x40, patches) + refused + pattern_dump(3, patterns) +
+                        bad_pattern + requests)
+            subprocess.run([rpsx, in_path, out_path], check=True)
+            replies = list(split_messages(open(out_path, "rb").read()))
+        expected = ([(ACK, PATCH_DUMP, PATCH_MAX)] * 2 + [(ACK, PATCH_DUMP, 0)] * 2 +
+                    [(ACK, PATTERN_DUMP, 2), (ACK, PATTERN_DUMP, 0)])
+        if [m[:3] for m in replies[:6]] != expected:
+            sys.exit(f"Error: bad ACKs {[m[:3] for m in replies[:6]]}")
+        replies = replies[6:]
+
+    if [m[:3] for m in replies] != [(PATCH_DUMP, 0x40, 16), (PATTERN_DUMP, 3, 2)]:
+        sys.exit(f"Error: unexpected replies {[m[:3] for m in replies]}")
+    if replies[0][3] != patches or replies[1][3] != patterns:
+        sys.exit("Error: data read back does not match")
+    print("Loopback OK: 16 patches and 2 patterns round-tripped, 3 bad dumps refused")
+
+
+def main(argv):
+    port = None
+    rpsx = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "build-host", "rpsx")
+    while argv and argv[0].startswith("-"):
+        opt = argv.pop(0)
+        if opt == "-p" and argv:
+            port = RawPort(argv.pop(0))
+        elif opt == "-o" and argv:
+            port = FilePort(argv.pop(0))
+        elif opt == "-x" and argv:
+            rpsx = argv.pop(0)
+        else:
+            sys.exit(__doc__)
+    if not argv:
+        sys.exit(__doc__)
+
+    cmd, args = argv[0], argv[1:]
+    if cmd == "decode" and len(args) == 1:
+        decode(args[0])
+    elif cmd == "loopback" and not args:
+        loopback(port if isinstance(port, RawPort) else None, rpsx)
+    elif port is None:
+        sys.exit("Error: give a MIDI port (-p) or an output file (-o)")
+    elif cmd == "send-patches" and len(args) in (1, 2):
+        first = int(args[1], 0) if len(args) > 1 else 0
+        send_items(port, PATCH_DUMP, first, read_bank(args[0])[:(256 - first) * PATCH_SIZE],
+                   PATCH_SIZE, "patches")
+    elif cmd == "send-patterns" and len(args) in (1, 2):
+        first = int(args[1], 0) if len(args) > 1 else 0
+        send_items(port, PATTERN_DUMP, first, read_patterns(args[0])[:(256 - first) * PATTERN_SIZE],
+                   PATTERN_SIZE, "patterns")
+    elif cmd == "get-patches" and len(args) == 3:
+        get_items(port, PATCH_REQUEST, PATCH_DUMP, int(args[0], 0), int(args[1], 0), args[2], "patches")
+    elif cmd == "get-patterns" and len(args) == 3:
+        get_items(port, PATTERN_REQUEST, PATTERN_DUMP, int(args[0], 0), int(args[1], 0), args[2], "patterns")
+    else:
+        sys.exit(__doc__)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])